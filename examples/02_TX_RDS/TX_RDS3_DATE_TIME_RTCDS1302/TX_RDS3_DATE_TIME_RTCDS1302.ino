@@ -1,4 +1,5 @@
 #include <QN8066.h>
+#include <QN8066RdsEncoder.h>
 
 #include <Ds1302.h>
 
@@ -10,17 +11,35 @@
 char ps[] = "QN8066TX";
 char rt[] = "PU2CLR QN8066 ARDUINO LIBRARY";
 QN8066 tx;
+QN8066RdsEncoder rds;     // Clock Time service (the blocking PS and RT functions are still used)
 
 
 Ds1302 rtc(RESET_PIN, CLK_PIN, DATA_PIN);
 Ds1302::DateTime dt;
 
+// Time source of the RDS Clock Time service. The RTC must be set to UTC.
+// The offset is the local time offset in half hours (for example: -6 = UTC-3:00).
+bool getUtc(qn8066_date_time *utc) {
+  rtc.getDateTime(&dt);
+  if (dt.dow == 0) return false;  // RTC not set
+  utc->year = dt.year + 2000;
+  utc->month = dt.month;
+  utc->day = dt.day;
+  utc->hour = dt.hour;
+  utc->minute = dt.minute;
+  utc->second = dt.second;
+  utc->offset = -6;
+  return true;
+}
+
 void setup() {
  rtc.init(); 
  tx.setup(1000,false,true);
  tx.setTX(1069);   // Sets frequency to 106.9 MHz 
  // tx.rdsEnableRX(true);
  tx.rdsInitTx(0x8,0x1,0x9B, 8, 50, 20);// Sets PI code, sync delay and more   
+ rds.begin(&tx);
+ rds.setTimeSource(getUtc);           // Clock Time (CT) service
 
   // To set the RTC, uncomment this block of lines, compile and upload the sketch to the Arduino. 
   // Once the clock is set, comment out the lines again, compile and upload the sketch.  
@@ -40,13 +59,10 @@ void setup() {
 
 }
 void loop() {
-    rtc.getDateTime(&dt);
     tx.rdsSendPS(ps);
+    // The Clock Time service sends the group 4A at each minute rollover. It needs an integrated clock 
+    // that provides the date and time to the system. This example uses the RTC DS1302 device
+    rds.updateClock();
     tx.rdsSendRTMessage(rt);
-    // To use the function (service) below, you will need to add an integrated clock to your 
-    // system that provides the date and time to the system. This example uses the RTC DS1302 device
-    if (dt.dow)
-      tx.rdsSendDateTime(dt.year + 2000, dt.month, dt.day, dt.hour, dt.minute, 0);
-
-    delay(10000);    
-}
\ No newline at end of file
+    rds.updateClock();
+}
@@ -0,0 +1,70 @@
+/*
+
+QN8066 RDS encoder controlled by UECP (EN 62106).
+
+This sketch receives UECP frames through the Serial port (the same protocol used by playout and
+RDS management software) and transmits the PI, PS, TA/TP, PTY, RT, CT and AF received. The 
+QN8066UECP class handles the byte stuffing, CRC and acknowledgement messages. You can use any 
+Stream (for example, a WiFiClient on ESP32) instead of Serial.
+
+It  is important  to  emphasize that users should be aware of and comply with the  applicable 
+laws and  regulations  in  their location  when using this FM transmitter. The  following 
+table  illustrates  the  connections between  the  KIT  and the Arduino Uno, Nano, or Pro Mini boards.
+
+| Anduino Nano or Uno pin | Kit 5W-7W FM  |
+| ----------------------- | ------------- | 
+|          GND            |     GND       | 
+|           D9            |     PWM       | 
+|           A4            |     SDA       | 
+|           A5            |     SCL       | 
+
+Attention: The Serial port is used by the UECP protocol. Do not print messages on it.
+
+Author: Ricardo Lima Caratti (PU2CLR) - 2024
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+#include <QN8066UECP.h>
+
+#define PWM_PIN 9       // Arduino PIN used to control the output power of the transmitter via PWM.
+#define FREQUENCY 1069  // 106.9 MHz - This library does not use floating-point data. 
+
+QN8066 tx;
+QN8066RdsEncoder rds;
+QN8066UECP uecp;
+
+void setup() {
+
+  pinMode(PWM_PIN, OUTPUT);  // Sets the Arduino PIN to operate with with PWM
+
+  Serial.begin(9600);
+  delay(1000);  // Wait a bit while the system stabilizes.
+
+  if (!tx.detectDevice()) {
+    while (1)
+      ;
+  }
+
+  // Sets some internal parameters
+  tx.setup(1000 /* Crystal Divider */,
+           false /* Mono = False => Stereo */,
+           true /* RDS ON */,
+           1 /*PreEmphasis = 75*/);
+  tx.setTX(FREQUENCY);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+  tx.rdsSetStationName((char *) "QN8066  ");
+  rds.begin(&tx);
+  rds.setRTMessage("UECP CONTROLLED QN8066");
+
+  uecp.begin(&tx, &rds, &Serial);
+
+  analogWrite(PWM_PIN, 50);  // It is about 1/5 of the max power. It is between 1 and 1,4 W
+}
+
+void loop() {
+  uecp.process();                  // Applies the UECP messages received
+  rds.sendPS();                    // Station name (0A/0B with the AF list and TA/TP received)
+  uecp.process();
+  rds.sendRTMessage();             // Current Radio Text (2A)
+}
@@ -0,0 +1,79 @@
+/*
+
+Dynamic PS with the non-blocking RDS encoder (QN8066RdsEncoder).
+
+Many receivers only show the PS (8 characters). This sketch splits the song title into pages of 
+8 characters (words are not split) and shows the station name between two message cycles. The 
+Radio Text is sent in the same schedule. Since rds.process() does not wait for the QN8066, the loop 
+is free to do other things (buttons, display etc). Do not use delay in the loop.
+
+| Anduino Nano or Uno pin | Kit 5W-7W FM  |
+| ----------------------- | ------------- | 
+|          GND            |     GND       | 
+|           D9            |     PWM       | 
+|           A4            |     SDA       | 
+|           A5            |     SCL       | 
+
+Author: Ricardo Lima Caratti (PU2CLR) - 2024
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+
+#define PWM_PIN 9       // Arduino PIN used to control the output power of the transmitter via PWM.
+#define FREQUENCY 1069  // 106.9 MHz - This library does not use floating-point data. 
+
+QN8066 tx;
+QN8066RdsEncoder rds;
+
+// Song titles
+const char *songs[] = { "HEY JUDE - THE BEATLES",
+                        "BOHEMIAN RHAPSODY - QUEEN",
+                        "IMAGINE - JOHN LENNON" };
+
+uint8_t idxSong = 0;
+long songTime = millis();
+
+void setup() {
+
+  pinMode(PWM_PIN, OUTPUT);  // Sets the Arduino PIN to operate with with PWM
+
+  Serial.begin(9600);
+  delay(1000);  // Wait a bit while the system stabilizes.
+
+  if (!tx.detectDevice()) {
+    Serial.println("\nQN8066 not detected");
+    while (1)
+      ;
+  }
+
+  // Sets some internal parameters
+  tx.setup(1000 /* Crystal Divider */,
+           false /* Mono = False => Stereo */,
+           true /* RDS ON */,
+           1 /*PreEmphasis = 75*/);
+  tx.setTX(FREQUENCY);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+
+  tx.rdsSetStationName((char *) "PU2CLR  ");
+  rds.begin(&tx);
+  rds.setRTMessage(songs[idxSong]);
+  rds.setDynamicPS(songs[idxSong], RDS_DPS_PAGING, 2500);  // Each page stays on air for 2.5s
+  rds.setDynamicPSStaticTime(5000);                         // Station name for 5s after each message cycle
+
+  analogWrite(PWM_PIN, 50);  // It is about 1/5 of the max power. It is between 1 and 1,4 W
+}
+
+void loop() {
+
+  rds.process();
+
+  // Next song each 3 minutes
+  if ((millis() - songTime) > 180000L) {
+    if (++idxSong >= (sizeof(songs) / sizeof(songs[0]))) idxSong = 0;
+    rds.setRTMessage(songs[idxSong]);
+    rds.setDynamicPS(songs[idxSong]);
+    Serial.println(songs[idxSong]);
+    songTime = millis();
+  }
+}
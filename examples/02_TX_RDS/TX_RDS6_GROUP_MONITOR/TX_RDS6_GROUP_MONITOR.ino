@@ -0,0 +1,81 @@
+/*
+
+RDS group monitor with the bit level reference coder (QN8066RDSCoder).
+
+The QN8066 adds the checkwords itself, so the host never sees the real RDS bitstream. This sketch 
+rebuilds each group sent (104 bits: blocks, CRC-10 and offset words), checks it with the decoder and 
+prints the bits as ASCII '0' and '1' on the Serial Monitor. Save the serial output to a file and 
+check it with an RDS decoder that accepts ASCII bits. Example: redsea --input bits < rds_bits.txt
+Set PRINT_BITS to 0 to print only the groups in hexadecimal.
+
+| Anduino Nano or Uno pin | Kit 5W-7W FM  |
+| ----------------------- | ------------- | 
+|          GND            |     GND       | 
+|           D9            |     PWM       | 
+|           A4            |     SDA       | 
+|           A5            |     SCL       | 
+
+Author: Ricardo Lima Caratti (PU2CLR) - 2024
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+#include <QN8066RDSCoder.h>
+
+#define PWM_PIN 9       // Arduino PIN used to control the output power of the transmitter via PWM.
+#define FREQUENCY 1069  // 106.9 MHz - This library does not use floating-point data. 
+#define PRINT_BITS 1    // 1 = ASCII bitstream; 0 = one group per line (hexadecimal)
+
+QN8066 tx;
+QN8066RdsEncoder rds;
+
+void monitor(uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+  uint8_t bits[RDS_GROUP_BYTES];
+  uint16_t blocks[4];
+  uint8_t valid;
+
+  QN8066RDSCoder::encodeGroup(a, b, c, d, bits);
+  valid = QN8066RDSCoder::decodeGroup(bits, blocks);  // 0B1111 = the four blocks are valid
+
+#if PRINT_BITS
+  (void) valid;
+  for (uint8_t i = 0; i < RDS_GROUP_BITS; i++) 
+    Serial.write('0' + QN8066RDSCoder::getBit(bits, i));
+#else
+  char line[32];
+  sprintf(line, "%04X %04X %04X %04X %s", a, b, c, d, (valid == 0B1111) ? "OK" : "ERROR");
+  Serial.println(line);
+#endif
+}
+
+void setup() {
+
+  pinMode(PWM_PIN, OUTPUT);  // Sets the Arduino PIN to operate with with PWM
+
+  Serial.begin(115200);
+  delay(1000);  // Wait a bit while the system stabilizes.
+
+  if (!tx.detectDevice()) {
+    Serial.println("\nQN8066 not detected");
+    while (1)
+      ;
+  }
+
+  tx.setup(1000 /* Crystal Divider */,
+           false /* Mono = False => Stereo */,
+           true /* RDS ON */,
+           1 /*PreEmphasis = 75*/);
+  tx.setTX(FREQUENCY);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+
+  tx.rdsSetStationName((char *) "PU2CLR  ");
+  rds.begin(&tx);
+  rds.setRTMessage("QN8066 RDS GROUP MONITOR");
+  tx.rdsSetGroupMonitor(monitor);
+
+  analogWrite(PWM_PIN, 50);  // It is about 1/5 of the max power. It is between 1 and 1,4 W
+}
+
+void loop() {
+  rds.process();
+}
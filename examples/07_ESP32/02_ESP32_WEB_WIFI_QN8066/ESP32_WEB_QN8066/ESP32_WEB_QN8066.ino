@@ -75,8 +75,9 @@ uint16_t previousFrequency = 1069; // 106.9 MHz
 
 uint8_t currentPower = 0;
 
-char ps[9] = "PU2CLR \r";
-char rt[33] = "QN8066 WEB Server control      \r";
+// The texts from the web form are UTF-8 (up to 3 bytes per character). The library converts them to the RDS character set.
+char ps[8 * 3 + 2] = "PU2CLR \r";
+char rt[32 * 3 + 2] = "QN8066 WEB Server control      \r";
 
 
 // Wi-Fi setup
@@ -94,7 +95,7 @@ WebServer server(80);
 QN8066 tx;
 
 void handleRoot() {
-  String htmlPage = "<html><head>";
+  String htmlPage = "<html><head><meta charset='UTF-8'>";
  
   // Adicionando estilo CSS para centralizar o formulário e ajustar a tabela
   
@@ -308,14 +309,14 @@ void handleUpdate() {
     Serial.println("RDS PTY updated to: " + String(rds_pty));
   } else if (field == "rds_ps") {
     String rds_ps = server.arg("rds_ps");
-    nLen = rds_ps.length();
+    nLen = min((int) rds_ps.length(), (int) sizeof(ps) - 2);
     strncpy(ps, rds_ps.c_str(), nLen);
     ps[nLen] = '\r';
     ps[nLen+1] = '\0';
     Serial.println("RDS PS updated to: " + String(ps));
   } else if (field == "rds_rt") {
     String rds_rt = server.arg("rds_rt");
-    nLen = rds_rt.length();
+    nLen = min((int) rds_rt.length(), (int) sizeof(rt) - 2);
     strncpy(rt, rds_rt.c_str(), nLen);
     rt[nLen] = '\r';
     rt[nLen+1] = '\0';
@@ -387,12 +388,12 @@ void handleFormSubmit() {
 
   int nLen;
 
-  nLen = rds_ps.length();
+  nLen = min((int) rds_ps.length(), (int) sizeof(ps) - 2);
   strncpy(ps, rds_ps.c_str(), nLen);
   ps[nLen] = '\r';
   ps[nLen+1] = '\0';
 
-  nLen = rds_rt.length();
+  nLen = min((int) rds_rt.length(), (int) sizeof(rt) - 2);
   strncpy(rt, rds_rt.c_str(), nLen);
   rt[nLen] = '\r';
   rt[nLen+1] = '\0';
@@ -0,0 +1,104 @@
+/*
+  Hardware seek and band scan (QN8066 channel scan - CCA).
+
+  The sketch scans the band twice and shows the time spent by each method:
+  1) Software: tunes each channel (setRxFrequencyUp) and measures the RSSI (getRxRSSI);
+  2) Hardware: scanRxBand - the QN8066 scans the channels itself and stops only on valid channels.
+
+  Then, use the Serial Monitor commands:
+  U - seek up; D - seek down; S - scans the band again.
+
+  Author: Ricardo Lima Caratti (PU2CLR) - 2024.
+*/
+
+#include <QN8066.h>
+
+#define RSSI_THRESHOLD 80   // Software scan: minimum RSSI of a station (dBuV = RSSI - 49)
+#define SOFTWARE_SETTLE 20  // Software scan: time in ms after tuning a channel
+#define MAX_STATIONS 30
+
+QN8066 rx;
+qn8066_station stations[MAX_STATIONS];
+
+void setup() {
+  Serial.begin(9600);
+  rx.begin();
+  rx.setRX(881);
+  rx.setRxFrequencyRange(880, 1080);
+  rx.setRxFrequencyStep(1);  // 100 kHz
+
+  softwareScan();
+  hardwareScan();
+  Serial.println("\nCommands: U = seek up; D = seek down; S = scan");
+}
+
+void softwareScan() {
+  uint8_t count = 0;
+  uint32_t start = millis();
+
+  Serial.println("\nSoftware scan (setRxFrequencyUp and getRxRSSI)");
+  rx.setRxFrequency(880);
+  do {
+    delay(SOFTWARE_SETTLE);
+    if (rx.getRxRSSI() >= RSSI_THRESHOLD) {
+      Serial.print(rx.getRxCurrentFrequency() / 10.0, 1);
+      Serial.print(" ");
+      count++;
+    }
+    rx.setRxFrequencyUp();
+  } while (rx.getRxCurrentFrequency() != 880);
+  Serial.print("\nStations: ");
+  Serial.print(count);
+  Serial.print(" - Time (ms): ");
+  Serial.println(millis() - start);
+}
+
+void hardwareScan() {
+  uint32_t start = millis();
+  uint8_t count = rx.scanRxBand(stations, MAX_STATIONS);
+  uint32_t elapsed = millis() - start;
+
+  Serial.println("\nHardware scan (scanRxBand)");
+  for (uint8_t i = 0; i < count; i++) {
+    Serial.print(stations[i].frequency / 10.0, 1);
+    Serial.print(" MHz - RSSI: ");
+    Serial.print(stations[i].rssi);
+    Serial.print(" - SNR: ");
+    Serial.print(stations[i].snr);
+    Serial.println((stations[i].stereo) ? " - Stereo" : " - Mono");
+  }
+  Serial.print("Stations: ");
+  Serial.print(count);
+  Serial.print(" - Time (ms): ");
+  Serial.println(elapsed);
+}
+
+void showFrequency(uint16_t frequency) {
+  if (frequency == 0) {
+    Serial.println("No station found");
+    return;
+  }
+  Serial.print(frequency / 10.0, 1);
+  Serial.println(" MHz");
+}
+
+void loop() {
+  if (Serial.available() > 0) {
+    char key = Serial.read();
+    switch (key) {
+      case 'U':
+      case 'u':
+        showFrequency(rx.seekRxStationUp());
+        break;
+      case 'D':
+      case 'd':
+        showFrequency(rx.seekRxStationDown());
+        break;
+      case 'S':
+      case 's':
+        hardwareScan();
+        break;
+    }
+  }
+  delay(5);
+}
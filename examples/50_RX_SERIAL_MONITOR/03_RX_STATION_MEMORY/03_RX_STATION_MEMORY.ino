@@ -0,0 +1,122 @@
+/*
+  Station memory (QN8066StationMemory) stored in the EEPROM.
+
+  The sketch scans the band (scanRxBand), stores the stations found and then listens to each one
+  for a few seconds to store its PI and PS (RDS). Only the stations that changed are written, and each
+  station rotates between two EEPROM slots (wear leveling). Restart the board to see the stations loaded.
+
+  Serial Monitor commands:
+  L - lists the stations; S - scans the band again; P - finds the stations with the same PI of the current one.
+
+  Author: Ricardo Lima Caratti (PU2CLR) - 2024.
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066StationMemory.h>
+#include <EEPROM.h>
+
+#define MEMORY_ADDRESS 16   // The first 16 bytes are left to the application
+#define MEMORY_STATIONS 20
+#define MEMORY_COPIES 2     // 20 x 2 x 16 = 640 bytes
+#define RDS_TIME 5000       // Time listening to each station (ms)
+
+QN8066 rx;
+QN8066RdsDecoder rds;
+QN8066StationMemory memory;
+qn8066_station stations[MEMORY_STATIONS];
+
+void eepromRead(uint16_t address, uint8_t *data, uint8_t size) {
+  for (uint8_t i = 0; i < size; i++) data[i] = EEPROM.read(address + i);
+}
+
+void eepromWrite(uint16_t address, const uint8_t *data, uint8_t size) {
+  for (uint8_t i = 0; i < size; i++) EEPROM.update(address + i, data[i]);
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.commit();
+#endif
+}
+
+void setup() {
+  Serial.begin(9600);
+#if defined(ESP32) || defined(ESP8266)
+  EEPROM.begin(MEMORY_ADDRESS + QN8066StationMemory::storageSize(MEMORY_STATIONS, MEMORY_COPIES));
+#endif
+  rx.begin();
+  rx.setRX(881);
+  rx.setRxFrequencyRange(880, 1080);
+  rx.rdsRxEnable(true);
+  rds.begin(&rx);
+
+  Serial.print("\nStations loaded: ");
+  Serial.println(memory.begin(eepromRead, eepromWrite, MEMORY_ADDRESS, MEMORY_STATIONS, MEMORY_COPIES));
+  if (memory.getCount() == 0) scan();
+  list();
+  Serial.println("\nCommands: L = list; S = scan; P = same PI");
+}
+
+void scan() {
+  uint8_t count = rx.scanRxBand(stations, MEMORY_STATIONS);
+
+  Serial.print("\nStations found: ");
+  Serial.print(count);
+  Serial.print(" - Records written: ");
+  Serial.println(memory.updateFromScan(stations, count));
+
+  // Listens to each station to get PI and PS
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t start = millis();
+    rx.setRxFrequency(stations[i].frequency);
+    while (millis() - start < RDS_TIME) {
+      if (rds.process()) memory.updateFromRDS(&rds);
+      delay(5);
+    }
+  }
+}
+
+void list() {
+  char line[40];
+  for (uint8_t i = 0; i < memory.getCount(); i++) {
+    const qn8066_station_info *station = memory.get(i);
+    sprintf(line, "%4u.%u MHz  PI %04X  %-8s  RSSI %3u", station->frequency / 10, station->frequency % 10, station->pi, station->ps, station->rssi);
+    Serial.println(line);
+  }
+  Serial.print("Records written since reset: ");
+  Serial.println(memory.getWrites());
+}
+
+void samePI() {
+  int8_t idx = memory.find(rx.getRxCurrentFrequency());
+  if (idx < 0 || memory.get(idx)->pi == 0) {
+    Serial.println("Current station without PI");
+    return;
+  }
+  uint16_t pi = memory.get(idx)->pi;
+  for (uint8_t n = 0; (idx = memory.findPI(pi, n)) >= 0; n++) {
+    Serial.print(memory.get(idx)->frequency / 10.0, 1);
+    Serial.println(" MHz");
+  }
+}
+
+void loop() {
+  if (rds.process()) memory.updateFromRDS(&rds);
+
+  if (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case 'L':
+      case 'l':
+        list();
+        break;
+      case 'S':
+      case 's':
+        scan();
+        list();
+        break;
+      case 'P':
+      case 'p':
+        samePI();
+        break;
+    }
+  }
+  delay(5);
+}
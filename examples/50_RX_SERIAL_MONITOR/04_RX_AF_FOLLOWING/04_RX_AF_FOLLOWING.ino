@@ -0,0 +1,95 @@
+/*
+  Alternative Frequency (AF) following (QN8066AFFollower).
+
+  The AF list of the station (RDS group 0A) is learned while it is received. When the RSSI drops below
+  PROBE_RSSI, one AF is measured every 2 seconds with the audio muted for a short time (about 25 ms). If an AF
+  is better by 6 dB, the receiver switches to it and checks the PI. If the PI is not the same, it goes back.
+
+  Serial Monitor commands:
+  + / - : next / previous frequency; A - shows the AF list and the probe statistics.
+
+  Author: Ricardo Lima Caratti (PU2CLR) - 2024.
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066AFFollower.h>
+
+#define PROBE_RSSI 35       // Probes the AFs only below this RSSI
+
+QN8066 rx;
+QN8066RdsDecoder rds;
+QN8066AFFollower af;
+
+void showFrequency() {
+  Serial.print("\nFrequency: ");
+  Serial.print(rx.getRxCurrentFrequency() / 10.0, 1);
+  Serial.println(" MHz");
+}
+
+void showAF() {
+  uint16_t list[QN8066_AF_PER_PI];
+  uint8_t n = af.getAF(rds.getPI(), list, QN8066_AF_PER_PI);
+
+  Serial.print("PI ");
+  Serial.print(rds.getPI(), HEX);
+  Serial.print(" AF:");
+  for (uint8_t i = 0; i < n; i++) {
+    Serial.print(' ');
+    Serial.print(list[i] / 10.0, 1);
+  }
+  Serial.print("\nRSSI ");
+  Serial.print(af.getRSSI());
+  Serial.print(" - probes ");
+  Serial.print(af.getProbes());
+  Serial.print(" (average ");
+  Serial.print(af.getMuteAverage());
+  Serial.print(" us; max ");
+  Serial.print(af.getMuteMax());
+  Serial.print(" us) - switches ");
+  Serial.print(af.getSwitches());
+  Serial.print(" - reverts ");
+  Serial.println(af.getReverts());
+}
+
+void setup() {
+  Serial.begin(9600);
+  rx.begin();
+  rx.setRX(1069);
+  rx.rdsRxEnable(true);
+  rds.begin(&rx);
+  af.begin(&rx, &rds);
+  af.setProbeThreshold(PROBE_RSSI);
+  showFrequency();
+}
+
+void loop() {
+  uint8_t events;
+
+  rds.process();
+  events = af.process();
+  if (events & AF_EVENT_LEARNED) showAF();
+  if (events & AF_EVENT_SWITCHED) {
+    Serial.print("Switched to AF");
+    showFrequency();
+  }
+  if (events & AF_EVENT_REVERTED) Serial.println("AF with another PI. Back to the previous frequency.");
+
+  if (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case '+':
+        rx.setRxFrequencyUp();
+        showFrequency();
+        break;
+      case '-':
+        rx.setRxFrequencyDown();
+        showFrequency();
+        break;
+      case 'A':
+      case 'a':
+        showAF();
+        break;
+    }
+  }
+  delay(5);
+}
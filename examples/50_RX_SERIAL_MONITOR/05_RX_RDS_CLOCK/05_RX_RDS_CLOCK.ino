@@ -0,0 +1,50 @@
+/*
+  Host clock set by the RDS Clock Time (QN8066RdsClock).
+
+  Tune a station that sends the Clock Time (group 4A). The clock is set after two Clock Time groups that agree
+  (about two minutes) and, after ten minutes, the drift of millis() is measured and corrected. The local time
+  is shown every second with the quality of the clock:
+  ---- = not set; HOLD = no Clock Time for more than one hour; SYNC = synchronized; DISC = drift corrected.
+
+  Author: Ricardo Lima Caratti (PU2CLR) - 2024.
+*/
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066RdsClock.h>
+
+QN8066 rx;
+QN8066RdsDecoder rds;
+QN8066RdsClock rdsClock;
+
+const char *quality[] = {"----", "HOLD", "SYNC", "DISC"};
+uint32_t lastShow = 0;
+
+void setup() {
+  Serial.begin(9600);
+  rx.begin();
+  rx.setRX(1069);
+  rx.rdsRxEnable(true);
+  rds.begin(&rx);
+  rdsClock.begin(&rds);
+}
+
+void loop() {
+  qn8066_date_time now;
+  char line[48];
+
+  rds.process();
+  rdsClock.process();
+
+  if (millis() - lastShow >= 1000) {
+    uint8_t q = rdsClock.getRdsTime(&now);
+    lastShow = millis();
+    if (q == RDS_CLOCK_INVALID) {
+      Serial.println("Waiting for the RDS Clock Time...");
+    } else {
+      sprintf(line, "%04u-%02u-%02u %02u:%02u:%02u %s drift %ld ppm", now.year, now.month, now.day, now.hour, now.minute, now.second, quality[q], (long) rdsClock.getDrift());
+      Serial.println(line);
+    }
+  }
+  delay(5);
+}
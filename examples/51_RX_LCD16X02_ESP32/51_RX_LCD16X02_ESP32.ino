@@ -48,6 +48,8 @@
 
 
 #include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066SignalMonitor.h>
 #include <EEPROM.h>
 #include <LiquidCrystal.h>
 
@@ -75,7 +77,7 @@
 #define SWITCH_STEREO 26  // Stereo ON/OFF
 #define SEEK_FUNCTION 27  // Seek function
 
-#define POLLING_TIME 1900
+#define SIGNAL_READS 4          // Signal monitor: maximum I2C reads per second
 
 #define STORE_TIME 10000  // Time of inactivity to make the current receiver status writable (10s / 10000 milliseconds).
 #define PUSH_MIN_DELAY 300
@@ -88,7 +90,6 @@ long storeTime = millis();
 
 uint8_t seekDirection = 1;  // 0 = Down; 1 = Up. This value is set by the last encoder direction.
 
-long pollin_elapsed = millis();
 
 
 // Encoder control variables
@@ -103,6 +104,8 @@ Rotary encoder = Rotary(ENCODER_PIN_A, ENCODER_PIN_B);
 LiquidCrystal lcd(LCD_RS, LCD_E, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
 
 QN8066 rx;
+QN8066RdsDecoder rds;
+QN8066SignalMonitor monitor;
 
 void setup() {
 
@@ -153,6 +156,11 @@ void setup() {
   delay(1000);
   rx.setRxFrequencyStep(2);         // Sets the frequency step to 200 kHz
   rx.setRxFrequencyRange(641,1079); // Sets the FM frequency range from 64,1 MHz to 107.9 MHz
+  rx.rdsRxEnable(true);             // Enables the RDS reception
+  rds.begin(&rx);                   // Starts the RDS decoder (see showRDS)
+  rx.setRxTuneCoalesce(40);         // Fast encoder turns are tuned once, at the final frequency (see rxTuneProcess)
+  monitor.begin(&rx, SIGNAL_READS);
+  monitor.setCallback(signalChanged);  // Redraws RSSI and stereo only when they change
 
   lcd.clear();
 
@@ -231,7 +239,7 @@ void showStatus() {
 */
 void showRSSI() {
   char rssi[12];
-  rx.convertToChar(rx.getRxRSSI(), rssi, 3, 0, '.');
+  rx.convertToChar(monitor.getRSSI(), rssi, 3, 0, '.');
   strcat(rssi, "dB");
   lcd.setCursor(13, 1);
   lcd.print(rssi);
@@ -239,13 +247,23 @@ void showRSSI() {
 
 void showStereoMono() {
   lcd.setCursor(0,1);
-  if (rx.isRxStereo()) {
+  if (monitor.isStereo()) {
     lcd.print("ST");
   } else {
     lcd.print("MO");
   }
 }
 
+/*
+   Called by the signal monitor when RSSI or stereo/mono changed
+*/
+void signalChanged(uint8_t events) {
+  if (events & SIGNAL_EVENT_RSSI)
+    showRSSI();
+  if (events & SIGNAL_EVENT_STEREO)
+    showStereoMono();
+}
+
 /**
    Process seek command.
    The seek direction is based on the last encoder direction rotation.
@@ -258,6 +276,18 @@ void doStereo() {
   
 }
 
+/*
+   Shows the station name (PS) received via RDS on the first line
+*/
+void showRDS() {
+  char ps[9];
+  lcd.setCursor(0, 0);
+  if (rds.getPS(ps) != NULL)
+    lcd.print(ps);
+  else
+    lcd.print("        ");  // No RDS (yet) on this frequency
+}
+
 void loop() {
 
   // Check if the encoder has moved.
@@ -272,15 +302,23 @@ void loop() {
     storeTime = millis();
   }
 
+  // Tunes the receiver when the encoder stops
+  if (rx.rxTuneProcess()) {
+    monitor.reset();  // New frequency: the next sample redraws RSSI and stereo
+    rds.reset();      // New frequency: the PS of the previous station is cleared
+    showRDS();
+  }
+
   if (digitalRead(SWITCH_STEREO) == LOW)
     doStereo();
   else if (digitalRead(SEEK_FUNCTION) == LOW)
     doSeek();
 
-  if ((millis() - pollin_elapsed) > POLLING_TIME) {
-    showStatus();
-    pollin_elapsed = millis();
-  }
+  // A new RDS group arrives every 87.6 ms
+  if (rds.process())
+    showRDS();
+
+  monitor.process();
 
   // Show the current frequency only if it has changed
   if ((currentFrequency = rx.getRxCurrentFrequency()) != previousFrequency) {
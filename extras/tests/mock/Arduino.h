@@ -0,0 +1,44 @@
+// Minimal Arduino API for the host tests (see ../README.md)
+#ifndef _MOCK_ARDUINO_H
+#define _MOCK_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define pgm_read_byte(a) (*(const uint8_t *) (a))
+#define pgm_read_word(a) (*(const uint16_t *) (a))
+#define memcpy_P memcpy
+#define HEX 16
+#define DEC 10
+
+uint32_t millis();      // unsigned long is 32 bits on the Arduino boards
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+class Print {
+public:
+  virtual size_t write(uint8_t) = 0;
+  virtual ~Print() {}
+  size_t print(const char *s) {size_t n = 0; while (*s) n += write(*s++); return n;}
+  size_t println(const char *s = "") {return print(s) + write('\n');}
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() {return -1;}
+  using Print::write;
+};
+
+#endif
@@ -0,0 +1,21 @@
+// I2C bus of the host tests. The QN8066 registers are simulated in qn8066_sim.cpp
+#ifndef _MOCK_WIRE_H
+#define _MOCK_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+  void begin();
+  void setClock(long clock);
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool stop = true);
+  size_t write(uint8_t value);
+  uint8_t requestFrom(int address, int count);
+  int available();
+  int read();
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,166 @@
+// QN8066 simulated on the mocked I2C bus (see README.md)
+//
+// The time is simulated: millis() and micros() only move with delay(), delayMicroseconds() and simAdvance().
+// Transmitter: when RDSRDY (SYSTEM2 bit 1) toggles, the group in TX_RDSD0..7 is fetched at the next RDS group
+// boundary (87.6 ms) and RDS_TXUPD (STATUS3 bit 2) toggles.
+// Receiver: simRxGroup loads RX_RDSD0..7 and toggles RDS_RXUPD (STATUS2 bit 7), as a group received.
+// Band: SNR and RSSISIG come from simSnr and simRssi of the channel in RX_CH (CH_STEP bits 1-0). RXAGCSET (STATUS1) 
+// is set simAgcSettle us after each tuning.
+// Channel scan: setting CHSC with CCA_CH_DIS = 0 (SYSTEM1) scans from CH_START to CH_STOP (down if CH_START > CH_STOP) 
+// in steps of CH_FSTEP, SIM_CCA_STEP us per channel. The scan stops on the first channel with SNR >= SNR_CCA_TH (CCA) 
+// with RXCCA_FAIL = 0, or at CH_STOP with RXCCA_FAIL = 1. Then CHSC is cleared and RX_CH has the channel.
+
+#include <Wire.h>
+#include "qn8066_sim.h"
+
+TwoWire Wire;
+uint8_t simRegs[256];
+std::vector<sim_group> simGroups;
+bool simTxFetch = true;
+uint8_t simRssi[SIM_CHANNELS];
+uint8_t simSnr[SIM_CHANNELS];
+bool simCcaHang = false;
+uint32_t simAgcSettle = 0;
+uint32_t simI2CByteTime = 0;
+uint32_t simTunes = 0;
+int simFailures = 0;
+
+static uint64_t now = 0;               // micros()
+static int reg = -1;                   // Register being accessed
+static bool first = true;              // The next byte written is the register number
+static bool fetchPending = false;
+static uint64_t fetchTime = 0;
+static bool scanning = false;          // Channel scan (CHSC) running
+static uint64_t scanStart = 0;
+static uint64_t agcTime = 0;           // RXAGCSET is set at this time
+
+uint32_t millis() {return now / 1000;}
+uint32_t micros() {return now;}
+void delay(unsigned long ms) {now += ms * 1000;}
+void delayMicroseconds(unsigned int us) {now += us;}
+
+static uint16_t channel() {return simRegs[0x0B] | ((simRegs[0x0E] & 3) << 8);}
+
+static void tune(uint16_t ch) {
+  simRegs[0x0B] = ch & 0xFF;
+  simRegs[0x0E] = (simRegs[0x0E] & 0xFC) | ((ch >> 8) & 3);
+}
+
+static void scan() {
+  int16_t start = simRegs[0x0C] | (((simRegs[0x0E] >> 2) & 3) << 8);
+  int16_t stop = simRegs[0x0D] | (((simRegs[0x0E] >> 4) & 3) << 8);
+  int16_t step = 1 << (simRegs[0x0E] >> 6), ch = start;
+  int8_t direction = (start > stop) ? -1 : 1;
+  uint64_t time = scanStart;
+
+  if ( simCcaHang ) return;
+  while ( (time += SIM_CCA_STEP) <= now ) {
+    bool valid = simSnr[ch] >= (simRegs[0x02] & 0x3F);
+    if ( valid || ch == stop || (ch + direction * step - stop) * direction > 0 ) {
+      tune(ch);
+      simRegs[0x0A] = (simRegs[0x0A] & ~0x08) | (valid ? 0 : 0x08);   // STATUS1: RXCCA_FAIL
+      simRegs[0x00] &= ~0x04;                                         // SYSTEM1: CHSC cleared
+      scanning = false;
+      agcTime = time + simAgcSettle;
+      return;
+    }
+    ch += direction * step;
+  }
+}
+
+static void tick() {
+  if ( scanning ) scan();
+  if ( !scanning ) {
+    uint16_t ch = channel();
+    simRegs[0x03] = simSnr[ch];
+    simRegs[0x04] = simRssi[ch];
+    simRegs[0x0A] = (simRegs[0x0A] & ~0x04) | ((now >= agcTime) ? 0x04 : 0);   // STATUS1: RXAGCSET
+  }
+  if ( fetchPending && now >= fetchTime ) {
+    sim_group group;
+    memcpy(group.data, &simRegs[0x1C], 8);
+    group.time = fetchTime;
+    simGroups.push_back(group);
+    simRegs[0x1A] ^= 0x04;            // STATUS3: RDS_TXUPD
+    fetchPending = false;
+  }
+}
+
+void simReset() {
+  memset(simRegs, 0, sizeof(simRegs));
+  simGroups.clear();
+  simTxFetch = true;
+  fetchPending = false;
+  memset(simRssi, 0, sizeof(simRssi));
+  memset(simSnr, 0, sizeof(simSnr));
+  simCcaHang = false;
+  simAgcSettle = 0;
+  simI2CByteTime = 0;
+  simTunes = 0;
+  scanning = false;
+  agcTime = 0;
+}
+
+void simSetStation(uint16_t frequency, uint8_t rssi, uint8_t snr) {
+  simRssi[(frequency - 600) * 2] = rssi;
+  simSnr[(frequency - 600) * 2] = snr;
+}
+
+void simRxGroup(const uint8_t *data, bool sync) {
+  memcpy(&simRegs[0x0F], data, 8);
+  simRegs[0x17] = (simRegs[0x17] ^ 0x80) & 0x80;   // STATUS2: RDS_RXUPD toggles, no block errors
+  if ( sync ) simRegs[0x17] |= 0x10;                // RDSSYNC
+}
+
+void simAdvance(unsigned long us) {
+  now += us;
+  tick();
+}
+
+int simResult(const char *name) {
+  printf("%s: %s (%d failures)\n", name, (simFailures) ? "FAILED" : "passed", simFailures);
+  return (simFailures) ? 1 : 0;
+}
+
+void TwoWire::begin() {}
+void TwoWire::setClock(long clock) {(void) clock;}
+void TwoWire::beginTransmission(uint8_t address) {(void) address; first = true; now += simI2CByteTime;}
+uint8_t TwoWire::endTransmission(bool stop) {(void) stop; return 0;}
+
+size_t TwoWire::write(uint8_t value) {
+  now += simI2CByteTime;
+  if ( first ) {
+    reg = value;
+    first = false;
+    return 1;
+  }
+  if ( reg == 0x01 && ((value ^ simRegs[0x01]) & 0x02) && simTxFetch ) {   // RDSRDY toggled
+    fetchPending = true;
+    fetchTime = (now / SIM_RDS_PERIOD + 1) * SIM_RDS_PERIOD;
+  }
+  simRegs[reg & 0xFF] = value;
+  if ( reg == 0x0B || reg == 0x0E ) {   // Tuning (RX_CH or its 2 high bits)
+    agcTime = now + simAgcSettle;
+    if ( reg == 0x0B ) simTunes++;
+  }
+  if ( reg == 0x00 ) {
+    if ( (value & 0x05) == 0x04 && !scanning ) {   // CHSC = 1 and CCA_CH_DIS = 0: starts the channel scan
+      scanning = true;
+      scanStart = now;
+    } else if ( !(value & 0x04) ) {
+      scanning = false;
+    }
+  }
+  reg++;
+  return 1;
+}
+
+uint8_t TwoWire::requestFrom(int address, int count) {
+  (void) address;
+  now += simI2CByteTime;
+  tick();
+  return count;
+}
+
+int TwoWire::read() {now += simI2CByteTime; return simRegs[reg++ & 0xFF];}
+int TwoWire::available() {return 1;}
@@ -0,0 +1,37 @@
+// QN8066 simulated on the mocked I2C bus (see README.md)
+#ifndef _QN8066_SIM_H
+#define _QN8066_SIM_H
+
+#include <Arduino.h>
+#include <vector>
+
+#define SIM_RDS_PERIOD 87600      // Time in us of one RDS group (104 bits at 1187.5 bps)
+#define SIM_CHANNELS 1024         // 10 bits channel index: frequency = 60 MHz + channel x 50 kHz
+#define SIM_CCA_STEP 2000         // Time in us of the channel scan (CCA) on each channel (assumed, not in the data sheet)
+
+typedef struct {
+  uint8_t data[8];                // TX_RDSD0 to TX_RDSD7 when the group was fetched
+  uint32_t time;                  // micros() of the fetch
+} sim_group;
+
+extern uint8_t simRegs[256];                   // Registers of the QN8066
+extern std::vector<sim_group> simGroups;       // Groups fetched by the transmitter
+extern bool simTxFetch;                        // false = the transmitter does not fetch the groups (RDS not sent)
+extern uint8_t simRssi[SIM_CHANNELS];          // RSSI of each channel (RSSISIG when the receiver is on it)
+extern uint8_t simSnr[SIM_CHANNELS];           // SNR of each channel (the CCA stops when SNR >= SNR_CCA_TH)
+extern bool simCcaHang;                        // true = the channel scan never ends (CHSC stays set)
+extern uint32_t simAgcSettle;                  // Time in us after tuning until RXAGCSET (STATUS1) is set (default 0)
+extern uint32_t simI2CByteTime;                // Time in us of each byte on the I2C bus (default 0; 90 = 100 kHz)
+extern uint32_t simTunes;                      // Channels tuned (writes of RX_CH)
+
+void simReset();
+void simRxGroup(const uint8_t *data, bool sync = true);
+void simAdvance(unsigned long us);
+void simSetStation(uint16_t frequency, uint8_t rssi, uint8_t snr);   // frequency in MHz x 10
+
+/* Minimal test check: prints the failure and counts it */
+extern int simFailures;
+#define CHECK(cond) do { if ( !(cond) ) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); simFailures++; } } while (0)
+int simResult(const char *name);
+
+#endif
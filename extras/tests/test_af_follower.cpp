@@ -0,0 +1,150 @@
+// RX AF following (QN8066AFFollower): switch, revert, penalty and the mute time of the probes. See README.md
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066AFFollower.h>
+#include "qn8066_sim.h"
+
+#define HOME 1000                 // Frequency listened at the start (PI 0xC201)
+
+static QN8066 rx;
+static QN8066RdsDecoder rds;
+static QN8066AFFollower af;
+static uint16_t piTable[SIM_CHANNELS];   // PI sent on each channel (0 = no RDS)
+static uint32_t nextGroup = 0;
+static uint8_t segment = 0;
+
+static void station(uint16_t frequency, uint8_t rssi, uint8_t snr, uint16_t pi) {
+  simSetStation(frequency, rssi, snr);
+  piTable[(frequency - 600) * 2] = pi;
+}
+
+// 0A groups of the station on the current frequency. The network 0xC201 lists 1045, 1070 and 962 (method A).
+static void sendGroup() {
+  static const uint16_t afPairs[4] = {(227 << 8) | 170, (195 << 8) | 87, (205 << 8) | 205, (205 << 8) | 205};
+  uint16_t pi = piTable[(rx.getRxCurrentFrequency() - 600) * 2];
+  uint16_t block[4] = {pi, segment, (pi == 0xC201) ? afPairs[segment] : (uint16_t) ((205 << 8) | 205), 0x2020};
+  uint8_t data[8];
+
+  if ( pi == 0 ) return;
+  for (uint8_t i = 0; i < 4; i++) {
+    data[i * 2] = block[i] >> 8;
+    data[i * 2 + 1] = block[i] & 0xFF;
+  }
+  simRxGroup(data);
+  segment = (segment + 1) & 3;
+}
+
+// Application loop for up to ms milliseconds (or until one of the events in stop). Returns the events.
+static uint8_t run(uint32_t ms, uint8_t stop = 0) {
+  uint32_t t0 = millis();
+  uint8_t events = 0, e;
+
+  while ( millis() - t0 < ms ) {
+    if ( (int32_t) (millis() - nextGroup) >= 0 ) {
+      sendGroup();
+      nextGroup += SIM_RDS_PERIOD / 1000;
+    }
+    rds.process();
+    events |= (e = af.process());
+    if ( e & stop ) break;
+    delay(10);
+  }
+  return events;
+}
+
+static bool hasAF(uint16_t pi, uint16_t frequency) {
+  uint16_t list[QN8066_AF_PER_PI];
+  uint8_t n = af.getAF(pi, list, QN8066_AF_PER_PI);
+  for (uint8_t i = 0; i < n; i++)
+    if ( list[i] == frequency ) return true;
+  return false;
+}
+
+int main() {
+  uint16_t probes;
+  uint32_t t0;
+  uint8_t events;
+
+  simReset();
+  rx.setup();
+  rx.setRX(HOME);
+  rx.rdsRxEnable(true);
+  rds.begin(&rx);
+  nextGroup = millis();
+
+  // 1045: stronger, but SNR below the current one; 1070: 5 dB above (margin 6); 962: strong, but another network
+  station(HOME, 20, 10, 0xC201);
+  station(1045, 40, 5, 0xC201);
+  station(1070, 25, 30, 0xC201);
+  station(962, 50, 25, 0x5000);
+  af.begin(&rx, &rds);
+
+  // The AF list of the group 0A is learned
+  CHECK(run(1000, AF_EVENT_LEARNED) & AF_EVENT_LEARNED);
+  run(1000);
+  CHECK(hasAF(0xC201, 1045) && hasAF(0xC201, 1070) && hasAF(0xC201, 962) && !hasAF(0xC201, HOME));
+  CHECK(af.getRSSI() == 20 && af.getSNR() == 10 && af.getProbes() == 0);
+
+  // One probe every 2 s in round robin: 1045 and 1070 are not good enough; 962 is used, but its PI is not the same
+  events = run(10000, AF_EVENT_REVERTED);
+  CHECK((events & AF_EVENT_REVERTED) && !(events & AF_EVENT_SWITCHED) && af.getProbes() == 3);
+  CHECK(af.getReverts() == 1 && af.getSwitches() == 0 && rx.getRxCurrentFrequency() == HOME && !af.isVerifying());
+
+  // 962 has a penalty: it is skipped QN8066_AF_PENALTY times (one skip each round of the other two AFs) and then
+  // probed again in the probe 2 x QN8066_AF_PENALTY + 3 after the revert
+  probes = af.getProbes();
+  run(2UL * 2000 * (2 * QN8066_AF_PENALTY + 4), AF_EVENT_REVERTED);
+  CHECK(af.getReverts() == 2 && af.getProbes() - probes == 2 * QN8066_AF_PENALTY + 3 && rx.getRxCurrentFrequency() == HOME);
+
+  // 1045 gets a good signal: the receiver switches to it and the PI is verified. HOME is an AF of the new frequency.
+  station(1045, 40, 20, 0xC201);
+  events = run(10000, AF_EVENT_SWITCHED);
+  CHECK((events & AF_EVENT_SWITCHED) && af.getSwitches() == 1 && rx.getRxCurrentFrequency() == 1045 && !af.isVerifying());
+  CHECK(hasAF(0xC201, HOME));
+  run(1000);
+  CHECK(af.getRSSI() == 40 && af.getSNR() == 20);
+
+  // An AF without RDS: the receiver goes back after the verify timeout
+  station(1070, 60, 30, 0);
+  for (uint8_t i = 0; i < 10 && !af.isVerifying(); i++) run(2000, AF_EVENT_PROBED);
+  CHECK(rx.getRxCurrentFrequency() == 1070);
+  t0 = millis();
+  CHECK(run(2000, AF_EVENT_REVERTED) & AF_EVENT_REVERTED);
+  CHECK(millis() - t0 >= 1000 && millis() - t0 <= 1020 && rx.getRxCurrentFrequency() == 1045 && af.getReverts() == 3);
+
+  // Probe threshold: no probe while the RSSI is not below it
+  af.setProbeThreshold(40);
+  probes = af.getProbes();
+  run(10000);
+  CHECK(af.getProbes() == probes);
+  af.setProbeThreshold(41);
+  run(1000);   // The probe interval is over: one probe at once
+  CHECK(af.getProbes() == probes + 1);
+  af.setProbeThreshold(0xFF);
+
+  // Mute time of a probe (no switches): the overhead (QN8066_AF_PROBE_OVERHEAD) when the AGC settles at once; 
+  // bounded by maxMute when it does not settle
+  station(1070, 25, 30, 0xC201);
+  station(962, 25, 30, 0x5000);
+  for (uint8_t maxMute = 15; maxMute <= 45; maxMute += 15) {
+    for (uint8_t settling = 0; settling < 2; settling++) {
+      simAgcSettle = (settling) ? 100000 : 0;
+      af.begin(&rx, &rds, 6, 500, maxMute);
+      run(3000);
+      printf("maxMute %2u ms, AGC %s: %u probes, mute average %5u us, max %5u us\n", maxMute, (settling) ? "not settled" : "settled",
+             af.getProbes(), (unsigned) af.getMuteAverage(), (unsigned) af.getMuteMax());
+      CHECK(af.getProbes() >= 5 && af.getSwitches() == 0 && af.getReverts() == 0);
+      CHECK(af.getMuteMax() <= (uint32_t) maxMute * 1000);
+      if ( settling )
+        CHECK(af.getMuteAverage() >= (uint32_t) (maxMute - 3) * 1000);
+      else
+        CHECK(af.getMuteMax() <= (QN8066_AF_PROBE_OVERHEAD + 1) * 1000);
+    }
+  }
+  // maxMute below the overhead: the AGC wait is QN8066_SURVEY_MIN_SETTLE
+  af.begin(&rx, &rds, 6, 500, 5);
+  run(3000);
+  CHECK(af.getProbes() >= 5 && af.getMuteMax() <= (QN8066_AF_PROBE_OVERHEAD + QN8066_SURVEY_MIN_SETTLE + 1) * 1000);
+
+  return simResult("test_af_follower");
+}
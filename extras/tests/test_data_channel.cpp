@@ -0,0 +1,117 @@
+// RDS data channel (QN8066DataChannel -> QN8066RdsEncoder -> QN8066DataReceiver) with lost groups. See README.md
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+#include <QN8066DataChannel.h>
+#include "qn8066_sim.h"
+
+#define TEST_FILE 600             // Bytes of the file sent
+#define TEST_MAX_GROUPS 20000     // Groups on air before giving up (about 29 minutes)
+
+static QN8066 tx;
+static QN8066RdsEncoder rds;
+static QN8066DataChannel channel;
+static QN8066DataReceiver receiver;
+static uint8_t file[TEST_FILE];
+static uint32_t seed = 1;
+
+static uint32_t lcg() {
+  seed = seed * 1103515245UL + 12345;
+  return (seed >> 16) & 0x7FFF;
+}
+
+typedef struct {
+  const char *name;
+  uint16_t randomLoss;            // Probability of losing a group (per 1000)
+  uint16_t burstEvery;            // One burst of lost groups every burstEvery groups (0 = no bursts)
+  uint8_t burstSize;              // Groups lost in each burst
+  int32_t corrupt;                // Data group (on air) with an undetected error (-1 = none)
+} test_channel;
+
+// Sends the file until the receiver rebuilds it. Returns the number of groups on air (all types) to complete it.
+static uint32_t run(const test_channel *model) {
+  uint32_t air = 0, burstLeft = 0;
+  int32_t dataGroups = 0;
+
+  seed = 1;
+  receiver.begin(8);
+  CHECK(channel.send(file, TEST_FILE, 4, 4));
+  simGroups.clear();
+  while ( !receiver.isComplete() && air < TEST_MAX_GROUPS ) {
+    rds.process();
+    simAdvance(SIM_RDS_PERIOD / 20);
+    for ( ; air < simGroups.size(); air++ ) {
+      uint8_t *d = simGroups[air].data;
+      uint16_t b = ((uint16_t) d[2] << 8) | d[3], c = ((uint16_t) d[4] << 8) | d[5], e = ((uint16_t) d[6] << 8) | d[7];
+      bool data = (b >> 11) == (8 << 1) && !(b & 0x10);
+      if ( model->burstEvery && air % model->burstEvery == (uint32_t) model->burstEvery - 1 ) burstLeft = model->burstSize;
+      if ( burstLeft ) {
+        burstLeft--;
+        continue;
+      }
+      if ( lcg() % 1000 < model->randomLoss ) continue;
+      if ( data && dataGroups++ == model->corrupt ) e ^= 0x0100;
+      receiver.feed(b, c, e);
+    }
+  }
+  // getGoodput counts the data channel groups received; the goodput on air also counts the time of the groups lost
+  uint32_t onAir = (uint64_t) TEST_FILE * 8 * 1000000 / ((uint64_t) air * SIM_RDS_PERIOD);
+  printf("%-20s %5u groups on air, %3u data groups received, %2u recovered, goodput %3u bit/s (getGoodput %3u bit/s; %3u bit/s at 11.4 groups/s)\n",
+         model->name, (unsigned) air, (unsigned) receiver.getGroups(), receiver.getRecovered(), (unsigned) onAir,
+         (unsigned) receiver.getGoodput(57), (unsigned) receiver.getGoodput());
+  CHECK(receiver.isComplete());
+  CHECK(receiver.getLength() == TEST_FILE && memcmp(receiver.getData(), file, TEST_FILE) == 0);
+  CHECK(QN8066DataChannel::crc16(receiver.getData(), receiver.getLength()) == QN8066DataChannel::crc16(file, TEST_FILE));
+  return air;
+}
+
+int main() {
+  const test_channel clean = {"no losses", 0, 0, 0, -1};
+  const test_channel random = {"5% random losses", 50, 0, 0, -1};
+  const test_channel burst = {"bursts of 8 groups", 0, 97, 8, -1};
+  const test_channel longBurst = {"bursts of 24 groups", 0, 331, 24, -1};
+  const test_channel mixed = {"bursts + 2% random", 20, 149, 6, -1};
+  const test_channel corrupt = {"undetected error", 0, 0, 0, 10};
+  uint32_t cycle, groups;
+
+  for ( uint16_t i = 0; i < TEST_FILE; i++ ) file[i] = lcg() & 0xFF;
+  printf("RDS budget: 11.4 groups/s x 24 bits = 273 bit/s; data channel with interval 2: 5.7 groups/s\n");
+
+  simReset();
+  tx.setup();
+  tx.setTX(1069);
+  tx.rdsTxEnable(true);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+  tx.rdsSetStationName((char *) "PU2CLR  ");
+  rds.begin(&tx);
+  rds.setRTMessage("QN8066 DATA CHANNEL");
+  CHECK(channel.begin(&rds, 0xCD46, 8, 2));
+
+  // The RT+ group type (11A) is reserved
+  QN8066DataChannel other;
+  CHECK(!other.begin(&rds, 0xCD47, 11, 2));
+
+  // Without losses, the file is complete at the end of the first cycle: 200 fragments + 25% parity + 13 headers + CRC
+  cycle = run(&clean);
+  CHECK(receiver.getGroups() == 200 + 52 + 13 + 1 && receiver.getRecovered() == 0);
+  CHECK(receiver.getGoodput(57) > 100);
+
+  // Random losses: the parity fills most gaps, the next cycles the others
+  groups = run(&random);
+  CHECK(receiver.getRecovered() > 0 && groups < cycle * 3);
+
+  // Bursts up to the interleaving depth (8 groups on air = 4 data groups) are corrected in the same cycle
+  groups = run(&burst);
+  CHECK(receiver.getRecovered() > 0 && groups <= cycle + 10);
+
+  // Longer bursts need the next cycle
+  groups = run(&longBurst);
+  CHECK(groups > cycle && groups < cycle * 3);
+
+  run(&mixed);
+
+  // A fragment with an undetected error fails the CRC check; the file is received again in the next cycle
+  groups = run(&corrupt);
+  CHECK(groups > cycle * 2 - 10);
+
+  return simResult("test_data_channel");
+}
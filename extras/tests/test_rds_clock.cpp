@@ -0,0 +1,157 @@
+// RDS clock (QN8066RdsDecoder + QN8066RdsClock) on synthetic Clock Time (4A) streams. See README.md
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066RdsClock.h>
+#include "qn8066_sim.h"
+
+static QN8066 rx;
+static QN8066RdsDecoder rds;
+static QN8066RdsClock clk;
+
+// UTC minutes since MJD 0
+static int32_t minutesOf(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute) {
+  return QN8066::calculateMJD(year, month, day) * 1440L + hour * 60 + minute;
+}
+
+static int32_t secondsOf(const qn8066_date_time *dt) {
+  return minutesOf(dt->year, dt->month, dt->day, dt->hour, dt->minute) * 60L + dt->second;
+}
+
+// Blocks B, C and D of a 4A group (offset in half hours)
+static void blocks4A(int32_t minutes, int8_t offset, uint16_t *b, uint16_t *c, uint16_t *d) {
+  int32_t mjd = minutes / 1440;
+  uint8_t hour = (minutes % 1440) / 60, minute = minutes % 60;
+  *b = (4 << 12) | ((mjd >> 15) & 3);
+  *c = ((mjd & 0x7FFF) << 1) | (hour >> 4);
+  *d = ((hour & 15) << 12) | (minute << 6) | ((offset < 0) ? 0x20 : 0) | ((offset < 0) ? -offset : offset);
+}
+
+static void sendCT(int32_t minutes, int8_t offset) {
+  uint16_t b, c, d;
+  blocks4A(minutes, offset, &b, &c, &d);
+  rds.decodeGroup(0xC201, b, c, d, 0, millis());
+}
+
+static void load4A(uint8_t *data, int32_t minutes, int8_t offset) {
+  uint16_t block[4] = {0xC201};
+  blocks4A(minutes, offset, &block[1], &block[2], &block[3]);
+  for (int i = 0; i < 4; i++) {
+    data[i * 2] = block[i] >> 8;
+    data[i * 2 + 1] = block[i] & 0xFF;
+  }
+}
+
+// A 4A stream received with millis() 3000 ppm fast and some reception jitter
+static void testStream() {
+  const double fast = 1.003;
+  int32_t start = minutesOf(2024, 12, 31, 23, 50);
+  unsigned long t0 = millis();
+  qn8066_date_time now;
+
+  rds.begin(&rx);
+  clk.begin(&rds);
+  for (int i = 0; i < 15; i++) {
+    delay(t0 + (unsigned long) (i * 60000 * fast) + (i % 3) * 40 - millis());
+    sendCT(start + i, 4);   // UTC+2:00
+    clk.process();
+    if ( i == 0 ) CHECK(clk.getQuality() == RDS_CLOCK_INVALID);           // Not confirmed yet
+    if ( i == 1 ) CHECK(clk.getQuality() == RDS_CLOCK_SYNCED);
+  }
+  CHECK(clk.getQuality() == RDS_CLOCK_DISCIPLINED);
+  CHECK(clk.getDrift() > 2800 && clk.getDrift() < 3200);
+  CHECK(clk.getRdsTime(&now) == RDS_CLOCK_DISCIPLINED);
+  CHECK(now.year == 2025 && now.month == 1 && now.day == 1 && now.hour == 2 && now.minute == 4 && now.offset == 4);
+  CHECK(clk.getRdsTime(&now, false) == RDS_CLOCK_DISCIPLINED && now.hour == 0 && now.minute == 4);
+
+  // A Clock Time one hour ahead is not used
+  delay(30000);
+  sendCT(start + 15 + 60, 4);
+  CHECK(!clk.process());
+  CHECK(clk.getRejected() == 2);
+
+  // Two hours without Clock Time: holdover, the time is kept by millis() corrected by the drift
+  unsigned long last = t0 + (unsigned long) (14 * 60000 * fast);
+  delay((unsigned long) (7200000 * fast) - (millis() - last));
+  CHECK(clk.getRdsTime(&now, false) == RDS_CLOCK_HOLDOVER);
+  int32_t error = secondsOf(&now) - (start + 14 + 120) * 60L;
+  CHECK(error >= -2 && error <= 2);
+
+  // Another station with a clock 5 minutes ahead: used after two Clock Time groups that agree
+  int32_t other = start + 14 + 120 + 5;
+  sendCT(other, 4);
+  CHECK(!clk.process());
+  delay(60000 * fast);
+  sendCT(other + 1, 4);
+  CHECK(clk.process());
+  CHECK(clk.getRdsTime(&now, false) == RDS_CLOCK_DISCIPLINED && now.hour == 2 && now.minute == 10);
+}
+
+// The local time crosses the date backwards (UTC-3:00)
+static void testLocalOffset() {
+  QN8066RdsClock clock;
+  qn8066_date_time ct = {2025, 1, 1, 1, 30, 0, -6}, now;
+  uint32_t ms = millis();
+
+  clock.begin(NULL);
+  clock.feed(&ct, ms - 60000);
+  ct.minute = 31;
+  CHECK(clock.feed(&ct, ms));
+  CHECK(clock.getRdsTime(&now) == RDS_CLOCK_SYNCED);
+  CHECK(now.year == 2024 && now.month == 12 && now.day == 31 && now.hour == 22 && now.minute == 31);
+}
+
+// Polling: the Clock Time reference is millis() when the group is read
+static void testPolling() {
+  uint8_t data[8];
+  unsigned long time;
+
+  simReset();
+  rx.setRX(939);
+  rds.begin(&rx);
+  rds.process();                       // First read: the group in the registers is not used
+  load4A(data, minutesOf(2025, 3, 1, 10, 0), 0);
+  delay(100);
+  simRxGroup(data);
+  CHECK(rds.process());
+  time = millis();
+  CHECK(rds.getStatus() & RDS_RX_CT);
+  CHECK(time - rds.getCTMillis() < 10);   // Only the I2C reading
+}
+
+// Capture: the Clock Time reference is the capture time, not the decoding time
+static void testCapture() {
+  qn8066_rds_rx_group ring[QN8066_RDS_RX_RING];
+  uint8_t data[8];
+  unsigned long received;
+
+  simReset();
+  rx.setRX(939);
+  rds.begin(&rx);
+  rds.setCaptureBuffer(ring, QN8066_RDS_RX_RING);
+  rds.setInterrupt(true);
+  load4A(data, minutesOf(2025, 3, 1, 10, 0), 0);
+  simRxGroup(data);
+  rds.onInterrupt();
+  rds.capture();                       // First read: the group in the registers is not used
+  delay(100);
+  load4A(data, minutesOf(2025, 3, 1, 10, 1), 0);
+  simRxGroup(data);
+  rds.onInterrupt();
+  received = millis();
+  delay(3);
+  CHECK(rds.capture());
+  delay(700);                          // The loop is busy
+  CHECK(rds.decodeQueue() == 1);
+  CHECK(rds.getStatus() & RDS_RX_CT);
+  CHECK(rds.getCTMillis() - received <= 1);
+  rds.setInterrupt(false);
+}
+
+int main() {
+  simReset();
+  testStream();
+  testLocalOffset();
+  testPolling();
+  testCapture();
+  return simResult("test_rds_clock");
+}
@@ -0,0 +1,166 @@
+// RDS bit level reference coder (QN8066RDSCoder) on the groups sent on the mocked I2C bus. See README.md
+// Usage: test_rds_coder [file]. The RDS subcarrier of all groups sent is written to file (default rds_mpx.raw):
+// 16 bits signed samples (host byte order, little endian on a PC) at 171 kHz, for RDS decoders that read raw MPX (redsea).
+#include <QN8066.h>
+#include <QN8066RDSCoder.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066RdsEncoder.h>
+#include "qn8066_sim.h"
+
+typedef struct {
+  uint16_t block[4];
+} test_group;
+
+static std::vector<test_group> monitored;
+
+static void monitor(uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+  test_group group = {{a, b, c, d}};
+  monitored.push_back(group);
+}
+
+// Bit by bit CRC-10 (long division by 0x5B9)
+static uint16_t crcReference(uint16_t data) {
+  uint32_t value = (uint32_t) data << 10;
+  for (int8_t bit = 25; bit >= 10; bit--)
+    if ( (value >> bit) & 1 ) value ^= (uint32_t) 0x5B9 << (bit - 10);
+  return value;
+}
+
+int main(int argc, char **argv) {
+  const char *fileName = (argc > 1) ? argv[1] : "rds_mpx.raw";
+  uint8_t bits[RDS_GROUP_BYTES];
+  uint16_t blocks[4];
+  int16_t samples[RDS_SAMPLES_PER_BIT];
+  std::vector<uint8_t> sent;
+  std::vector<int16_t> mpx;
+  QN8066RDSCoder coder;
+  QN8066RdsDecoder rds;
+  QN8066 tx;
+  int errors;
+
+  // Table driven CRC against the long division, for all information words
+  errors = 0;
+  for (uint32_t data = 0; data < 65536; data++) errors += QN8066RDSCoder::crc(data) != crcReference(data);
+  CHECK(errors == 0);
+
+  // Every single bit error is detected; version B groups use the offset C'
+  QN8066RDSCoder::encodeGroup(0x819B, 0x0408, 0xE0CD, 0x5055, bits);
+  CHECK(QN8066RDSCoder::decodeGroup(bits, blocks) == 0B1111);
+  errors = 0;
+  for (uint8_t i = 0; i < RDS_GROUP_BITS; i++) {
+    bits[i >> 3] ^= 0x80 >> (i & 7);
+    errors += QN8066RDSCoder::decodeGroup(bits, blocks) == 0B1111;
+    bits[i >> 3] ^= 0x80 >> (i & 7);
+  }
+  CHECK(errors == 0);
+  QN8066RDSCoder::encodeGroup(0x819B, 0x0808, 0x819B, 0x5055, bits);
+  CHECK(QN8066RDSCoder::decodeGroup(bits, blocks) == 0B1111);
+  CHECK(QN8066RDSCoder::offsetOf(((uint32_t) 0x819B << 10) | QN8066RDSCoder::checkword(0x819B, RDS_OFFSET_CP)) == RDS_OFFSET_CP);
+
+  // Groups sent by the library, as written on the I2C bus (TX_RDSD0 to TX_RDSD7 fetched by the chip)
+  simReset();
+  tx.setup();
+  tx.setTX(1069);
+  tx.rdsTxEnable(true);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+  tx.rdsSetGroupMonitor(monitor);
+  simGroups.clear();
+  tx.rdsSendPS((char *) "STATIONX");
+  tx.rdsSendRTMessage((char *) "PU2CLR QN8066 ARDUINO LIBRARY");
+  tx.rdsSendDateTime(2024, 7, 1, 12, 30, -6);
+  tx.rdsSendRTMessageB((char *) "SHORT TEXT");
+  CHECK(simGroups.size() > 0 && simGroups.size() == monitored.size());
+
+  rds.begin(&tx);
+  errors = 0;
+  for (size_t g = 0; g < simGroups.size(); g++) {
+    uint16_t block[4];
+    for (uint8_t i = 0; i < 4; i++) block[i] = ((uint16_t) simGroups[g].data[i * 2] << 8) | simGroups[g].data[i * 2 + 1];
+    if ( g < monitored.size() && memcmp(block, monitored[g].block, sizeof(block)) != 0 ) errors++;
+    if ( g > 0 && simGroups[g].time - simGroups[g - 1].time < SIM_RDS_PERIOD ) errors++;   // One group per period
+
+    QN8066RDSCoder::encodeGroup(block[0], block[1], block[2], block[3], bits);
+    if ( QN8066RDSCoder::decodeGroup(bits, blocks) != 0B1111 || memcmp(block, blocks, sizeof(block)) != 0 ) errors++;
+    for (uint8_t i = 0; i < RDS_GROUP_BITS; i++) {
+      uint8_t bit = QN8066RDSCoder::getBit(bits, i);
+      sent.push_back(bit);
+      coder.modulate(bit, samples);
+      mpx.insert(mpx.end(), samples, samples + RDS_SAMPLES_PER_BIT);
+    }
+    rds.decodeGroup(block[0], block[1], block[2], block[3], 0, millis());
+    if ( g == simGroups.size() / 2 ) {
+      char rt[65];
+      CHECK(rds.getRT(rt) != NULL && strcmp(rt, "PU2CLR QN8066 ARDUINO LIBRARY") == 0);
+    }
+  }
+  CHECK(errors == 0);
+
+  // The receiver decoder gets back what was sent
+  char ps[9], rt[65];
+  qn8066_date_time ct;
+  CHECK(rds.getPI() == tx.rdsGetPI());
+  CHECK(rds.getPS(ps) != NULL && strcmp(ps, "STATIONX") == 0);
+  CHECK(rds.getRT(rt) != NULL && strcmp(rt, "SHORT TEXT") == 0);
+  CHECK(rds.getDateTime(&ct) && ct.year == 2024 && ct.month == 7 && ct.day == 1 && ct.hour == 12 && ct.minute == 30 && ct.offset == -6);
+
+  // AF list (0A, method A) with an LF/MF channel: 3 AFs = 87.6 MHz, 250 + LF/MF channel 20 (not 89.5 MHz), 97.5 MHz
+  uint16_t af[4];
+  rds.reset();
+  rds.decodeGroup(0x819B, 0x0000, (227 << 8) | 1, 0x5055, 0, millis());
+  rds.decodeGroup(0x819B, 0x0001, (250 << 8) | 20, 0x4E47, 0, millis());
+  CHECK(!(rds.getStatus() & RDS_RX_AF));
+  rds.decodeGroup(0x819B, 0x0002, (100 << 8) | 205, 0x4C45, 0, millis());
+  CHECK((rds.getStatus() & RDS_RX_AF) && rds.getAF(af, 4) == 2 && af[0] == 876 && af[1] == 975);
+
+  // rdsSendRTMessageB(NULL) sends nothing; QN8066RdsEncoder::setRTMessage(NULL, 1) sends the current text as 2B
+  QN8066RdsEncoder encoder;
+  size_t count = simGroups.size();
+  uint16_t flag2A, flag2B;
+  tx.rdsSendRTMessageB(NULL);
+  CHECK(simGroups.size() == count);
+  encoder.begin(&tx);
+  encoder.setRTMessage("RADIO TEXT SENT AS 2A, THEN AS 2B AND CUT TO 32 CHARACTERS");
+  simGroups.clear();
+  encoder.sendRTMessage();
+  CHECK(simGroups.size() > 0 && (simGroups[0].data[2] >> 3) == 4);
+  flag2A = simGroups[0].data[3] & 0x10;
+  encoder.setRTMessage(NULL, 1);
+  simGroups.clear();
+  encoder.sendRTMessage();
+  CHECK(simGroups.size() == (size_t) 16 * tx.rdsGetRepeatSendGroup());
+  rds.reset();
+  errors = 0;
+  flag2B = simGroups[0].data[3] & 0x10;
+  for (size_t g = 0; g < simGroups.size(); g++) {
+    uint16_t block[4];
+    for (uint8_t i = 0; i < 4; i++) block[i] = ((uint16_t) simGroups[g].data[i * 2] << 8) | simGroups[g].data[i * 2 + 1];
+    errors += (block[1] >> 11) != 5 || (block[1] & 0x10) != flag2B;
+    rds.decodeGroup(block[0], block[1], block[2], block[3], 0, millis());
+  }
+  CHECK(errors == 0 && flag2A != flag2B);
+  CHECK(rds.getRT(rt) != NULL && strcmp(rt, "RADIO TEXT SENT AS 2A, THEN AS 2") == 0);
+
+  // Demodulation of the subcarrier: one biphase symbol per bit, differential decoding
+  errors = 0;
+  uint8_t previous = 0;
+  for (size_t b = 0; b < sent.size(); b++) {
+    long half[2] = {0, 0};
+    for (uint8_t n = 0; n < RDS_SAMPLES_PER_BIT; n++) {
+      int8_t carrier = (n % 3 == 1) ? 1 : (n % 3 == 2) ? -1 : 0;   // 57 kHz at 171 kHz: 0, +, -
+      half[n >= RDS_SAMPLES_PER_BIT / 2] += (long) mpx[b * RDS_SAMPLES_PER_BIT + n] * carrier;
+    }
+    uint8_t level = half[0] > half[1];
+    errors += (level ^ previous) != sent[b];
+    previous = level;
+  }
+  CHECK(errors == 0);
+
+  FILE *file = fopen(fileName, "wb");
+  CHECK(file != NULL);
+  if ( file != NULL ) {
+    fwrite(mpx.data(), sizeof(int16_t), mpx.size(), file);
+    fclose(file);
+    printf("%u groups, %u samples written to %s\n", (unsigned) simGroups.size(), (unsigned) mpx.size(), fileName);
+  }
+  return simResult("test_rds_coder");
+}
@@ -0,0 +1,98 @@
+// Coalesced tuning (setRxFrequencyUp/Down with setRxTuneCoalesce and rxTuneProcess). See README.md
+#include <QN8066.h>
+#include "qn8066_sim.h"
+
+static QN8066 rx;
+
+// Frequency written in RX_CH (and CH_STEP bits 1-0)
+static uint16_t tuned() {
+  return 600 + (simRegs[QN_RX_CH] | ((simRegs[QN_CH_STEP] & 3) << 8)) / 2;
+}
+
+int main() {
+  uint32_t tunes, t0, busDirect, busCoalesced;
+  uint8_t count;
+
+  simReset();
+  rx.setup();
+  rx.setRX(1000);
+  rx.setRxFrequencyRange(880, 1080);
+
+  // Coalesce disabled (default): each step tunes at once
+  tunes = simTunes;
+  for (uint8_t i = 0; i < 5; i++) rx.setRxFrequencyUp();
+  CHECK(simTunes - tunes == 5 && tuned() == 1005 && rx.getRxCurrentFrequency() == 1005);
+  CHECK(!rx.rxTuneProcess());
+
+  // Coalesce 40 ms: 10 steps 5 ms apart are tuned once, 40 ms after the last step. The frequency is updated at once.
+  rx.setRxTuneCoalesce(40);
+  tunes = simTunes;
+  count = rx.getRxTuneCount();
+  for (uint8_t i = 0; i < 10; i++) {
+    rx.setRxFrequencyUp();
+    CHECK(!rx.rxTuneProcess());
+    delay(5);
+  }
+  CHECK(rx.getRxCurrentFrequency() == 1015 && tuned() == 1005 && simTunes == tunes);
+  delay(30);
+  CHECK(!rx.rxTuneProcess());
+  delay(5);
+  CHECK(rx.rxTuneProcess());
+  CHECK(simTunes - tunes == 1 && tuned() == 1015 && (uint8_t) (rx.getRxTuneCount() - count) == 1);
+  CHECK(!rx.rxTuneProcess());
+
+  // Steps up and down within the coalesce time: one tuning to the final frequency
+  tunes = simTunes;
+  rx.setRxFrequencyUp();
+  rx.setRxFrequencyUp();
+  rx.setRxFrequencyDown();
+  delay(40);
+  CHECK(rx.rxTuneProcess() && simTunes - tunes == 1 && tuned() == 1016);
+
+  // A continuous burst (one step each 10 ms for 300 ms) is tuned once, at the end
+  tunes = simTunes;
+  t0 = millis();
+  while ( millis() - t0 < 300 ) {
+    rx.setRxFrequencyDown();
+    rx.rxTuneProcess();
+    delay(10);
+  }
+  CHECK(simTunes == tunes && rx.getRxCurrentFrequency() == 986);
+  delay(40);
+  CHECK(rx.rxTuneProcess() && simTunes - tunes == 1 && tuned() == 986);
+
+  // Band edges: the wraparound is coalesced too
+  rx.setRxFrequency(1079);
+  rx.setRxFrequencyUp();
+  rx.setRxFrequencyUp();
+  rx.setRxFrequencyUp();
+  delay(40);
+  CHECK(rx.rxTuneProcess() && tuned() == 881);
+  rx.setRxFrequencyDown();
+  rx.setRxFrequencyDown();
+  delay(40);
+  CHECK(rx.rxTuneProcess() && tuned() == 1080);
+
+  // setRxFrequency tunes at once and drops the pending step
+  rx.setRxFrequencyUp();
+  rx.setRxFrequency(950);
+  delay(40);
+  CHECK(!rx.rxTuneProcess() && tuned() == 950 && rx.getRxCurrentFrequency() == 950);
+
+  // I2C bus time of 20 encoder steps (100 kHz bus): direct against coalesced
+  simI2CByteTime = 90;
+  rx.setRxTuneCoalesce(0);
+  t0 = micros();
+  for (uint8_t i = 0; i < 20; i++) rx.setRxFrequencyUp();
+  busDirect = micros() - t0;
+  rx.setRxTuneCoalesce(40);
+  t0 = micros();
+  for (uint8_t i = 0; i < 20; i++) rx.setRxFrequencyUp();
+  delay(40);
+  rx.rxTuneProcess();
+  busCoalesced = micros() - t0 - 40000;
+  printf("20 steps: %u us of I2C and command delays tuning each step, %u us coalesced\n", (unsigned) busDirect, (unsigned) busCoalesced);
+  CHECK(tuned() == 990 && busCoalesced * 10 < busDirect);
+
+  return simResult("test_rx_tune");
+}
@@ -0,0 +1,117 @@
+// RX seek and band scan on the simulated channel scan (CHSC and RXCCA_FAIL). See README.md
+#include <QN8066.h>
+#include "qn8066_sim.h"
+
+static QN8066 rx;
+
+typedef struct {
+  uint16_t frequency;
+  uint8_t rssi;
+  uint8_t snr;
+} test_station;
+
+static const test_station stations[] = {{885, 40, 30}, {917, 35, 22}, {949, 50, 35}, {1001, 28, 18}, {1035, 45, 26}, {1061, 33, 20}};
+#define TEST_STATIONS (sizeof(stations) / sizeof(stations[0]))
+
+// Band with the stations above and weak signals (SNR below the CCA threshold) on the other channels
+static void band(uint8_t count) {
+  for (uint16_t f = 880; f <= 1080; f++) simSetStation(f, 10 + f % 7, f % 9);
+  for (uint8_t i = 0; i < count; i++) simSetStation(stations[i].frequency, stations[i].rssi, stations[i].snr);
+}
+
+static void start(uint16_t frequency) {
+  simReset();
+  rx.setup();
+  rx.setRX(frequency);
+  rx.setRxFrequencyRange(880, 1080);
+}
+
+int main() {
+  qn8066_station list[10];
+  uint32_t t0, ccaTime, loopTime;
+  uint8_t n, result;
+
+  // Up: the next station above; at the end of the band, wraps around to the first station of the band
+  start(885);
+  band(TEST_STATIONS);
+  CHECK(rx.seekRxStationUp() == 917 && rx.getRxCurrentFrequency() == 917);
+  CHECK((simRegs[QN_SYSTEM1] & 0B101) == 0B001);   // Back to the normal mode: CHSC = 0; CCA_CH_DIS = 1
+  rx.setRxFrequency(1070);
+  CHECK(rx.seekRxStationUp() == 885 && rx.getRxCurrentFrequency() == 885);
+
+  // Down: the next station below; at the beginning of the band, wraps around to the last station of the band
+  CHECK(rx.seekRxStationDown() == 1061);
+  rx.setRxFrequency(1001);
+  CHECK(rx.seekRxStationDown() == 949);
+
+  // Only one station: the seek comes back to it from both sides
+  start(1035);
+  band(0);
+  simSetStation(949, 50, 35);
+  CHECK(rx.seekRxStationUp() == 949);
+  rx.setRxFrequency(900);
+  CHECK(rx.seekRxStationDown() == 949);
+
+  // No station: RXCCA_FAIL, the previous frequency is restored
+  start(950);
+  band(0);
+  rx.seekRxStart(951, 1080);
+  while ( (result = rx.seekRxProcess()) == QN8066_SEEK_BUSY ) delay(2);
+  CHECK(result == QN8066_SEEK_FAIL && rx.getRxCurrentFrequency() == 950 && !rx.isSeeking());
+  CHECK(!rx.isValidRxChannel());
+  CHECK(rx.seekRxStationUp() == 0 && rx.getRxCurrentFrequency() == 950);
+
+  // Timeout: CHSC is never cleared. The scan is aborted after seekStepTimeout ms per channel (+ 20 ms): 130 channels
+  start(950);
+  band(TEST_STATIONS);
+  simCcaHang = true;
+  rx.setSeekStepTimeout(5);
+  t0 = millis();
+  rx.seekRxStart(951, 1080);
+  while ( (result = rx.seekRxProcess()) == QN8066_SEEK_BUSY ) delay(2);
+  CHECK(result == QN8066_SEEK_TIMEOUT && rx.getRxCurrentFrequency() == 950);
+  CHECK(millis() - t0 >= 130 * 5 + 20 && millis() - t0 <= 130 * 5 + 20 + 20);   // + polling and I2C command delays
+  CHECK((simRegs[QN_SYSTEM1] & 0B101) == 0B001);   // The scan was stopped
+  CHECK(rx.seekRxProcess() == QN8066_SEEK_FAIL);   // Nothing running
+
+  // Band scan: list capacity, measures and the frequency restored at the end
+  start(1000);
+  band(TEST_STATIONS);
+  n = rx.scanRxBand(list, 4);
+  CHECK(n == 4 && rx.getScanCount() == 4 && rx.getRxCurrentFrequency() == 1000);
+  for (uint8_t i = 0; i < n; i++)
+    CHECK(list[i].frequency == stations[i].frequency && list[i].rssi == stations[i].rssi && list[i].snr == stations[i].snr);
+  n = rx.scanRxBand(list, 10);
+  CHECK(n == TEST_STATIONS && list[TEST_STATIONS - 1].frequency == 1061);
+  band(0);
+  CHECK(rx.scanRxBand(list, 10) == 0 && rx.getRxCurrentFrequency() == 1000);
+  CHECK(rx.scanRxBand(list, 0) == 0);
+
+  // Time of the band scan (CCA) against a software scan (setRxFrequencyUp + getRxRSSI on each channel), with the
+  // I2C bus at 100 kHz and 10 ms of AGC settling after each tuning
+  start(880);
+  band(TEST_STATIONS);
+  simI2CByteTime = 90;
+  simAgcSettle = 10000;
+  t0 = millis();
+  n = rx.scanRxBand(list, 10);
+  ccaTime = millis() - t0;
+  CHECK(n == TEST_STATIONS);
+
+  rx.setRxFrequency(880);
+  t0 = millis();
+  n = 0;
+  for (uint16_t i = 0; i <= 200; i++) {
+    if ( i > 0 ) rx.setRxFrequencyUp();
+    while ( !rx.isRxAgcStable() ) delay(1);
+    if ( rx.getRxSNR() >= 16 ) n++;   // SNR_CCA_TH
+    rx.getRxRSSI();
+  }
+  loopTime = millis() - t0;
+  CHECK(n == TEST_STATIONS);
+  printf("Band scan of 201 channels, %u stations: CCA %u ms; setRxFrequencyUp + getRxRSSI loop %u ms\n",
+         (unsigned) TEST_STATIONS, (unsigned) ccaTime, (unsigned) loopTime);
+  CHECK(ccaTime < loopTime);
+
+  return simResult("test_seek_scan");
+}
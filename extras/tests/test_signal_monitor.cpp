@@ -0,0 +1,124 @@
+// RX signal quality monitor (QN8066SignalMonitor): smoothing, threshold events and I2C budget. See README.md
+#include <QN8066.h>
+#include <QN8066SignalMonitor.h>
+#include "qn8066_sim.h"
+
+#define STEREO 0x04               // STATUS1: RXAGCSET = 1 (settled), ST_MO_RX = 0 (stereo)
+#define MONO 0x05                 // STATUS1: RXAGCSET = 1, ST_MO_RX = 1
+#define AGC_ERROR 0x00            // STATUS1: RXAGCSET = 0, stereo
+
+static QN8066 rx;
+static QN8066SignalMonitor monitor;
+static uint8_t lastEvents = 0;
+static uint16_t calls = 0;
+
+static void signalChanged(uint8_t events) {
+  lastEvents = events;
+  calls++;
+}
+
+int main() {
+  uint8_t events, reported;
+  uint16_t count;
+  double reference;
+  int errors;
+
+  simReset();
+  rx.setup();
+  rx.setRX(1000);
+
+  // The first sample is used as it is and raises all events
+  monitor.begin(&rx, 5, 2);
+  monitor.setCallback(signalChanged, 3, 3, 20);
+  CHECK(monitor.feed(20, 40, STEREO) == (SIGNAL_EVENT_RSSI | SIGNAL_EVENT_SNR | SIGNAL_EVENT_STEREO | SIGNAL_EVENT_AGC));
+  CHECK(calls == 1 && monitor.getRSSI() == 40 && monitor.getSNR() == 20 && monitor.isStereo() && !monitor.isAgcUnstable());
+
+  // Noise below the thresholds: no events, the smoothed value stays in the middle
+  for (uint8_t i = 0; i < 100; i++) monitor.feed(20 + (i & 1) * 2, 40 + (i & 1) * 2, STEREO);
+  CHECK(calls == 1 && monitor.getRSSI() >= 40 && monitor.getRSSI() <= 42);
+
+  // Step of 20 dB: the smoothed RSSI follows the exponential smoothing (weight 1/4) and each event is 3 dB or more
+  // from the last one reported. It ends on the new value.
+  monitor.reset();
+  monitor.feed(20, 40, STEREO);
+  reference = 40;
+  reported = 40;
+  errors = 0;
+  count = 0;
+  for (uint8_t i = 0; i < 30; i++) {
+    reference += (60 - reference) / 4;
+    events = monitor.feed(20, 60, STEREO);
+    errors += (monitor.getRSSI() > reference + 1 || monitor.getRSSI() < reference - 1);
+    if ( events & SIGNAL_EVENT_RSSI ) {
+      errors += monitor.getRSSI() - reported < 3;
+      reported = monitor.getRSSI();
+      count++;
+    }
+    errors += (events & ~SIGNAL_EVENT_RSSI) != 0;
+  }
+  CHECK(errors == 0 && monitor.getRSSI() == 60 && count >= 4 && count <= 6);
+
+  // No smoothing: each sample is the value
+  monitor.begin(&rx, 5, 0);
+  monitor.feed(20, 40, STEREO);
+  monitor.feed(25, 47, STEREO);
+  CHECK(monitor.getRSSI() == 47 && monitor.getSNR() == 25);
+
+  // Stereo with hysteresis: from stereo (100%), the 5th mono sample goes below 25% (75, 56, 42, 32, 24)
+  monitor.begin(&rx, 5, 2);
+  monitor.feed(20, 40, STEREO);
+  for (uint8_t i = 1; i <= 5; i++) {
+    events = monitor.feed(20, 40, MONO);
+    CHECK(((events & SIGNAL_EVENT_STEREO) != 0) == (i == 5));
+  }
+  CHECK(!monitor.isStereo() && monitor.getStereoRatio() == 24);
+  // Stereo and mono samples alternated (about 50%) do not change it
+  count = 0;
+  for (uint8_t i = 0; i < 100; i++) count += (monitor.feed(20, 40, (i & 1) ? MONO : STEREO) & SIGNAL_EVENT_STEREO) != 0;
+  CHECK(count == 0 && !monitor.isStereo());
+
+  // AGC error rate: one sample not settled (25%) is above 20%; the next settled sample (19%) is below again
+  monitor.begin(&rx, 5, 2);
+  monitor.feed(20, 40, STEREO);
+  calls = 0;
+  CHECK(monitor.feed(20, 40, AGC_ERROR) == SIGNAL_EVENT_AGC && monitor.isAgcUnstable() && monitor.getAgcErrorRate() == 25);
+  CHECK(monitor.feed(20, 40, STEREO) == SIGNAL_EVENT_AGC && !monitor.isAgcUnstable());
+  CHECK(calls == 2 && lastEvents == SIGNAL_EVENT_AGC);
+  CHECK(monitor.feed(20, 40, STEREO) == 0 && calls == 2);
+
+  // reset: the next sample raises all events again
+  monitor.reset();
+  CHECK(monitor.feed(20, 40, STEREO) == (SIGNAL_EVENT_RSSI | SIGNAL_EVENT_SNR | SIGNAL_EVENT_STEREO | SIGNAL_EVENT_AGC));
+  CHECK(monitor.getSamples() == 1);
+
+  // process: reads the simulated registers within the I2C budget (5 reads per second => one sample each 200 ms)
+  simSetStation(1000, 45, 28);
+  monitor.begin(&rx, 5, 2);
+  count = 0;
+  for (uint16_t t = 0; t < 2000; t += 10) {
+    count += monitor.process();
+    delay(10);
+  }
+  CHECK(count == 10 && monitor.getSamples() == 10);
+  CHECK(monitor.getRSSI() == 45 && monitor.getSNR() == 28 && !monitor.isAgcUnstable());
+  monitor.setBudget(0);
+  CHECK(!monitor.process());
+  monitor.setBudget(20);
+  delay(50);
+  CHECK(monitor.process() && !monitor.process());
+
+  // A new frequency with the AGC settling for 250 ms: the AGC error is reported, and cleared after it settles
+  simAgcSettle = 250000;
+  simSetStation(1010, 20, 5);
+  rx.setRxFrequency(1010);
+  monitor.reset();
+  bool unstable = false;
+  for (uint16_t t = 0; t < 1000; t += 10) {
+    monitor.process();
+    unstable = unstable || monitor.isAgcUnstable();
+    delay(10);
+  }
+  CHECK(unstable && !monitor.isAgcUnstable() && monitor.getRSSI() == 20 && monitor.getSNR() == 5);
+
+  return simResult("test_signal_monitor");
+}
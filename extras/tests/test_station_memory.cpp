@@ -0,0 +1,168 @@
+// Station memory (QN8066StationMemory) on a RAM storage: records, CRC, wear leveling slots and the PI index. See README.md
+#include <QN8066.h>
+#include <QN8066StationMemory.h>
+#include "qn8066_sim.h"
+
+#define TEST_ADDRESS 16           // Storage address of the first record
+#define TEST_CAPACITY 5
+#define TEST_COPIES 2
+
+static QN8066StationMemory memory;
+static uint8_t storage[512];
+static uint16_t lowest, highest;  // Storage range written
+static uint16_t hours = 0;        // Time source: hours since 2024-01-01 00:00
+
+static void storageRead(uint16_t address, uint8_t *data, uint8_t size) {
+  memcpy(data, &storage[address], size);
+}
+
+static void storageWrite(uint16_t address, const uint8_t *data, uint8_t size) {
+  if ( address < lowest ) lowest = address;
+  if ( address + size > highest ) highest = address + size;
+  memcpy(&storage[address], data, size);
+}
+
+static bool timeSource(qn8066_date_time *dt) {
+  dt->year = 2024;
+  dt->month = 1;
+  dt->day = 1 + hours / 24;
+  dt->hour = hours % 24;
+  dt->minute = dt->second = 0;
+  return true;
+}
+
+// Reference CRC-8 (x^8 + x^2 + x + 1; initial value 0xFF)
+static uint8_t crc8(const uint8_t *data, uint8_t size) {
+  uint8_t crc = 0xFF;
+  while ( size-- ) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+static uint8_t *record(uint8_t group, uint8_t slot) {
+  return &storage[TEST_ADDRESS + (group * TEST_COPIES + slot) * QN8066_STATION_RECORD];
+}
+
+static uint8_t load() {
+  uint8_t n = memory.begin(storageRead, storageWrite, TEST_ADDRESS, TEST_CAPACITY, TEST_COPIES);
+  memory.setTimeSource(timeSource);
+  return n;
+}
+
+static uint8_t rssiOf(uint16_t frequency) {
+  int8_t idx = memory.find(frequency);
+  return (idx < 0) ? 0 : memory.get(idx)->rssi;
+}
+
+int main() {
+  uint8_t *r;
+  int8_t idx;
+  uint8_t group;
+
+  // Erased storage (0xFF): no station is loaded
+  memset(storage, 0xFF, sizeof(storage));
+  lowest = 0xFFFF;
+  highest = 0;
+  CHECK(load() == 0 && memory.getCount() == 0 && memory.find(1001) < 0);
+
+  // Stations are kept in frequency order (binary search)
+  CHECK(memory.update(1001, 30) && memory.update(885, 40) && memory.update(949, 50));
+  CHECK(memory.getCount() == 3 && memory.get(0)->frequency == 885 && memory.get(1)->frequency == 949 && memory.get(2)->frequency == 1001);
+  CHECK(memory.find(949) == 1 && memory.find(950) < 0 && memory.getWrites() == 3);
+
+  // Record of the first station: group 0, slot 0, sequence 1, and the CRC-8 of the first 15 bytes
+  r = record(0, 0);
+  CHECK(((r[0] << 8) | r[1]) == ((1 << 11) | 1001) && r[12] == 30 && r[15] == crc8(r, 15));
+  CHECK(memory.get(2)->group == 0 && memory.get(0)->group == 1 && memory.get(1)->group == 2);
+
+  // The record is written only when the RSSI changes QN8066_STATION_RSSI_DELTA or more, or after QN8066_STATION_REFRESH hours
+  CHECK(!memory.update(1001, 30) && !memory.update(1001, 30 + QN8066_STATION_RSSI_DELTA - 1) && memory.getWrites() == 3);
+  CHECK(memory.update(1001, 30 + QN8066_STATION_RSSI_DELTA) && memory.getWrites() == 4);
+  hours = QN8066_STATION_REFRESH - 1;
+  CHECK(!memory.update(885, 40));
+  hours = QN8066_STATION_REFRESH;
+  CHECK(memory.update(885, 40) && memory.get(0)->lastSeen == QN8066_STATION_REFRESH);
+
+  // The update goes to the next slot of the group (sequence 2); the old copy is kept
+  r = record(0, 1);
+  CHECK(((r[0] << 8) | r[1]) == ((2 << 11) | 1001) && r[12] == 36 && r[15] == crc8(r, 15));
+  CHECK(record(0, 0)[12] == 30 && record(0, 0)[15] == crc8(record(0, 0), 15));
+
+  // begin loads the newest copy of each group
+  CHECK(load() == 3 && rssiOf(1001) == 36 && rssiOf(885) == 40 && memory.get(0)->lastSeen == QN8066_STATION_REFRESH);
+
+  // Many updates: the slots rotate and the 5 bits sequence wraps around. The newest copy wins after begin.
+  for (uint8_t i = 1; i <= 40; i++) {
+    CHECK(memory.update(949, (i & 1) ? 60 : 50));
+    CHECK(load() == 3 && rssiOf(949) == ((i & 1) ? 60 : 50));
+  }
+  CHECK(((record(2, 0)[0] >> 3) - (record(2, 1)[0] >> 3) + 32) % 32 == 1);   // 41 writes: slot 0 has the sequence 41 & 31
+
+  // A corrupted newest copy is rejected by the CRC: the previous copy is loaded. Both corrupted: the station is lost.
+  record(2, 0)[12] ^= 0x01;
+  CHECK(load() == 3 && rssiOf(949) == 60);
+  record(2, 1)[5] ^= 0x80;
+  CHECK(load() == 2 && memory.find(949) < 0);
+  // The group is free again: the next station uses it and writes after the last valid slot
+  CHECK(memory.update(1035, 45) && memory.get(memory.find(1035))->group == 2);
+  CHECK(load() == 3 && rssiOf(1035) == 45);
+
+  // PI index: stations of the same network are found in frequency order (n = 0, 1...)
+  CHECK(memory.updateRDS(1001, 0xC201, "RADIO A "));
+  CHECK(memory.updateRDS(885, 0xC201, "RADIO A "));
+  CHECK(memory.updateRDS(1035, 0x5000, "NEWS    "));
+  CHECK(!memory.updateRDS(1035, 0x5000, NULL) && !memory.updateRDS(1035, 0x5000, "NEWS    "));
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    CHECK(memory.get(memory.findPI(0xC201, 0))->frequency == 885);
+    CHECK(memory.get(memory.findPI(0xC201, 1))->frequency == 1001);
+    CHECK(memory.findPI(0xC201, 2) < 0);
+    CHECK(memory.get(memory.findPI(0x5000))->frequency == 1035 && strcmp(memory.get(memory.findPI(0x5000))->ps, "NEWS    ") == 0);
+    CHECK(memory.findPI(0x5001) < 0 && memory.findPI(0) < 0);
+    CHECK(load() == 3);   // The second pass checks the index built by begin
+  }
+  // A PI change moves the station in the index
+  CHECK(memory.updateRDS(885, 0x5000, "NEWS 2  "));
+  CHECK(memory.get(memory.findPI(0x5000, 0))->frequency == 885 && memory.get(memory.findPI(0x5000, 1))->frequency == 1035);
+  CHECK(memory.get(memory.findPI(0xC201))->frequency == 1001 && memory.findPI(0xC201, 1) < 0);
+
+  // remove writes a free record (frequency 0) and updates the index
+  idx = memory.find(1001);
+  group = memory.get(idx)->group;
+  CHECK(memory.remove(1001) && !memory.remove(1001) && memory.getCount() == 2 && memory.findPI(0xC201) < 0);
+  CHECK(load() == 2 && memory.find(1001) < 0);
+  CHECK(memory.update(917, 35) && memory.get(memory.find(917))->group == group);
+
+  // Capacity: the station not seen for the longest time is replaced by the new one
+  hours = 100;
+  CHECK(memory.update(1061, 33) && memory.getCount() == 4);
+  hours = 101;
+  CHECK(memory.update(1069, 44) && memory.getCount() == TEST_CAPACITY);
+  hours = 102;
+  memory.update(885, 60);
+  memory.update(1035, 60);
+  memory.update(917, 60);
+  hours = 103;
+  CHECK(memory.update(1079, 20) && memory.getCount() == TEST_CAPACITY && memory.find(1061) < 0);
+  CHECK(load() == TEST_CAPACITY && memory.find(1061) < 0 && rssiOf(1079) == 20);
+
+  // updateFromScan writes only the new and changed stations
+  qn8066_station list[] = {{885, 61, 20, true}, {1035, 40, 20, true}, {1079, 20, 20, false}};
+  CHECK(memory.updateFromScan(list, 3) == 1 && rssiOf(1035) == 40);
+
+  // The records are written inside the storage given to begin
+  CHECK(QN8066StationMemory::storageSize(TEST_CAPACITY, TEST_COPIES) == TEST_CAPACITY * TEST_COPIES * 16);
+  CHECK(lowest == TEST_ADDRESS && highest <= TEST_ADDRESS + QN8066StationMemory::storageSize(TEST_CAPACITY, TEST_COPIES));
+  CHECK(storage[TEST_ADDRESS - 1] == 0xFF && storage[TEST_ADDRESS + QN8066StationMemory::storageSize(TEST_CAPACITY, TEST_COPIES)] == 0xFF);
+
+  // One copy: each update overwrites the only slot of the group
+  memset(storage, 0xFF, sizeof(storage));
+  memory.begin(storageRead, storageWrite, 0, 4, 1);
+  memory.update(1001, 30);
+  memory.update(1001, 50);
+  CHECK(storage[12] == 50 && storage[16 + 15] == 0xFF);
+  CHECK(memory.begin(storageRead, storageWrite, 0, 4, 1) == 1 && rssiOf(1001) == 50);
+
+  return simResult("test_station_memory");
+}
@@ -0,0 +1,106 @@
+// Spectrum survey (surveyBand, surveyBestChannels and surveyQuietest) on a simulated band. See README.md
+#include <QN8066.h>
+#include "qn8066_sim.h"
+
+#define TEST_FIRST 880
+#define TEST_LAST 1080
+#define TEST_COUNT (TEST_LAST - TEST_FIRST + 1)
+
+static QN8066 rx;
+static uint32_t seed = 7;
+
+static uint32_t lcg() {
+  seed = seed * 1103515245UL + 12345;
+  return (seed >> 16) & 0x7FFF;
+}
+
+// Score of surveyBestChannels: RSSI plus half of the RSSI of the strongest neighbour
+static uint16_t score(const uint8_t *rssi, uint16_t count, uint16_t i) {
+  uint8_t neighbour = 0;
+  if ( i > 0 ) neighbour = rssi[i - 1];
+  if ( i + 1 < count && rssi[i + 1] > neighbour ) neighbour = rssi[i + 1];
+  return rssi[i] + neighbour / 2;
+}
+
+// Reference ranking: all channels sorted by score (stable, so the lower frequency goes first on ties)
+static void rank(const uint8_t *rssi, uint16_t count, uint16_t *order) {
+  for (uint16_t i = 0; i < count; i++) order[i] = i;
+  for (uint16_t i = 1; i < count; i++)
+    for (uint16_t j = i; j > 0 && score(rssi, count, order[j - 1]) > score(rssi, count, order[j]); j--) {
+      uint16_t aux = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = aux;
+    }
+}
+
+static void randomBand() {
+  for (uint16_t f = TEST_FIRST; f <= TEST_LAST; f++) simSetStation(f, 5 + lcg() % 50, lcg() % 30);
+}
+
+int main() {
+  uint8_t rssi[TEST_COUNT], snr[TEST_COUNT];
+  uint16_t best[TEST_COUNT], order[TEST_COUNT];
+  uint16_t n;
+  int errors;
+
+  simReset();
+  rx.setup();
+  rx.setRX(1000);
+
+  // surveyBand reads the RSSI and SNR of each channel and tunes back
+  randomBand();
+  n = rx.surveyBand(TEST_FIRST, TEST_LAST, 1, rssi, snr);
+  CHECK(n == TEST_COUNT && rx.getRxCurrentFrequency() == 1000);
+  errors = 0;
+  for (uint16_t i = 0; i < n; i++) errors += rssi[i] != simRssi[(TEST_FIRST + i - 600) * 2] || snr[i] != simSnr[(TEST_FIRST + i - 600) * 2];
+  CHECK(errors == 0);
+  CHECK(rx.surveyBand(1000, 990, 1, rssi) == 0 && rx.surveyBand(990, 1000, 0, rssi) == 0);
+
+  // surveyBestChannels against the reference ranking (list smaller than the band, the whole band and no list)
+  rank(rssi, n, order);
+  for (uint8_t size = 1; size <= 20; size += 19) {
+    CHECK(rx.surveyBestChannels(rssi, n, TEST_FIRST, 1, best, size) == size);
+    errors = 0;
+    for (uint8_t i = 0; i < size; i++) errors += best[i] != TEST_FIRST + order[i];
+    CHECK(errors == 0);
+  }
+  CHECK(rx.surveyBestChannels(rssi, n, TEST_FIRST, 1, best, 255) == TEST_COUNT);
+  errors = 0;
+  for (uint16_t i = 0; i < TEST_COUNT; i++) errors += best[i] != TEST_FIRST + order[i];
+  CHECK(errors == 0);
+  CHECK(rx.surveyBestChannels(rssi, n, TEST_FIRST, 1, best, 0) == 0);
+
+  // Neighbours and ties (200 kHz step): the channel with RSSI 0 next to a strong station (score 30) is not in the list;
+  // the scores are 15, 40, 65, 30, 12, 12, 14 and 16, so the two channels with 12 keep the order of the band
+  uint8_t small[] = {10, 10, 60, 0, 8, 8, 8, 12};
+  CHECK(rx.surveyBestChannels(small, 8, 900, 2, best, 4) == 4);
+  CHECK(best[0] == 908 && best[1] == 910 && best[2] == 912 && best[3] == 900);
+
+  // surveyQuietest measures blocks of QN8066_SURVEY_CHUNK channels. A quiet channel at the end or at the beginning of a
+  // block, next to a strong station in the other block, must get the same score as in the whole survey.
+  for (uint16_t f = TEST_FIRST; f <= TEST_LAST; f++) simSetStation(f, 20, 0);
+  simSetStation(TEST_FIRST + QN8066_SURVEY_CHUNK - 1, 0, 0);        // Last channel of the first block
+  simSetStation(TEST_FIRST + QN8066_SURVEY_CHUNK, 60, 30);          // First channel of the second block
+  simSetStation(TEST_FIRST + 2 * QN8066_SURVEY_CHUNK, 0, 0);        // First channel of the third block
+  simSetStation(TEST_FIRST + 2 * QN8066_SURVEY_CHUNK - 1, 60, 30);  // Last channel of the second block
+  simSetStation(1001, 6, 0);                                        // Quietest: 6 + 20 / 2
+  CHECK(rx.surveyQuietest(TEST_FIRST, TEST_LAST) == 1001);
+  CHECK(rx.getRxCurrentFrequency() == 1000);
+  simSetStation(1001, 20, 0);
+  CHECK(rx.surveyQuietest(TEST_FIRST, TEST_LAST) == TEST_FIRST);    // Ties (20 + 10): the first channel of the band
+  simSetStation(TEST_LAST, 0, 0);                                   // Last channel of the band (one neighbour only)
+  CHECK(rx.surveyQuietest(TEST_FIRST, TEST_LAST) == TEST_LAST);
+
+  // surveyQuietest is the first channel of surveyBestChannels on random bands and ranges not multiple of the block size
+  errors = 0;
+  for (uint8_t t = 0; t < 20; t++) {
+    uint16_t first = TEST_FIRST + lcg() % 40, last = TEST_LAST - lcg() % 40;
+    randomBand();
+    n = rx.surveyBand(first, last, 1, rssi);
+    rx.surveyBestChannels(rssi, n, first, 1, best, 1);
+    errors += rx.surveyQuietest(first, last) != best[0];
+  }
+  CHECK(errors == 0);
+
+  return simResult("test_survey");
+}
@@ -0,0 +1,181 @@
+// UECP server (QN8066UECP) on a captured UECP byte stream. See README.md
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+#include <QN8066RdsDecoder.h>
+#include <QN8066UECP.h>
+#include "qn8066_sim.h"
+
+// Stream with the bytes "received" from the playout system; what the server writes (acknowledgements) is kept in out
+class CaptureStream : public Stream {
+public:
+  std::vector<uint8_t> in, out;
+  size_t pos = 0;
+  int available() {return in.size() - pos;}
+  int read() {return (pos < in.size()) ? in[pos++] : -1;}
+  size_t write(uint8_t value) {out.push_back(value); return 1;}
+};
+
+typedef struct {
+  uint8_t sqc;
+  uint8_t code;
+} test_ack;
+
+static QN8066 tx;
+static QN8066RdsEncoder rds;
+static QN8066UECP uecp;
+static CaptureStream stream;
+
+// Adds a frame (address 0) to the capture, with byte stuffing and CRC. badCrc = wrong CRC; badMfl = MFL + 1.
+static void frame(uint8_t sqc, const uint8_t *msg, uint8_t mfl, bool badCrc = false, bool badMfl = false) {
+  uint8_t data[UECP_MAX_FRAME] = {0, 0, sqc, (uint8_t) (mfl + badMfl)};
+  uint16_t crc;
+  memcpy(&data[4], msg, mfl);
+  crc = QN8066UECP::crc(data, 4 + mfl) ^ (badCrc ? 0x0100 : 0);
+  data[4 + mfl] = crc >> 8;
+  data[5 + mfl] = crc & 0xFF;
+  stream.in.push_back(UECP_STA);
+  for (uint16_t i = 0; i < 6 + mfl; i++) {
+    if ( data[i] >= UECP_ESC ) {
+      stream.in.push_back(UECP_ESC);
+      stream.in.push_back(data[i] - UECP_ESC);
+    } else {
+      stream.in.push_back(data[i]);
+    }
+  }
+  stream.in.push_back(UECP_STP);
+}
+
+// Acknowledgements written by the server (byte stuffing removed, CRC checked)
+static std::vector<test_ack> acks() {
+  std::vector<test_ack> list;
+  std::vector<uint8_t> data;
+  bool escape = false;
+  for (size_t i = 0; i < stream.out.size(); i++) {
+    uint8_t value = stream.out[i];
+    if ( value == UECP_STA ) {
+      data.clear();
+    } else if ( value == UECP_STP ) {
+      test_ack ack = {0, 0xFF};
+      if ( data.size() == 9 && data[4] == UECP_MEC_ACK &&
+           QN8066UECP::crc(data.data(), 7) == (((uint16_t) data[7] << 8) | data[8]) ) {
+        ack.sqc = data[6];
+        ack.code = data[5];
+      }
+      list.push_back(ack);
+    } else if ( value == UECP_ESC ) {
+      escape = true;
+    } else {
+      data.push_back(escape ? value + UECP_ESC : value);
+      escape = false;
+    }
+  }
+  stream.out.clear();
+  return list;
+}
+
+// Feeds the groups sent by the encoder to a receiver decoder
+static void receive(QN8066RdsDecoder *rx, int groups) {
+  simGroups.clear();
+  for (int i = 0; i < groups * 20; i++) {
+    rds.process();
+    simAdvance(SIM_RDS_PERIOD / 20);
+  }
+  for (size_t g = 0; g < simGroups.size(); g++) {
+    uint16_t block[4];
+    for (uint8_t i = 0; i < 4; i++) block[i] = ((uint16_t) simGroups[g].data[i * 2] << 8) | simGroups[g].data[i * 2 + 1];
+    rx->decodeGroup(block[0], block[1], block[2], block[3], 0, millis());
+  }
+}
+
+int main() {
+  const uint8_t check[] = "123456789";
+  std::vector<test_ack> list;
+  QN8066RdsDecoder rx;
+  char text[65];
+  uint16_t af[25];
+
+  // CRC-16/GENIBUS (CCITT polynomial, initial value 0xFFFF, inverted) reference value
+  CHECK(QN8066UECP::crc(check, 9) == 0xD64E);
+
+  simReset();
+  tx.setup();
+  tx.setTX(1069);
+  tx.rdsTxEnable(true);
+  tx.rdsInitTx(0x8, 0x1, 0x9B);
+  tx.rdsSetStationName((char *) "PU2CLR  ");
+  rds.begin(&tx);
+  uecp.begin(&tx, &rds, &stream);
+
+  // Captured stream: noise before the first STA, then PI (with bytes that need stuffing), PS, TA/TP, RT, AF with an LF/MF channel
+  const uint8_t pi[] = {UECP_MEC_PI, 0, 0, 0xFD, 0xFE};
+  const uint8_t ps[] = {UECP_MEC_PS, 0, 0, 'U', 'E', 'C', 'P', ' ', 'F', 'M', ' '};
+  const uint8_t tatp[] = {UECP_MEC_TA_TP, 0, 0, 0B10};
+  const uint8_t rt[] = {UECP_MEC_RT, 0, 0, 21, 0, 'N', 'O', 'W', ' ', 'P', 'L', 'A', 'Y', 'I', 'N', 'G', ' ', 'V', 'I', 'A', ' ', 'U', 'E', 'C', 'P'};
+  // 4 AFs: 87.6 MHz, LF/MF channel 20 (not 89.5 MHz), 97.5 MHz
+  const uint8_t afList[] = {UECP_MEC_AF, 7, 0, 0, 228, 1, 250, 20, 100};
+  stream.in.push_back(0x55);
+  stream.in.push_back(UECP_STP);
+  frame(0xFE, pi, sizeof(pi));
+  frame(1, ps, sizeof(ps));
+  frame(2, tatp, sizeof(tatp));
+  frame(3, rt, sizeof(rt));
+  frame(4, afList, sizeof(afList));
+  CHECK(uecp.process() == 5);
+  CHECK(uecp.getFrameCount() == 5 && uecp.getCrcErrors() == 0);
+  CHECK(uecp.getChanges() == (UECP_CHANGED_PI | UECP_CHANGED_PS | UECP_CHANGED_TA_TP | UECP_CHANGED_RT | UECP_CHANGED_AF));
+  list = acks();
+  CHECK(list.size() == 5);
+  for (size_t i = 0; i < list.size(); i++) CHECK(list[i].sqc == ((i == 0) ? 0xFE : i) && list[i].code == UECP_ACK_OK);
+
+  CHECK(tx.rdsGetPI() == 0xFDFE);
+  CHECK(strcmp(tx.rdsGetPS(), "UECP FM ") == 0);
+  CHECK(tx.rdsGetTP() == 1 && tx.rdsGetTA() == 0);
+
+  // The Radio Text and the AF list are on air
+  rx.begin(&tx);
+  receive(&rx, 120);
+  CHECK(rx.getPI() == 0xFDFE);
+  CHECK(rx.getRT(text) != NULL && strcmp(text, "NOW PLAYING VIA UECP") == 0);
+  CHECK(rx.getAF(af, 25) == 2 && af[0] == 876 && af[1] == 975);
+
+  // CRC error: NACK, nothing changed, and the next frame is accepted
+  const uint8_t pty[] = {UECP_MEC_PTY, 0, 0, 10};
+  frame(5, pty, sizeof(pty), true);
+  CHECK(uecp.process() == 0);
+  CHECK(uecp.getCrcErrors() == 1 && uecp.getChanges() == 0 && tx.rdsGetPTY() != 10);
+  frame(6, pty, sizeof(pty));
+  CHECK(uecp.process() == 1 && tx.rdsGetPTY() == 10);
+  list = acks();
+  CHECK(list.size() == 2 && list[0].sqc == 5 && list[0].code == UECP_ACK_CRC_ERROR && list[1].sqc == 6 && list[1].code == UECP_ACK_OK);
+
+  // NACKs: unknown MEC, parameter out of range, MFL that does not match the frame
+  const uint8_t unknown[] = {0x30, 0, 0};
+  const uint8_t range[] = {UECP_MEC_PTY, 0, 0, 32};
+  frame(7, unknown, sizeof(unknown));
+  frame(8, range, sizeof(range));
+  frame(9, pty, sizeof(pty), false, true);
+  CHECK(uecp.process() == 3);
+  list = acks();
+  CHECK(list.size() == 3 && list[0].code == UECP_ACK_UNKNOWN_MEC && list[1].code == UECP_ACK_OUT_OF_RANGE && list[2].code == UECP_ACK_MFL_ERROR);
+  CHECK(uecp.getUnknownMessages() == 1);
+
+  // Invalid stuffing (FD 05) drops the frame without acknowledgement; STA resynchronizes
+  stream.in.push_back(UECP_STA);
+  stream.in.push_back(UECP_ESC);
+  stream.in.push_back(5);
+  stream.in.push_back(UECP_STP);
+  const uint8_t pty2[] = {UECP_MEC_PTY, 0, 0, 5};
+  stream.in.push_back(UECP_STA);              // Frame not finished: the next STA starts again
+  stream.in.push_back(0);
+  frame(10, pty2, sizeof(pty2));
+  CHECK(uecp.process() == 1 && tx.rdsGetPTY() == 5);
+  list = acks();
+  CHECK(list.size() == 1 && list[0].sqc == 10 && list[0].code == UECP_ACK_OK);
+
+  // Acknowledgement disabled
+  uecp.setAck(false);
+  frame(11, pty, sizeof(pty));
+  CHECK(uecp.process() == 1 && acks().size() == 0);
+
+  return simResult("test_uecp");
+}
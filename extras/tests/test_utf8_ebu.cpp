@@ -0,0 +1,109 @@
+// UTF-8 to RDS character set conversion (QN8066::utf8ToEBU) against the whole EN 50067 Annex E table. See README.md
+#include <QN8066.h>
+#include <map>
+#include <string>
+#include "qn8066_sim.h"
+
+// EN 50067 Annex E, table E.1: codes 0x80 to 0xFE, one row per 16 codes
+static const char *annexE[8] = {
+  "áàéèíìóòúùÑÇŞß¡Ĳ",
+  "âäêëîïôöûüñçşğıĳ",
+  "ªα©‰Ğěňőπ€£$←↑→↓",
+  "º¹²³±İńűµ¿÷°¼½¾§",
+  "ÁÀÉÈÍÌÓÒÚÙŘČŠŽĐĿ",
+  "ÂÄÊËÎÏÔÖÛÜřčšžđŀ",
+  "ÃÅÆŒŷÝÕØÞŊŔĆŚŹŦð",
+  "ãåæœŵýõøþŋŕćśźŧ"
+};
+
+static std::string toUTF8(uint32_t code) {
+  std::string s;
+  if ( code < 0x80 ) {
+    s += (char) code;
+  } else if ( code < 0x800 ) {
+    s += (char) (0xC0 | (code >> 6));
+    s += (char) (0x80 | (code & 0x3F));
+  } else {
+    s += (char) (0xE0 | (code >> 12));
+    s += (char) (0x80 | ((code >> 6) & 0x3F));
+    s += (char) (0x80 | (code & 0x3F));
+  }
+  return s;
+}
+
+static uint32_t fromUTF8(const char **text) {
+  const uint8_t *p = (const uint8_t *) *text;
+  uint8_t size = (*p >= 0xE0) ? 3 : (*p >= 0xC0) ? 2 : 1;
+  uint32_t code = (size == 1) ? *p : *p & (0x3F >> (size - 1));
+  for (uint8_t i = 1; i < size; i++) code = (code << 6) | (p[i] & 0x3F);
+  *text += size;
+  return code;
+}
+
+// Converts one character and checks the result and the number of bytes used
+static bool convert(const std::string &s, uint8_t expected) {
+  const char *text = s.c_str();
+  uint8_t ebu = QN8066::utf8ToEBU(&text);
+  return ebu == expected && text == s.c_str() + s.size();
+}
+
+int main() {
+  std::map<uint32_t, uint8_t> table;   // Unicode => RDS
+  char name[9];
+  QN8066 tx;
+
+  simReset();
+  for (uint8_t row = 0; row < 8; row++) {
+    const char *p = annexE[row];
+    for (uint8_t col = 0; *p; col++) table[fromUTF8(&p)] = 0x80 + row * 16 + col;
+  }
+  CHECK(table.size() == 127);
+  // Codes below 0x80 with another glyph
+  table[0x00A4] = 0x24;   // ¤
+  table[0x2015] = 0x5E;   // ―
+  table[0x2016] = 0x60;   // ‖
+  table[0x00AF] = 0x7E;   // ¯
+  // Characters not in the RDS set mapped to the closest one
+  table[0x00D0] = 0xCE;   // Ð => Đ
+  table[0x03B2] = 0x8D;   // β => ß
+  table[0x00A0] = 0x20;   // non-breaking space
+  table[0x2013] = table[0x2014] = 0x2D;
+  table[0x2018] = table[0x2019] = 0x27;
+  table[0x201C] = table[0x201D] = 0x22;
+  table[0x2026] = 0x2E;
+
+  // ASCII: the same code, except $ ` ^ ~
+  for (uint32_t c = 1; c < 0x80; c++) {
+    uint8_t expected = (c == '$') ? 0xAB : (c == '`') ? 0x27 : (c == '^' || c == '~') ? RDS_EBU_UNKNOWN : c;
+    CHECK(convert(toUTF8(c), expected));
+  }
+
+  // The whole BMP: the characters of the table and RDS_EBU_UNKNOWN for all the others
+  int errors = 0;
+  for (uint32_t c = 0x80; c <= 0xFFFF; c++) {
+    std::map<uint32_t, uint8_t>::iterator it = table.find(c);
+    if ( !convert(toUTF8(c), (it != table.end()) ? it->second : RDS_EBU_UNKNOWN) ) {
+      if ( errors++ < 10 ) printf("U+%04X\n", (unsigned) c);
+    }
+  }
+  CHECK(errors == 0);
+
+  // 4 bytes sequences (out of the table), bytes that are not UTF-8 and the end of the text
+  CHECK(convert("\xF0\x9F\x98\x80", RDS_EBU_UNKNOWN));
+  CHECK(convert("\xE9", 0xE9));                           // A text already coded in the RDS set
+  const char *text = "\xC3" "A";                          // Incomplete sequence
+  CHECK(QN8066::utf8ToEBU(&text) == 0xC3 && QN8066::utf8ToEBU(&text) == 'A');
+  CHECK(QN8066::utf8ToEBU(&text) == '\0' && QN8066::utf8ToEBU(&text) == '\0' && *text == '\0');
+
+  // Station name: converted when it is set (8 RDS characters) or sent as it is (rdsSetUTF8(false))
+  tx.rdsSetStationName((char *) "CAFÉ SÃO");
+  CHECK(memcmp(tx.rdsGetPS(), "CAF\xC2 S\xE0O", 8) == 0);
+  tx.rdsSetStationName((char *) "ÁÉÍÓÚÇÃÕÑ");
+  CHECK(memcmp(tx.rdsGetPS(), "\xC0\xC2\xC4\xC6\xC8\x8B\xE0\xE6", 8) == 0);
+  tx.rdsSetUTF8(false);
+  strcpy(name, "R\x91" "DIO");
+  tx.rdsSetStationName(name);
+  CHECK(memcmp(tx.rdsGetPS(), "R\x91" "DIO   ", 8) == 0);
+
+  return simResult("test_utf8_ebu");
+}
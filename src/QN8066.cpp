@@ -79,6 +79,24 @@ uint8_t QN8066::getRegister(uint8_t registerNumber) {
   return Wire.read();
 }
 
+/**
+ * @ingroup group02 I2C
+ * @brief Reads consecutive registers in one I2C transaction
+ * @param registerNumber - first register
+ * @param data - receives the values
+ * @param count - number of registers
+ */
+void QN8066::getRegisters(uint8_t registerNumber, uint8_t *data, uint8_t count) {
+
+  Wire.beginTransmission(QN8066_I2C_ADDRESS);
+  Wire.write(registerNumber);
+  Wire.endTransmission();
+  delayMicroseconds(QN8066_DELAY_COMMAND);
+
+  Wire.requestFrom(QN8066_I2C_ADDRESS, (int) count);
+  for (uint8_t i = 0; i < count; i++) data[i] = Wire.read();
+}
+
 /**
  * @ingroup group02 I2C
  * @brief Stores a value to a given register
@@ -95,6 +113,22 @@ void QN8066::setRegister(uint8_t registerNumber, uint8_t value) {
   delayMicroseconds(QN8066_DELAY_COMMAND);
 }
 
+/**
+ * @ingroup group02 I2C
+ * @brief Stores values to consecutive registers in one I2C transaction
+ * @param registerNumber - first register
+ * @param data - values
+ * @param count - number of registers
+ */
+void QN8066::setRegisters(uint8_t registerNumber, const uint8_t *data, uint8_t count) {
+
+  Wire.beginTransmission(QN8066_I2C_ADDRESS);
+  Wire.write(registerNumber);
+  for (uint8_t i = 0; i < count; i++) Wire.write(data[i]);
+  Wire.endTransmission();
+  delayMicroseconds(QN8066_DELAY_COMMAND);
+}
+
 /**
  * @ingroup group02 Device Status
  * @brief Gets the current device Status stored in STATUS1 register
@@ -365,15 +399,9 @@ void QN8066::setRX(uint16_t frequency) {
   this->setRegister(QN_RDS, this->rds.raw);     // RDS => 00111100 => Line_in_en = 0; RDSFDEV = 60 (Decimal) 
   this->setRegister(QN_GPLT, this->gplt.raw);    // GPLT => 00111001 => Tx_sftclpth = 00 (12’d2051 - 3db back off from 0.5v); t1m_sel = 11 (Infinity); GAIN_TXPLT = 1001 (9% 75 kHz)
 
-  this->rxCurrentFrequency = frequency;
-  uint16_t channel = (frequency - 600)  * 2;
-  qn8066_rx_ch rxch; 
-  qn8066_ch_step ch_step;
-  ch_step.raw = this->getRegister(QN_CH_STEP);
-  ch_step.arg.RXCH  =  0B0000000000000011 & (channel >> 8);
-  rxch.RXCH =  0B0000000011111111 & channel;
-  this->setRegister(QN_CH_STEP, ch_step.raw );
-  this->setRegister(QN_RX_CH,rxch.RXCH);
+  // The registers were reset (swrst): the channel registers are rebuilt from the shadows
+  this->scanRxRange(this->minimalFrequency, this->maximalFrequency, this->rxCurrentStep);
+  this->rxTune(frequency);
 
   // Checking unkown registers
   // this->setRegister(0x49, 0B11101000); 
@@ -392,15 +420,96 @@ void QN8066::setRX(uint16_t frequency) {
  * @brief sets the receiver frequency
  */
 void QN8066::setRxFrequency(uint16_t frequency) {
-  this->rxCurrentFrequency = frequency;
+  this->rxTunePending = false;
+  this->rxTune(frequency);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief Writes the receiver channel
+ * @details RX_CH, CH_START, CH_STOP and CH_STEP are written in one I2C transaction from the shadows (ch_start, ch_stop 
+ * @details and ch_step), so no register is read.
+ * @param frequency - frequency (MHz x 10)
+ */
+void QN8066::rxTune(uint16_t frequency) {
   uint16_t channel = (frequency - 600)  * 2;
-  qn8066_rx_ch rxch; 
-  qn8066_ch_step ch_step;
-  ch_step.raw = this->getRegister(QN_CH_STEP);
-  ch_step.arg.RXCH  =  0B0000000000000011 & (channel >> 8);
-  rxch.RXCH =  0B0000000011111111 & channel;
-  this->setRegister(QN_CH_STEP, ch_step.raw );
-  this->setRegister(QN_RX_CH,rxch.RXCH);
+  uint8_t data[4];
+
+  this->rxCurrentFrequency = frequency;
+  this->rxTuneCount++;
+  this->ch_step.arg.RXCH = 0B0000000000000011 & (channel >> 8);
+  data[0] = 0B0000000011111111 & channel;  // RX_CH
+  data[1] = this->ch_start.raw;            // CH_START
+  data[2] = this->ch_stop.raw;             // CH_STOP
+  data[3] = this->ch_step.raw;             // CH_STEP
+  this->setRegisters(QN_RX_CH, data, 4);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief Tunes a channel writing only the minimal registers
+ * @details Writes only RX_CH. When the two high bits of the channel change, RX_CH to CH_STEP are written from the 
+ * @details shadows, still in one I2C transaction. rxCurrentFrequency is not changed. 
+ * @details Used by surveyBand and probeRxFrequency.
+ * @param frequency - frequency (MHz x 10)
+ */
+void QN8066::rxTuneChannel(uint16_t frequency) {
+  uint16_t channel = (frequency - 600) * 2;
+  uint8_t data[4];
+
+  this->rxTuneCount++;
+  if ( this->ch_step.arg.RXCH == (channel >> 8) ) {
+    this->setRegister(QN_RX_CH, channel & 0xFF);
+    return;
+  }
+  this->ch_step.arg.RXCH = channel >> 8;
+  data[0] = channel & 0xFF;          // RX_CH
+  data[1] = this->ch_start.raw;      // CH_START
+  data[2] = this->ch_stop.raw;       // CH_STOP
+  data[3] = this->ch_step.raw;       // CH_STEP
+  this->setRegisters(QN_RX_CH, data, 4);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief Tunes the frequency requested by setRxFrequencyUp or setRxFrequencyDown (coalesce mode)
+ * @details When the coalesce mode is enabled (setRxTuneCoalesce), the steps requested within the coalesce time are 
+ * @details collapsed into a single tuning to the final frequency. getRxCurrentFrequency already returns the final 
+ * @details frequency, so the display can be updated at once. Call this function in the loop.
+ * @return true if the receiver was tuned
+ * @details Example
+ * @code 
+ * void setup() {
+ *   ...
+ *   rx.setRxTuneCoalesce(40);   // Encoder steps within 40 ms are tuned once
+ * }
+ * void loop() {
+ *   if (encoderCount != 0) {
+ *     if (encoderCount == 1) rx.setRxFrequencyUp(); else rx.setRxFrequencyDown();
+ *     showFrequency();
+ *     encoderCount = 0;
+ *   }
+ *   rx.rxTuneProcess();
+ * }
+ * @endcode  
+ */
+bool QN8066::rxTuneProcess() {
+  if ( !this->rxTunePending || millis() - this->rxTuneRequest < this->rxTuneCoalesce ) return false;
+  this->setRxFrequency(this->rxCurrentFrequency);
+  return true;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief Tunes now or, in coalesce mode, schedules the tuning (see rxTuneProcess)
+ */
+void QN8066::rxTuneStep() {
+  if ( this->rxTuneCoalesce == 0 ) {
+    this->setRxFrequency(this->rxCurrentFrequency);
+    return;
+  }
+  this->rxTunePending = true;
+  this->rxTuneRequest = millis();
 }
 
 /**
@@ -426,7 +535,7 @@ void QN8066::setRxFrequencyUp() {
   if ( this->rxCurrentFrequency > this->maximalFrequency ) 
     this->rxCurrentFrequency = this->minimalFrequency;
 
-  this->setRxFrequency(this->rxCurrentFrequency);
+  this->rxTuneStep();
 }
 
 /**
@@ -440,7 +549,7 @@ void QN8066::setRxFrequencyDown() {
   if ( this->rxCurrentFrequency < this->minimalFrequency ) 
     this->rxCurrentFrequency = this->maximalFrequency;
 
-  this->setRxFrequency(this->rxCurrentFrequency);
+  this->rxTuneStep();
 
 }
 
@@ -451,11 +560,9 @@ void QN8066::setRxFrequencyDown() {
  * @param value 
  */
 void QN8066::setRxFrequencyStep(uint8_t value) {
-  qn8066_ch_step step;
-  step.raw = this->getRegister(QN_CH_STEP);
-  step.arg.CH_FSTEP = value; 
+  this->ch_step.arg.CH_FSTEP = value; 
   this->rxCurrentStep = value;
-  this->setRegister(QN_CH_STEP, step.raw);
+  this->setRegister(QN_CH_STEP, this->ch_step.raw);
 }
 
 
@@ -552,33 +659,406 @@ bool QN8066::isRxStereo() {
 /**
  * @ingroup group03 RX
  * @brief   Scans a station
- * @details Searches for a station within a specified frequency range.
+ * @details Searches for a station within a specified frequency range using the channel scan (CCA) of the QN8066 
+ * @details and waits for the result. If startFrequency is greater than stopFrequency, the scan goes down.
+ * @details If a station is found, the receiver stays tuned on it. Otherwise, the previous frequency is restored.
  * @param startFrequency - initial frequency to start the search.
  * @param stopFrequyency - final frequency to stop the search.
  * @param frequencyStep  - 0 = 50KHz; 1 = 100KHz; 2 =  200KHz
+ * @return frequency found or 0 if there is no valid channel in the range
+ * @see seekRxStart, seekRxProcess, setSeekStepTimeout
  */
-void QN8066::scanRxStation(uint16_t startFrequency, uint16_t stopFrequyency, uint8_t frequencyStep ) {
+uint16_t QN8066::scanRxStation(uint16_t startFrequency, uint16_t stopFrequyency, uint8_t frequencyStep ) {
+  uint8_t result;
 
-  qn8066_ch_start start; 
-  qn8066_ch_stop stop; 
-  qn8066_ch_step step; 
+  this->seekRxStart(startFrequency, stopFrequyency, frequencyStep);
+  while ( (result = this->seekRxProcess()) == QN8066_SEEK_BUSY ) delay(2);
 
-  step.raw = this->getRegister(QN_CH_STEP);
+  return (result == QN8066_SEEK_FOUND) ? this->rxCurrentFrequency : 0;
+} 
+
+/**
+ * @ingroup group03 RX
+ * @brief   Starts the channel scan (CCA) of the QN8066 and returns immediately
+ * @details Writes the range in CH_START, CH_STOP and CH_STEP and sets CHSC in SYSTEM1 with CCA_CH_DIS = 0, so the 
+ * @details QN8066 decides RX_CH. The QN8066 stops on the first channel with SNR above the CCA threshold. 
+ * @details Call seekRxProcess until it is not QN8066_SEEK_BUSY.
+ * @param startFrequency - initial frequency (MHz x 10).
+ * @param stopFrequency - final frequency (MHz x 10). If lower than startFrequency, the scan goes down.
+ * @param frequencyStep - 0 = 50KHz; 1 = 100KHz; 2 =  200KHz
+ * @details Example
+ * @code 
+ * rx.seekRxStart(rx.getRxCurrentFrequency() + 1, 1080);
+ * ...
+ * void loop() {
+ *   if ( rx.isSeeking() && rx.seekRxProcess() == QN8066_SEEK_FOUND ) showFrequency();
+ *   ...
+ * }
+ * @endcode  
+ */
+void QN8066::seekRxStart(uint16_t startFrequency, uint16_t stopFrequency, uint8_t frequencyStep) {
+  uint16_t channels;
+
+  this->scanRxRange(startFrequency, stopFrequency, frequencyStep);
+
+  channels = ((startFrequency > stopFrequency) ? startFrequency - stopFrequency : stopFrequency - startFrequency) * 2;
+  channels = (channels >> frequencyStep) + 1;
+  this->seekDeadline = millis() + (uint32_t) channels * this->seekStepTimeout + 20;
+  this->seekBusy = true;
+
+  this->system1.raw = 0B00010110; // rxreq = 1; chsc = 1; ccs_ch_dis = 1; cca_ch_dis = 0 (RX_CH decided by the CCA)
+  this->setRegister(QN_SYSTEM1, this->system1.raw);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Checks the channel scan started by seekRxStart
+ * @details The QN8066 clears CHSC when the scan is finished. Then RXCCA_FAIL (STATUS1) tells whether a valid channel 
+ * @details was found and RX_CH has the channel. When the scan is finished (or times out), the receiver goes back to 
+ * @details the normal mode (CCA_CH_DIS = 1) tuned on the channel found or on the previous frequency.
+ * @return QN8066_SEEK_BUSY, QN8066_SEEK_FOUND, QN8066_SEEK_FAIL or QN8066_SEEK_TIMEOUT
+ */
+uint8_t QN8066::seekRxProcess() {
+  qn8066_system1 s1;
+  uint16_t frequency = this->rxCurrentFrequency;
+  uint8_t result;
+
+  if ( !this->seekBusy ) return QN8066_SEEK_FAIL;
+
+  s1.raw = this->getRegister(QN_SYSTEM1);
+  if ( s1.arg.chsc ) {
+    if ( (int32_t) (millis() - this->seekDeadline) < 0 ) return QN8066_SEEK_BUSY;
+    result = QN8066_SEEK_TIMEOUT;
+  } else if ( this->getStatus1().arg.rxcca_fail ) {
+    result = QN8066_SEEK_FAIL;
+  } else {
+    uint16_t channel = this->getRegister(QN_RX_CH) | ((this->getRegister(QN_CH_STEP) & 0B11) << 8);
+    frequency = 600 + channel / 2;
+    result = QN8066_SEEK_FOUND;
+  }
+
+  this->seekBusy = false;
+  this->system1.raw = 0B00010011; // rxreq = 1; ccs_ch_dis = 1; cca_ch_dis = 1 (it also stops a scan that timed out)
+  this->setRegister(QN_SYSTEM1, this->system1.raw);
+  this->setRxFrequency(frequency);
+
+  return result;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Seeks the next station up
+ * @details Scans from the current frequency to the end of the band and, if nothing is found, from the beginning 
+ * @details of the band to the current frequency (see setRxFrequencyRange and setRxFrequencyStep).
+ * @return frequency found or 0 if there is no station in the band
+ */
+uint16_t QN8066::seekRxStationUp() {
+  uint16_t current = this->rxCurrentFrequency;
+  uint16_t frequency = 0;
+
+  if ( current < this->maximalFrequency ) 
+    frequency = this->scanRxStation(current + 1, this->maximalFrequency, this->rxCurrentStep);
+  if ( frequency == 0 && current > this->minimalFrequency ) 
+    frequency = this->scanRxStation(this->minimalFrequency, current - 1, this->rxCurrentStep);
+  return frequency;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Seeks the next station down
+ * @details Scans from the current frequency to the beginning of the band and, if nothing is found, from the end 
+ * @details of the band to the current frequency.
+ * @return frequency found or 0 if there is no station in the band
+ */
+uint16_t QN8066::seekRxStationDown() {
+  uint16_t current = this->rxCurrentFrequency;
+  uint16_t frequency = 0;
+
+  if ( current > this->minimalFrequency ) 
+    frequency = this->scanRxStation(current - 1, this->minimalFrequency, this->rxCurrentStep);
+  if ( frequency == 0 && current < this->maximalFrequency ) 
+    frequency = this->scanRxStation(this->maximalFrequency, current + 1, this->rxCurrentStep);
+  return frequency;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Starts a scan of the whole band and returns immediately
+ * @details The hardware scan is restarted after each station found, and each station is measured (RSSI, SNR and 
+ * @details stereo) after QN8066_SCAN_SETTLE ms. Call scanRxBandProcess until it returns false. 
+ * @details At the end, the receiver is tuned back on the current frequency.
+ * @param list - station list filled by the scan (it must exist until the end of the scan)
+ * @param size - capacity of the list
+ * @see scanRxBand, getScanCount
+ */
+void QN8066::scanRxBandStart(qn8066_station *list, uint8_t size) {
+  if ( size == 0 ) return;
+  this->scanList = list;
+  this->scanSize = size;
+  this->scanCount = 0;
+  this->scanHome = this->rxCurrentFrequency;
+  this->scanMeasureTime = 0;
+  this->seekRxStart(this->minimalFrequency, this->maximalFrequency, this->rxCurrentStep);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Runs the band scan started by scanRxBandStart
+ * @return true while the scan is running
+ */
+bool QN8066::scanRxBandProcess() {
+  uint8_t result;
+
+  if ( this->scanList == NULL ) return false;
+
+  if ( this->scanMeasureTime != 0 ) {
+    if ( millis() - this->scanMeasureTime < QN8066_SCAN_SETTLE ) return true;
+    qn8066_station *station = &this->scanList[this->scanCount++];
+    station->frequency = this->rxCurrentFrequency;
+    station->rssi = this->getRxRSSI();
+    station->snr = this->getRxSNR();
+    station->stereo = this->isRxStereo();
+    this->scanMeasureTime = 0;
+    if ( this->scanCount < this->scanSize && this->rxCurrentFrequency < this->maximalFrequency ) {
+      this->seekRxStart(this->rxCurrentFrequency + 1, this->maximalFrequency, this->rxCurrentStep);
+      return true;
+    }
+  } else {
+    result = this->seekRxProcess();
+    if ( result == QN8066_SEEK_BUSY ) return true;
+    if ( result == QN8066_SEEK_FOUND ) {
+      this->scanMeasureTime = millis() | 1;
+      return true;
+    }
+  }
+
+  this->scanList = NULL;
+  this->setRxFrequency(this->scanHome);
+  return false;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Scans the whole band and fills a station list
+ * @details Uses the channel scan (CCA) of the QN8066. It is much faster than tuning and measuring each channel 
+ * @details (setRxFrequencyUp and getRxRSSI), because the QN8066 only stops on valid channels.
+ * @param list - station list
+ * @param size - capacity of the list
+ * @return number of stations found
+ * @details Example
+ * @code 
+ * qn8066_station stations[20];
+ * uint8_t n = rx.scanRxBand(stations, 20);
+ * for (uint8_t i = 0; i < n; i++) {
+ *   Serial.print(stations[i].frequency);
+ *   Serial.print(" RSSI ");
+ *   Serial.println(stations[i].rssi);
+ * }
+ * @endcode  
+ * @see scanRxBandStart
+ */
+uint8_t QN8066::scanRxBand(qn8066_station *list, uint8_t size) {
+  this->scanRxBandStart(list, size);
+  while ( this->scanRxBandProcess() ) delay(2);
+  return this->scanCount;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Measures RSSI and SNR over a frequency range (spectrum survey)
+ * @details Used to find the quietest channels before setting up a transmitter. The QN8066 must be in RX mode (setRX).
+ * @details Each channel is tuned writing only RX_CH (RX_CH to CH_STEP, from the shadows, when the two high bits of the channel change - see rxTuneChannel). 
+ * @details Then SNR, RSSI and STATUS1 are read in one I2C transaction until the AGC is settled (RXAGCSET), up to 
+ * @details QN8066_SURVEY_MAX_SETTLE ms. At the end, the receiver is tuned back on the current frequency.
+ * @param startFrequency - first frequency (MHz x 10)
+ * @param stopFrequency - last frequency (MHz x 10)
+ * @param step - step in 100 kHz units (1 = 100 kHz; 2 = 200 kHz...)
+ * @param rssi - returns the RSSI of each channel (rssi[0] = startFrequency). Size: (stopFrequency - startFrequency) / step + 1
+ * @param snr - returns the SNR of each channel (NULL = not used)
+ * @return number of channels measured
+ * @details Example
+ * @code 
+ * uint8_t spectrum[201];
+ * uint16_t best[5];
+ * rx.setRX(880);
+ * uint16_t n = rx.surveyBand(880, 1080, 1, spectrum);
+ * rx.surveyBestChannels(spectrum, n, 880, 1, best, 5);
+ * tx.setTX(best[0]);   // The quietest channel
+ * @endcode  
+ * @see surveyBestChannels
+ */
+uint16_t QN8066::surveyBand(uint16_t startFrequency, uint16_t stopFrequency, uint8_t step, uint8_t *rssi, uint8_t *snr) {
+  qn8066_status1 s1;
+  uint8_t data[8];      // SNR, RSSISIG, CID1, CID2, XTAL_DIV0, XTAL_DIV1, XTAL_DIV2 and STATUS1
+  uint16_t count = 0;
+  uint16_t home = this->rxCurrentFrequency;
+
+  if ( step == 0 || stopFrequency < startFrequency ) return 0;
+
+
+  for (uint16_t frequency = startFrequency; frequency <= stopFrequency; frequency += step) {
+    uint32_t start;
+
+    this->rxTuneChannel(frequency);
+
+    start = millis();
+    delay(QN8066_SURVEY_MIN_SETTLE);    // RXAGCSET still shows the previous channel right after the tuning
+    do {
+      this->getRegisters(QN_SNR, data, 8);
+      s1.raw = data[7];
+    } while ( !s1.arg.RXAGCSET && millis() - start < QN8066_SURVEY_MAX_SETTLE );
+
+    rssi[count] = data[1];
+    if ( snr != NULL ) snr[count] = data[0];
+    count++;
+  }
+
+  this->setRxFrequency(home);
+  return count;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Ranks the vacant channels of a survey
+ * @details The score of a channel is its RSSI plus half of the RSSI of the strongest neighbour (adjacent channel 
+ * @details interference). The lower the score, the better the channel for a transmitter.
+ * @param rssi - spectrum returned by surveyBand
+ * @param count - number of channels of the spectrum
+ * @param startFrequency - frequency of rssi[0] (MHz x 10)
+ * @param step - step used by surveyBand (100 kHz units)
+ * @param best - returns the best frequencies (MHz x 10), best first. They can be used directly by setTX.
+ * @param size - number of frequencies wanted
+ * @return number of frequencies returned in best
+ */
+uint8_t QN8066::surveyBestChannels(const uint8_t *rssi, uint16_t count, uint16_t startFrequency, uint8_t step, uint16_t *best, uint8_t size) {
+  uint8_t found = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t value = surveyScore(rssi, count, i);
+
+    // Insertion in the ranked list (best first)
+    uint8_t j = found;
+    if ( j == size ) {
+      if ( size == 0 || value >= surveyScore(rssi, count, (best[size - 1] - startFrequency) / step) ) continue;
+      j--;
+    } else {
+      found++;
+    }
+    for ( ; j > 0 && surveyScore(rssi, count, (best[j - 1] - startFrequency) / step) > value; j--) best[j] = best[j - 1];
+    best[j] = startFrequency + i * step;
+  }
+  return found;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Score of a channel of the survey (RSSI plus half of the RSSI of the strongest neighbour)
+ */
+uint16_t QN8066::surveyScore(const uint8_t *rssi, uint16_t count, uint16_t index) {
+  uint8_t neighbour = 0;
+
+  if ( index > 0 ) neighbour = rssi[index - 1];
+  if ( index + 1 < count && rssi[index + 1] > neighbour ) neighbour = rssi[index + 1];
+  return rssi[index] + (neighbour >> 1);
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Finds the quietest channel of a range (100 kHz step)
+ * @details The range is measured by surveyBand in blocks of QN8066_SURVEY_CHUNK channels, so no large buffer is needed. 
+ * @details Each block also measures the neighbours of its first and last channels, so the score is the same as surveyBestChannels.
+ * @param startFrequency - first frequency (MHz x 10)
+ * @param stopFrequency - last frequency (MHz x 10)
+ * @return quietest frequency (MHz x 10)
+ */
+uint16_t QN8066::surveyQuietest(uint16_t startFrequency, uint16_t stopFrequency) {
+  uint8_t rssi[QN8066_SURVEY_CHUNK + 2];
+  uint16_t best = startFrequency;
+  uint16_t bestScore = 0xFFFF;
+
+  for (uint16_t first = startFrequency; first <= stopFrequency; first += QN8066_SURVEY_CHUNK) {
+    uint16_t last = (stopFrequency - first < QN8066_SURVEY_CHUNK) ? stopFrequency : first + QN8066_SURVEY_CHUNK - 1;
+    uint16_t from = (first > startFrequency) ? first - 1 : first;
+    uint16_t to = (last < stopFrequency) ? last + 1 : last;
+    uint16_t count = this->surveyBand(from, to, 1, rssi);
+
+    for (uint16_t frequency = first; frequency <= last; frequency++) {
+      uint16_t score = surveyScore(rssi, count, frequency - from);
+      if ( score < bestScore ) {
+        bestScore = score;
+        best = frequency;
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Measures another frequency in a short mute window and tunes back (AF check)
+ * @details The audio is muted, the frequency is tuned with the minimal registers (see rxTuneChannel), SNR, RSSI and 
+ * @details STATUS1 are read until the AGC is settled (up to maxSettle ms) and the current frequency is tuned back. 
+ * @details The delay after each I2C command (QN8066_DELAY_COMMAND) is longer than QN8066_SURVEY_MIN_SETTLE, so no other 
+ * @details wait is added. The mute time is the AGC wait plus 5 I2C transactions (mute, tune, last read, tune back and unmute).
+ * @details The RDS decoder (QN8066RdsDecoder) drops the group being received, because it can be from the probed 
+ * @details frequency (see getRxTuneCount). The RDS data already decoded (PI, PS, RT etc) are kept.
+ * @param frequency - frequency to be measured (MHz x 10)
+ * @param rssi - returns the RSSI of the frequency
+ * @param snr - returns the SNR of the frequency
+ * @param maxSettle - maximum time in ms waiting for the AGC (bounds the mute time)
+ * @return mute time in microseconds (cost of the probe)
+ * @see QN8066AFFollower
+ */
+uint32_t QN8066::probeRxFrequency(uint16_t frequency, uint8_t *rssi, uint8_t *snr, uint8_t maxSettle) {
+  qn8066_status1 s1;
+  uint8_t data[8];      // SNR, RSSISIG, CID1, CID2, XTAL_DIV0, XTAL_DIV1, XTAL_DIV2 and STATUS1
+  uint32_t start = micros();
+  uint32_t settle;
+
+  this->setAudioMuteRX(true);
+  this->rxTuneChannel(frequency);
+
+  settle = millis();
+  if ( QN8066_DELAY_COMMAND < QN8066_SURVEY_MIN_SETTLE * 1000 ) delay(QN8066_SURVEY_MIN_SETTLE);
+  do {
+    this->getRegisters(QN_SNR, data, 8);
+    s1.raw = data[7];
+  } while ( !s1.arg.RXAGCSET && millis() - settle < maxSettle );
+  *rssi = data[1];
+  *snr = data[0];
+
+  this->rxTuneChannel(this->rxCurrentFrequency);
+  if ( QN8066_DELAY_COMMAND < QN8066_SURVEY_MIN_SETTLE * 1000 ) delay(QN8066_SURVEY_MIN_SETTLE);
+  this->setAudioMuteRX(false);
+  return micros() - start;
+}
+
+/**
+ * @ingroup group03 RX
+ * @brief   Writes the channel scan range (CH_START, CH_STOP and CH_STEP) in one I2C transaction
+ * @param startFrequency - initial frequency (MHz x 10).
+ * @param stopFrequency - final frequency (MHz x 10).
+ * @param frequencyStep  - 0 = 50KHz; 1 = 100KHz; 2 =  200KHz
+ */
+void QN8066::scanRxRange(uint16_t startFrequency, uint16_t stopFrequency, uint8_t frequencyStep) {
+
+  uint8_t data[3];
 
   int16_t auxFreq = (startFrequency - 600)  * 2;
-  start.CH_START =  0B0000000011111111 & auxFreq;
-  step.arg.CH_STA = auxFreq >> 8; 
+  this->ch_start.CH_START =  0B0000000011111111 & auxFreq;
+  this->ch_step.arg.CH_STA = auxFreq >> 8; 
 
-  auxFreq = (stopFrequyency - 600)  * 2;
-  stop.CH_STOP =  0B0000000011111111 & auxFreq;
-  step.arg.CH_STP = auxFreq >> 8;
+  auxFreq = (stopFrequency - 600)  * 2;
+  this->ch_stop.CH_STOP =  0B0000000011111111 & auxFreq;
+  this->ch_step.arg.CH_STP = auxFreq >> 8;
 
-  step.arg.CH_FSTEP =  frequencyStep; 
+  this->ch_step.arg.CH_FSTEP =  frequencyStep; 
 
-  this->setRegister(QN_CH_START,start.raw);
-  this->setRegister(QN_CH_STOP, stop.raw);
-  this->setRegister(QN_CH_STEP, step.raw);
-} 
+  data[0] = this->ch_start.raw;
+  data[1] = this->ch_stop.raw;
+  data[2] = this->ch_step.raw;
+  this->setRegisters(QN_CH_START, data, 3);
+}
 
 /** 
  * @defgroup group031 RX RDS Functions 
@@ -587,9 +1067,9 @@ void QN8066::scanRxStation(uint16_t startFrequency, uint16_t stopFrequyency, uin
 */
 
 /**
- * @defgroup group031 RX RDS Functions 
+ * @ingroup group031 RX RDS
  * @brief Enables RX RDS
- * @todo under construction...
+ * @details The groups are read and decoded by QN8066RdsDecoder.
  */
 void QN8066::rdsRxEnable(bool value) {
   this->system2.arg.rx_rdsen = value; 
@@ -597,37 +1077,57 @@ void QN8066::rdsRxEnable(bool value) {
 }
 
 /**
- * @defgroup group031 RX RDS Functions 
+ * @ingroup group031 RX RDS
  * @brief Gets the current Program Station 
- * @todo under construction...
+ * @deprecated Use QN8066RdsDecoder::getPS. The QN8066 class does not keep the RDS decoder state.
+ * @return NULL
  */
 char* QN8066::rdsRxGetPS(char *ps) {
-
-  return ps;
+  (void) ps;
+  return NULL;
 }
 
 /**
- * @defgroup group031 RX RDS Functions 
+ * @ingroup group031 RX RDS
  * @brief Gets the current Radio Text
- * @todo under construction...
+ * @deprecated Use QN8066RdsDecoder::getRT. The QN8066 class does not keep the RDS decoder state.
+ * @return NULL
  */
 char* QN8066::rdsRxGetRT(char *rt) {
-
-  return rt;
+  (void) rt;
+  return NULL;
 }
 
 /**
- * @defgroup group031 RX RDS Functions 
+ * @ingroup group031 RX RDS
  * @brief Gets the current Date and time 
- * @todo under construction...
+ * @deprecated Use QN8066RdsDecoder::getTime. The QN8066 class does not keep the RDS decoder state.
+ * @return NULL
  */
 char* QN8066::rdsRxGetTime(char *time) {
-  
-  return time;
+  (void) time;
+  return NULL;
 }
 
+/**
+ * @ingroup group031 RX RDS
+ * @brief Converts a Modified Julian Date to year, month and day (integer only)
+ * @details Inverse of calculateMJD (Fliegel - Van Flandern algorithm on the Julian Day Number).
+ */
+void QN8066::mjdToDate(int32_t mjd, uint16_t *year, uint8_t *month, uint8_t *day) {
+  int32_t l, n, i, j;
 
-
+  l = mjd + 2400001L + 68569L;
+  n = 4 * l / 146097L;
+  l = l - (146097L * n + 3) / 4;
+  i = 4000 * (l + 1) / 1461001L;
+  l = l - 1461 * i / 4 + 31;
+  j = 80 * l / 2447;
+  *day = l - 2447 * j / 80;
+  l = j / 11;
+  *month = j + 2 - 12 * l;
+  *year = 100 * (n - 49) + i + l;
+}
 
 
 /** 
@@ -673,6 +1173,7 @@ void QN8066::setTX(uint16_t frequency) {
   this->setRegister(QN_RDS, this->rds.raw);     // RDS => 00111100 => Line_in_en = 0; RDSFDEV = 60 (Decimal) 
   this->setRegister(QN_GPLT, this->gplt.raw);    // GPLT => 00111001 => Tx_sftclpth = 00 (12’d2051 - 3db back off from 0.5v); t1m_sel = 11 (Infinity); GAIN_TXPLT = 1001 (9% 75 kHz)
 
+  this->txCurrentFrequency = frequency;
   int16_t auxFreq = (frequency - 600)  * 2;
   this->int_ctrl.raw =  0B00100000 | auxFreq >> 8;
   this->setRegister(QN_INT_CTRL,this->int_ctrl.raw );
@@ -690,6 +1191,91 @@ void QN8066::setTX(uint16_t frequency) {
   delay(100);
 }
 
+/**
+ * @ingroup group04 Start TX
+ * @brief Sets the TX mode on a clear channel selected by the QN8066 (CCS)
+ * @details The QN8066 scans the range (CH_START, CH_STOP and CH_STEP) with CCS_CH_DIS = 0 and CHSC = 1, and selects 
+ * @details a channel with SNR below the threshold (SNR_CCA_TH in the CCA register). The channel selected is read back 
+ * @details from TXCH and the transmitter is then kept on it (CCS_CH_DIS = 1).
+ * @details If CCS does not finish in time (setSeekStepTimeout per channel) or selects a channel out of the range, the 
+ * @details channel is chosen by a software survey (surveyBand) in RX mode, and the transmitter is set on the quietest channel.
+ * @param rangeStart - first frequency of the range (MHz x 10)
+ * @param rangeStop - last frequency of the range (MHz x 10)
+ * @param snrThreshold - SNR_CCA_TH (0 to 63. Default 16). It is also used by the RX channel scan.
+ * @return frequency selected (MHz x 10)
+ * @details Example
+ * @code 
+ * #include <QN8066.h>
+ * QN8066 tx;
+ * void setup() {
+ *   Serial.begin(9600);
+ *   tx.setup();
+ *   uint16_t frequency = tx.setTXAuto(880, 1080);
+ *   Serial.print(frequency);
+ *   Serial.print((tx.getTXAutoMethod() == QN8066_TX_AUTO_CCS) ? " selected by CCS in " : " selected by survey in ");
+ *   Serial.print(tx.getTXAutoTime());
+ *   Serial.println(" ms");
+ * }
+ * @endcode 
+ * @see setTX, surveyBand
+ */
+uint16_t QN8066::setTXAuto(uint16_t rangeStart, uint16_t rangeStop, uint8_t snrThreshold) {
+  qn8066_system1 s1;
+  uint32_t start = millis();
+  uint32_t deadline;
+  uint16_t frequency = 0;
+
+  this->cca.arg.SNR_CCA_TH = snrThreshold;
+  this->setTX(rangeStart);
+
+  this->scanRxRange(rangeStart, rangeStop, 1);   // CH_START, CH_STOP and CH_STEP are used by CCA (RX) and CCS (TX)
+  deadline = millis() + (uint32_t) ((rangeStop - rangeStart) * 2 + 1) * this->seekStepTimeout + 20;
+  this->system1.raw = 0B00001101; // txreq = 1; chsc = 1; ccs_ch_dis = 0 (TX_CH decided by the CCS); cca_ch_dis = 1
+  this->setRegister(QN_SYSTEM1, this->system1.raw);
+
+  do {
+    delay(2);
+    s1.raw = this->getRegister(QN_SYSTEM1);
+  } while ( s1.arg.chsc && (int32_t) (millis() - deadline) < 0 );
+
+  if ( !s1.arg.chsc ) {
+    uint16_t channel = this->getRegister(QN_TXCH) | ((this->getRegister(QN_INT_CTRL) & 0B11) << 8);
+    frequency = 600 + channel / 2;
+    if ( frequency < rangeStart || frequency > rangeStop ) frequency = 0;
+  }
+
+  this->system1.raw = 0B00001011; // txreq = 1; ccs_ch_dis = 1; cca_ch_dis = 1 (it also stops the CCS if it timed out)
+  this->setRegister(QN_SYSTEM1, this->system1.raw);
+
+  if ( frequency != 0 ) {
+    this->setTxChannel(frequency);
+    this->txAutoMethod = QN8066_TX_AUTO_CCS;
+  } else {
+    // CCS failed: software survey in RX mode
+    this->setRX(rangeStart);
+    frequency = this->surveyQuietest(rangeStart, rangeStop);
+    this->setTX(frequency);
+    this->txAutoMethod = QN8066_TX_AUTO_SURVEY;
+  }
+
+  this->txAutoTime = millis() - start;
+  return frequency;
+}
+
+/**
+ * @ingroup group04 Start TX
+ * @brief Changes the transmitter channel (TXCH) without resetting the QN8066
+ * @param frequency - frequency (MHz x 10)
+ */
+void QN8066::setTxChannel(uint16_t frequency) {
+  uint16_t channel = (frequency - 600) * 2;
+
+  this->txCurrentFrequency = frequency;
+  this->int_ctrl.arg.TXCH = channel >> 8;
+  this->setRegister(QN_INT_CTRL, this->int_ctrl.raw);
+  this->setRegister(QN_TXCH, channel & 0xFF);
+}
+
 
 /**
  * @ingroup group02 Init Device
@@ -1742,10 +2328,63 @@ void QN8066::rdsClearBuffer() {
 
 };
 
+/**
+ * @ingroup group05 TX RDS
+ * @brief Loads a RDS group (four blocks) into the QN8066 and toggles RDSRDY
+ * @details The 8 bytes (TX_RDSD0 to TX_RDSD7) are written in one I2C transaction, so the chip never fetches a group 
+ * @details with blocks of two different groups. It does not wait for the chip to fetch the group. See rdsSendGroup.
+ * @param block1 - RDS_BLOCK1 datatype
+ * @param block2 - RDS_BLOCK2 datatype
+ * @param block3 - RDS_BLOCK3 datatype
+ * @param block4 - RDS_BLOCK4 datatype
+ * @param toggle - false = only replaces the data of the group already loaded (RDSRDY is not toggled again)
+ */
+void QN8066::rdsLoadGroup(RDS_BLOCK1 block1, RDS_BLOCK2 block2, RDS_BLOCK3 block3, RDS_BLOCK4 block4, bool toggle) {
+  uint8_t data[8];
+
+  data[0] = block1.byteContent[1]; // Most Significant Byte First.
+  data[1] = block1.byteContent[0];
+  data[2] = block2.byteContent[1];
+  data[3] = block2.byteContent[0];
+  data[4] = block3.byteContent[1]; // First character first 
+  data[5] = block3.byteContent[0];
+  data[6] = block4.byteContent[1];
+  data[7] = block4.byteContent[0];
+  this->setRegisters(QN_TX_RDSD0, data, 8);
+
+  // It should not be here. Judiging by the data sheet, the use must  
+  // wait for the RDS_TXUPD before toggling the RDSRDY bit in the SYSTEM2 register. 
+  if ( toggle ) this->rdsSetTxToggle(); 
+
+  if ( this->rdsMonitor != NULL ) this->rdsMonitor(block1.pi, block2.raw, block3.raw, block4.raw);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Loads a RDS group (RDS_GROUP) into the QN8066 and toggles RDSRDY
+ * @details Block 1 is the current PI code. 
+ * @param group - blocks 2, 3 and 4
+ * @param toggle - false = only replaces the data of the group already loaded
+ */
+void QN8066::rdsLoadGroup(const RDS_GROUP *group, bool toggle) {
+  RDS_BLOCK1 block1;
+  RDS_BLOCK2 block2;
+  RDS_BLOCK3 block3;
+  RDS_BLOCK4 block4;
+
+  block1.pi = this->rdsPI;
+  block2.raw = group->blockB;
+  block3.raw = group->blockC;
+  block4.raw = group->blockD;
+  this->rdsLoadGroup(block1, block2, block3, block4, toggle);
+}
+
 /**
  * @ingroup group05 TX RDS
  * @brief Sends a RDS group (four blocks)  to the QN8066
  * @details Each block is packaged in 16 bits word (two bytes)
+ * @details If a calibration interval was set (see rdsSetCalibrationInterval), a short rdsCalibrate is done when it expires.
+ * @details The statistics are updated only if a qn8066_rds_stats was given to rdsSetStats.
  * @param block1 - RDS_BLOCK1 datatype
  * @param block2 - RDS_BLOCK2 datatype
  * @param block3 - RDS_BLOCK3 datatype
@@ -1753,53 +2392,315 @@ void QN8066::rdsClearBuffer() {
  */
 void QN8066::rdsSendGroup(RDS_BLOCK1 block1, RDS_BLOCK2 block2, RDS_BLOCK3 block3, RDS_BLOCK4 block4) {
 
+  qn8066_rds_calibration *c = this->rdsCalibrationInfo;
+  qn8066_rds_stats *s = this->rdsStats;
+
+  if ( c != NULL && c->interval && (millis() - c->lastCalibration) >= c->interval )
+    this->rdsCalibrate(4);
+
   uint8_t toggle  = this->rdsGetTxUpdated(); 
   uint8_t count = 0;
+  uint32_t start, latency;
+  uint32_t period = (c != NULL && c->groupPeriod) ? c->groupPeriod : 87600UL;
 
   this->rdsSendError = 0;
 
-  this->setRegister(QN_TX_RDSD0, block1.byteContent[1]); // Most Significant Byte First.
-  this->setRegister(QN_TX_RDSD1, block1.byteContent[0]);
+  start = micros();
+  this->rdsLoadGroup(block1, block2, block3, block4);
 
-  this->setRegister(QN_TX_RDSD2, block2.byteContent[1]); // Most Significant Byte First.
-  this->setRegister(QN_TX_RDSD3, block2.byteContent[0]);
-  
-  this->setRegister(QN_TX_RDSD4, block3.byteContent[1]); // First character first 
-  this->setRegister(QN_TX_RDSD5, block3.byteContent[0]);
-  
-  this->setRegister(QN_TX_RDSD6, block4.byteContent[1]);
-  this->setRegister(QN_TX_RDSD7, block4.byteContent[0]);
+  // The chip fetched the previous group more than one group period ago. So, it had nothing new to transmit.
+  if ( s != NULL && s->lastFetch && (micros() - s->lastFetch) > period )
+    s->underruns++;
 
-  // It should not be here. Judiging by the data sheet, the use must  
-  // wait for the RDS_TXUPD before toggling the RDSRDY bit in the SYSTEM2 register. 
-  this->rdsSetTxToggle(); 
-  delay(this->rdsSyncTime); // This time is very critical and may need to be tuned. Check the function/method rdsSetSyncTime 
+  delay(this->rdsSyncTime); // This time is very critical and may need to be tuned. Check the function/method rdsSetSyncTime or rdsCalibrate
   // checks for the RDS_TXUPD . 
   while ( this->rdsGetTxUpdated() == toggle  && count < 10) { 
     delay(1);
     count++;
   }
-  if (count >= 10 ) 
+  if (count >= 10 ) { 
     this->rdsSendError = 1;
+    if ( s != NULL ) s->timeouts++;
+    return;
+  }
+
+  if ( s == NULL ) return;
+  s->lastFetch = micros();
+  latency = s->lastFetch - start;
+  if ( latency > s->maxLatency ) s->maxLatency = latency;
+  if ( s->total == 0 )
+    s->meanLatency = latency;
+  else
+    s->meanLatency = s->meanLatency - (s->meanLatency >> 4) + (latency >> 4);
+  s->groups[block2.commonFields.groupType]++;
+  s->total++;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends a RDS group (RDS_GROUP) and waits for the QN8066 to fetch it
+ * @param group - blocks 2, 3 and 4 (block 1 is the current PI code)
+ */
+void QN8066::rdsSendGroup(const RDS_GROUP *group) {
+  RDS_BLOCK1 block1;
+  RDS_BLOCK2 block2;
+  RDS_BLOCK3 block3;
+  RDS_BLOCK4 block4;
+
+  block1.pi = this->rdsPI;
+  block2.raw = group->blockB;
+  block3.raw = group->blockC;
+  block4.raw = group->blockD;
+  this->rdsSendGroup(block1, block2, block3, block4);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Measures the RDS TX timing and sets the wait time (rdsSyncTime) to the minimum safe value
+ * @details The value of rdsSyncTime depends on the MCU and on the I2C bus speed. Instead of finding it by trial and error, 
+ * @details this function sends a burst of filler groups (0B groups with the current station name) back to back and 
+ * @details timestamps (micros()) each RDS_TXUPD toggle. Since a new group is always loaded right after the chip fetches the 
+ * @details previous one, the interval between two toggles is the real time the QN8066 takes to consume a group (about 87.6 ms).  
+ * @details The time spent to load a group (8 registers and the RDSRDY toggle) is the host overhead. 
+ * @details The wait time is then: group period - host overhead - cost of one RDS_TXUPD reading. 
+ * @details If a qn8066_rds_calibration was given to rdsSetCalibration, every call also updates it (drift statistics). 
+ * @param groups - number of filler groups to send (minimum 3; default 8).
+ * @return the new wait time in ms. If the chip does not respond, rdsSyncTime is not changed and rdsGetError returns 1.
+ * @details Example
+ * @code 
+ * #include <QN8066.h>
+ * QN8066 tx;
+ * qn8066_rds_calibration cal;
+ * void setup() {
+ *   tx.setup();
+ *   tx.setTX(1069); // Set the transmitter to 106.9 MHz 
+ *   tx.rdsTxEnable(true);
+ *   tx.rdsInitTx(0x8,0x1,0x9B);
+ *   tx.rdsSetCalibration(&cal);            // Optional: keeps the results and allows the runtime re-calibration
+ *   tx.rdsCalibrate();                     // Finds the best rdsSyncTime for your MCU 
+ *   tx.rdsSetCalibrationInterval(600000);  // Checks it again every 10 minutes
+ * }
+ *
+ * void loop() {
+ *   tx.rdsSendPS("STATIONX");
+ * }
+ * @endcode  
+ * @see rdsSetSyncTime, rdsGetSyncTime, rdsGetCalibration, rdsSetCalibrationInterval
+ */
+uint8_t QN8066::rdsCalibrate(uint8_t groups) {
+
+  RDS_BLOCK1 b1;
+  RDS_BLOCK2 b2;
+  RDS_BLOCK3 b3;
+  RDS_BLOCK4 b4;
+
+  uint32_t start, now, lastToggle = 0;
+  uint32_t period = 0, overhead = 0, pollCost;
+  uint8_t toggle, seg;
+
+  if ( groups < 3 ) groups = 3;
+
+  b1.pi = this->rdsPI;
+  b2.raw = 0;
+  b2.group0Field.programType = this->rdsPTY;
+  b2.group0Field.trafficProgramCode = this->rdsTP;
+  b2.group0Field.TA = this->rdsTA;
+  b2.group0Field.versionCode = 1; // 0B - Station Name
+  b3.raw = b1.pi;
+
+  start = micros();
+  toggle = this->rdsGetTxUpdated();
+  pollCost = micros() - start;
+
+  this->rdsSendError = 0;
+
+  for (uint8_t i = 0; i < groups; i++) {
+    seg = i & 3;
+    b2.group0Field.address = seg;
+    b4.byteContent[1] = this->rdsStationName[seg * 2];
+    b4.byteContent[0] = this->rdsStationName[seg * 2 + 1];
+
+    start = micros();
+    this->rdsLoadGroup(b1, b2, b3, b4);
+    overhead += micros() - start;
+
+    // Waits for the chip to fetch the group (more than two group periods means the chip is not working)
+    while ( this->rdsGetTxUpdated() == toggle ) {
+      if ( (micros() - start) > 250000UL ) {
+        this->rdsSendError = 1;
+        // A failed attempt also restarts the calibration interval, so rdsSendGroup does not block on every group
+        if ( this->rdsCalibrationInfo != NULL ) this->rdsCalibrationInfo->lastCalibration = millis();
+        return this->rdsSyncTime;
+      }
+    }
+    now = micros();
+    toggle = !toggle;
+    // The first toggle is not used. The chip may be in the middle of a group when the burst starts.
+    if ( i > 0 ) period += now - lastToggle;
+    lastToggle = now;
+  }
+
+  if ( this->rdsStats != NULL ) this->rdsStats->lastFetch = lastToggle;
+  period /= (groups - 1);
+  overhead /= groups;
+
+  qn8066_rds_calibration *c = this->rdsCalibrationInfo;
+  if ( c != NULL ) {
+    c->groupPeriod = period;
+    c->writeOverhead = overhead;
+    c->pollCost = pollCost;
+    if ( c->count == 0 ) {
+      c->firstPeriod = c->minPeriod = c->maxPeriod = period;
+    } else {
+      if ( period < c->minPeriod ) c->minPeriod = period;
+      if ( period > c->maxPeriod ) c->maxPeriod = period;
+    }
+    c->drift = (int32_t) period - (int32_t) c->firstPeriod;
+    c->lastCalibration = millis();
+    c->count++;
+  }
+
+  // Minimum safe wait: the chip fetches the next group one group period after the previous fetch.
+  // The host has already spent "overhead" loading the new group and needs "pollCost" to read RDS_TXUPD.
+  if ( period > (overhead + pollCost) ) {
+    uint32_t wait = (period - overhead - pollCost) / 1000;
+    this->rdsSyncTime = (wait > 255) ? 255 : wait;
+  } else {
+    this->rdsSyncTime = 0;
+  }
+
+  return this->rdsSyncTime;
+}
+
+/**
+ * @brief Unicode to RDS character set (EN 50067 Annex E, table E.1) conversion table
+ * @details Sorted by Unicode code point (binary search). ASCII characters are not here: they have the same code in 
+ * @details both sets, except '$', '^', '`' and '~' (see utf8ToEBU). Some common characters that are not in the RDS set (typographic 
+ * @details quotes, dashes, non-breaking space etc) are mapped to the closest character.
+ */
+typedef struct {
+  uint16_t unicode;
+  uint8_t ebu;
+} qn8066_ebu_char;
+
+static const qn8066_ebu_char ebuTable[] PROGMEM = {
+  {0x00A0, 0x20}, {0x00A1, 0x8E}, {0x00A3, 0xAA}, {0x00A4, 0x24}, {0x00A7, 0xBF}, {0x00A9, 0xA2},
+  {0x00AA, 0xA0}, {0x00AF, 0x7E}, {0x00B0, 0xBB}, {0x00B1, 0xB4}, {0x00B2, 0xB2}, {0x00B3, 0xB3},
+  {0x00B5, 0xB8}, {0x00B9, 0xB1}, {0x00BA, 0xB0}, {0x00BC, 0xBC}, {0x00BD, 0xBD}, {0x00BE, 0xBE},
+  {0x00BF, 0xB9}, {0x00C0, 0xC1}, {0x00C1, 0xC0}, {0x00C2, 0xD0}, {0x00C3, 0xE0}, {0x00C4, 0xD1},
+  {0x00C5, 0xE1}, {0x00C6, 0xE2}, {0x00C7, 0x8B}, {0x00C8, 0xC3}, {0x00C9, 0xC2}, {0x00CA, 0xD2},
+  {0x00CB, 0xD3}, {0x00CC, 0xC5}, {0x00CD, 0xC4}, {0x00CE, 0xD4}, {0x00CF, 0xD5}, {0x00D0, 0xCE},
+  {0x00D1, 0x8A}, {0x00D2, 0xC7}, {0x00D3, 0xC6}, {0x00D4, 0xD6}, {0x00D5, 0xE6}, {0x00D6, 0xD7},
+  {0x00D8, 0xE7}, {0x00D9, 0xC9}, {0x00DA, 0xC8}, {0x00DB, 0xD8}, {0x00DC, 0xD9}, {0x00DD, 0xE5},
+  {0x00DE, 0xE8}, {0x00DF, 0x8D}, {0x00E0, 0x81}, {0x00E1, 0x80}, {0x00E2, 0x90}, {0x00E3, 0xF0},
+  {0x00E4, 0x91}, {0x00E5, 0xF1}, {0x00E6, 0xF2}, {0x00E7, 0x9B}, {0x00E8, 0x83}, {0x00E9, 0x82},
+  {0x00EA, 0x92}, {0x00EB, 0x93}, {0x00EC, 0x85}, {0x00ED, 0x84}, {0x00EE, 0x94}, {0x00EF, 0x95},
+  {0x00F0, 0xEF}, {0x00F1, 0x9A}, {0x00F2, 0x87}, {0x00F3, 0x86}, {0x00F4, 0x96}, {0x00F5, 0xF6},
+  {0x00F6, 0x97}, {0x00F7, 0xBA}, {0x00F8, 0xF7}, {0x00F9, 0x89}, {0x00FA, 0x88}, {0x00FB, 0x98},
+  {0x00FC, 0x99}, {0x00FD, 0xF5}, {0x00FE, 0xF8}, {0x0106, 0xEB}, {0x0107, 0xFB}, {0x010C, 0xCB},
+  {0x010D, 0xDB}, {0x0110, 0xCE}, {0x0111, 0xDE}, {0x011B, 0xA5}, {0x011E, 0xA4}, {0x011F, 0x9D},
+  {0x0130, 0xB5}, {0x0131, 0x9E}, {0x0132, 0x8F}, {0x0133, 0x9F}, {0x013F, 0xCF}, {0x0140, 0xDF},
+  {0x0144, 0xB6}, {0x0148, 0xA6}, {0x014A, 0xE9}, {0x014B, 0xF9}, {0x0151, 0xA7}, {0x0152, 0xE3},
+  {0x0153, 0xF3}, {0x0154, 0xEA}, {0x0155, 0xFA}, {0x0158, 0xCA}, {0x0159, 0xDA}, {0x015A, 0xEC},
+  {0x015B, 0xFC}, {0x015E, 0x8C}, {0x015F, 0x9C}, {0x0160, 0xCC}, {0x0161, 0xDC}, {0x0166, 0xEE},
+  {0x0167, 0xFE}, {0x0171, 0xB7}, {0x0175, 0xF4}, {0x0177, 0xE4}, {0x0179, 0xED}, {0x017A, 0xFD},
+  {0x017D, 0xCD}, {0x017E, 0xDD}, {0x03B1, 0xA1}, {0x03B2, 0x8D}, {0x03C0, 0xA8}, {0x2013, 0x2D},
+  {0x2014, 0x2D}, {0x2015, 0x5E}, {0x2016, 0x60}, {0x2018, 0x27}, {0x2019, 0x27}, {0x201C, 0x22},
+  {0x201D, 0x22}, {0x2026, 0x2E}, {0x2030, 0xA3}, {0x20AC, 0xA9}, {0x2190, 0xAC}, {0x2191, 0xAD},
+  {0x2192, 0xAE}, {0x2193, 0xAF}
+};
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Converts the next UTF-8 character of a text to the RDS character set (EN 50067 Annex E)
+ * @details The character is found by a binary search on a table stored in the flash memory. The characters that 
+ * @details are not in the RDS character set are converted to RDS_EBU_UNKNOWN ('?'). A byte that does not start a 
+ * @details valid UTF-8 sequence is returned as it is, so texts already coded in the RDS character set still work.
+ * @param text - pointer to the current position of the text. It is moved to the next character (but not beyond the '\0').
+ * @return RDS character ('\0' at the end of the text)
+ * @details Example
+ * @code 
+ * const char *p = "CAFÉ";
+ * char ps[8];
+ * uint8_t n = 0;
+ * while ( *p ) ps[n++] = QN8066::utf8ToEBU(&p);   // 'C', 'A', 'F', 0xC2
+ * @endcode  
+ * @see rdsSetUTF8, rdsSetStationName, rdsSendRTMessage
+ */
+uint8_t QN8066::utf8ToEBU(const char **text) {
+  const uint8_t *p = (const uint8_t *) *text;
+  uint16_t code;
+  uint8_t size, low, high, middle;
+
+  if ( *p < 0x80 ) {
+    if ( *p != '\0' ) (*text)++;
+    switch ( *p ) {            // ASCII codes with another glyph in the RDS character set
+      case '$': return 0xAB;   // 0x24 is the currency sign
+      case '`': return 0x27;   // 0x60 is the double vertical line
+      case '^':                // 0x5E is the horizontal bar
+      case '~': return RDS_EBU_UNKNOWN;   // 0x7E is the overline
+    }
+    return *p;
+  }
+
+  // Sequence size from the leading byte: 110xxxxx = 2; 1110xxxx = 3 and 11110xxx = 4 bytes
+  size = ( *p >= 0xF0 ) ? 4 : ( *p >= 0xE0 ) ? 3 : ( *p >= 0xC0 ) ? 2 : 0;
+  for ( uint8_t i = 1; i < size; i++ ) {
+    if ( (p[i] & 0xC0) != 0x80 ) size = 0;   // Not UTF-8
+  }
+  if ( size == 0 || size == 4 ) {
+    (*text) += ( size ) ? size : 1;
+    return ( size ) ? RDS_EBU_UNKNOWN : *p;  // Out of the table range or raw RDS character
+  }
+
+  code = p[0] & (0x3F >> (size - 1));
+  for ( uint8_t i = 1; i < size; i++ ) code = (code << 6) | (p[i] & 0x3F);
+  (*text) += size;
+
+  low = 0;
+  high = sizeof(ebuTable) / sizeof(qn8066_ebu_char);
+  while ( low < high ) {
+    middle = (low + high) / 2;
+    uint16_t u = pgm_read_word(&ebuTable[middle].unicode);
+    if ( u == code ) return pgm_read_byte(&ebuTable[middle].ebu);
+    if ( u < code ) low = middle + 1; else high = middle;
+  }
+  return RDS_EBU_UNKNOWN;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Gets the next character of a text in the RDS character set
+ * @details Converts it from UTF-8 unless rdsSetUTF8(false) was called. 
+ * @param text - pointer to the current position of the text. It is moved to the next character.
+ */
+char QN8066::rdsNextChar(const char **text) {
+  if ( this->rdsUTF8 ) return (char) utf8ToEBU(text);
+  return *(*text)++;
 }
 
 /**
  * @ingroup group05 TX RDS
  * @brief Sets the station name 
- * 
+ * @details Names shorter than 8 characters are completed with spaces.
+ * @details The name is converted from UTF-8 to the RDS character set here (see rdsSetUTF8).
  * @param stationName 
  */
 void QN8066::rdsSetStationName(char *stationName) { 
-  strncpy(this->rdsStationName,stationName,8);
-  rdsStationName[8] = '\0';
+  const char *text = stationName;
+  uint8_t i = 0;
+  while ( i < 8 && *text != '\0' ) this->rdsStationName[i++] = this->rdsNextChar(&text);
+  while ( i < 8 ) this->rdsStationName[i++] = ' ';
+  this->rdsStationName[8] = '\0';
 }
 
 /**
  * @ingroup group05 TX RDS
  * @brief Sends the Program Service Message
  * @details Like rdsSendPS this method sends the Station Name or other 8 char message.
- * @details This function repeats sending a group this->rdsRepeatGroup times.
- * @param ps - String with the name of Station or message limeted to 8 character.
+ * @details This function repeats sending a group this->rdsRepeatGroup times. The group 0B is used.
+ * @details To send the AF list (group 0A), see QN8066RdsEncoder::setAF and QN8066RdsEncoder::sendPS.
+ * @param ps - String with the name of Station or message limeted to 8 character. If NULL, the current station name (see rdsSetStationName) is sent.
  * @details Example
  * @code 
  * #include <QN8066.h>
@@ -1818,25 +2719,21 @@ void QN8066::rdsSetStationName(char *stationName) {
  */
 void QN8066::rdsSendPS(char* ps) {
 
-  RDS_BLOCK1 b1;
+  RDS_GROUP group;
   RDS_BLOCK2 b2;
-  RDS_BLOCK3 b3;
-  RDS_BLOCK4 b4;
-
-  this->rdsSetStationName(ps);
 
-  b1.pi = this->rdsPI;
+  if ( ps != NULL ) this->rdsSetStationName(ps);
+  ps = this->rdsStationName;
 
   b2.raw = 0; // Starts block2
-  b2.group0Field.address = 0;
-  b2.group0Field.DI = 0;
-  b2.group0Field.MS = 0;
-  b2.group0Field.TA = 0;
+  b2.group0Field.MS = this->rdsMS;
+  b2.group0Field.TA = this->rdsTA;
   b2.group0Field.programType = this->rdsPTY;
   b2.group0Field.trafficProgramCode = this->rdsTP;  
   b2.group0Field.versionCode = 1; // 0B - Station Name
   b2.group0Field.groupType = 0;  
-  b3.raw = b1.pi;
+  group.blockC = this->rdsPI;
+
   // Sending the packet only once did not work for some types of receivers with RDS support. 
   // Therefore, through trial and error, transmitting the same RT message three or more times
   // made  this function works. 
@@ -1844,12 +2741,16 @@ void QN8066::rdsSendPS(char* ps) {
   // sync so that receivers can correctly piece together the parts of the text and display 
   // them to the listener without interruptions.
   for ( uint8_t k  = 0; k < this->rdsRepeatGroup; k++) { 
-    for (uint8_t i = 0; i < 8; i+=2) { 
-      b4.byteContent[1] = ps[i]; 
-      b4.byteContent[0] = ps[i+1];
-      this->rdsSendGroup(b1, b2, b3, b4);
-      b2.group0Field.address++; 
+    uint8_t errors = 0;
+    for (uint8_t i = 0; i < 4; i++) { 
+      b2.group0Field.address = i;
+      b2.group0Field.DI = (this->rdsDI >> (3 - i)) & 1;  // Segment 0 => d3 ... segment 3 => d0
+      group.blockB = b2.raw;
+      group.blockD = ((uint16_t) ps[i * 2] << 8) | (uint8_t) ps[i * 2 + 1];
+      this->rdsSendGroup(&group);
+      errors += this->rdsSendError;
     }
+    if ( errors == 0 && this->rdsStats != NULL ) this->rdsStats->lastPSCycle = millis();
   } 
 
 }
@@ -1857,8 +2758,12 @@ void QN8066::rdsSendPS(char* ps) {
 /**
  * @ingroup group05 TX RDS
  * @brief Sends RDS Radio Text Message (group 2A)
- * @details This function repeats sending a group this->rdsRepeatGroup times.
- * @param rt - Radio Text (string of 32 character)
+ * @details Up to 64 characters. This function repeats sending a group this->rdsRepeatGroup times.
+ * @details The text ends at the first '\0' or '\r'. If it is shorter than 64 characters, it is terminated by '\r'.
+ * @details The Text A/B flag is toggled only when the message changes. 
+ * @details The QN8066 class does not keep a copy of the text. To send RT+ or to send only the segments that changed, 
+ * @details see QN8066RdsEncoder::setRTMessage.
+ * @param rt - Radio Text (string up to 64 character). NULL is rejected: nothing is sent, since there is no copy of the last text.
  * @details Example
  * @code 
  * #include <QN8066.h>
@@ -1874,26 +2779,66 @@ void QN8066::rdsSendPS(char* ps) {
  * void loop() {
  * }
  * @endcode  
+ * @see rdsSendRTMessageB, rdsSendERTMessage
  */
 void QN8066::rdsSendRTMessage(char *rt) {
-
+    if ( rt == NULL ) return;
     // Flushes any previus data
     this->rdsSetTxToggle();
+    this->rdsSendRTText(rt, 0);
+}
 
-    int textLen = strlen(rt);
-    int numGroups = (textLen + 3) / 4; // Each group can contain 4 characters
-    RDS_BLOCK1 block1;
-    block1.pi = this->rdsPI;
-    static bool toggle = false;
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends RDS Radio Text Message (group 2B)
+ * @details Up to 32 characters. In the group 2B, block 3 repeats the PI and block 4 carries two characters. 
+ * @details This function repeats sending a group this->rdsRepeatGroup times.
+ * @details The version 2B is applied to each text sent: the Text A/B flag is toggled when the text or the version changes.
+ * @details NULL is rejected (nothing is sent), since the QN8066 class does not keep the last text. To send the current
+ * @details text again as 2B, use QN8066RdsEncoder::setRTMessage(NULL, 1).
+ * @param rt - Radio Text (string up to 32 character).
+ * @see rdsSendRTMessage
+ */
+void QN8066::rdsSendRTMessageB(char *rt) {
+    if ( rt == NULL ) return;
+    this->rdsSetTxToggle();
+    this->rdsSendRTText(rt, 1);
+}
 
-    toggle = !toggle;
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends a Radio Text (group 2A or 2B) without keeping a copy of it
+ * @details The text is read twice: once to find its length and to check if it changed (the Text A/B flag is toggled 
+ * @details when the hash of the text changes) and once per repetition, converting the characters as they are sent.
+ * @param rt - Radio Text (not NULL)
+ * @param version - 0 = 2A (64 characters); 1 = 2B (32 characters)
+ */
+void QN8066::rdsSendRTText(const char *rt, uint8_t version) {
+    RDS_GROUP group;
+    RDS_BLOCK2 block2;
+    const char *p = rt;
+    uint8_t maxLen = (version) ? 32 : 64;
+    uint8_t segSize = (version) ? 2 : 4;
+    uint8_t len = 0, segments, pos;
+    uint16_t hash = version;
+    uint8_t c[4];
+
+    while ( len < maxLen && *p != '\0' && *p != '\r' ) {
+      hash = hash * 31 + (uint8_t) this->rdsNextChar(&p);
+      len++;
+    }
+    if ( hash != this->rdsRTHash ) {
+      this->rdsTextAB = !this->rdsTextAB;  // New message
+      this->rdsRTHash = hash;
+    }
+    // The segment with the '\r' terminator is also sent
+    segments = (len < maxLen) ? (len / segSize + 1) : (maxLen / segSize);
 
-    RDS_BLOCK2 block2; 
     block2.raw = 0;
-    block2.group2Field.textABFlag = toggle;
+    block2.group2Field.textABFlag = this->rdsTextAB;
     block2.group2Field.programType = this->rdsPTY;
     block2.group2Field.trafficProgramCode = this->rdsTP;
-    block2.group2Field.versionCode = 0; // Version A
+    block2.group2Field.versionCode = version; // Version A or B
     block2.group2Field.groupType = 2;  // Group 2
 
     // Sending the packet only once did not work for some types of receivers with RDS support. 
@@ -1903,46 +2848,137 @@ void QN8066::rdsSendRTMessage(char *rt) {
     // sync so that receivers can correctly piece together the parts of the text and display 
     // them to the listener without interruptions.    
     for ( uint8_t k  = 0; k < this->rdsRepeatGroup; k++) { 
-      for (uint8_t i = 0; i < numGroups; i++) {
-          block2.group2Field.address = i; 
-          RDS_BLOCK3 block3; 
-          block3.byteContent[1] = rt[i * 4];
-          block3.byteContent[0] = rt[i * 4 + 1];
-          RDS_BLOCK4 block4;
-          block4.byteContent[1] = rt[i * 4 + 2];
-          block4.byteContent[0] = rt[i * 4 + 3]; 
-          this->rdsSendGroup(block1, block2, block3, block4);
+      p = rt;
+      pos = 0;
+      for (uint8_t i = 0; i < segments; i++) {
+        for (uint8_t j = 0; j < segSize; j++, pos++ ) 
+          c[j] = (pos < len) ? (uint8_t) this->rdsNextChar(&p) : ((pos == len) ? '\r' : ' ');
+        block2.group2Field.address = i;
+        group.blockB = block2.raw;
+        if ( version == 0 ) {
+          group.blockC = ((uint16_t) c[0] << 8) | c[1];
+          group.blockD = ((uint16_t) c[2] << 8) | c[3];
+        } else {
+          group.blockC = this->rdsPI;  // 2B - Block 3 repeats the PI
+          group.blockD = ((uint16_t) c[0] << 8) | c[1];
+        }
+        this->rdsSendGroup(&group);
       }
     }
 }
 
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends an Open Data Application (ODA) announcement (group 3A)
+ * @details The group 3A tells the receiver which group type carries the data of an ODA identified by its AID.
+ * @param groupType - group type used by the application (Example: 11 for 11A) 
+ * @param version - version of the group used by the application (0 = A; 1 = B)
+ * @param message - ODA message bits (block 3). It depends on the application.
+ * @param aid - Application Identification (block 4) 
+ * @see QN8066RdsEncoder::sendRTPlusAnnouncement, rdsSendERTMessage
+ */
+void QN8066::rdsSendODAAnnouncement(uint8_t groupType, uint8_t version, uint16_t message, uint16_t aid) {
+  RDS_GROUP group;
+
+  this->rdsBuildODAAnnouncement(groupType, version, message, aid, &group);
+  this->rdsSendGroup(&group);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds an Open Data Application (ODA) announcement (group 3A)
+ * @see rdsSendODAAnnouncement
+ */
+void QN8066::rdsBuildODAAnnouncement(uint8_t groupType, uint8_t version, uint16_t message, uint16_t aid, RDS_GROUP *group) {
+  RDS_BLOCK2 block2;
+
+  block2.raw = 0;
+  block2.commonFields.groupType = 3;
+  block2.commonFields.versionCode = 0;
+  block2.commonFields.programType = this->rdsPTY;
+  block2.commonFields.trafficProgramCode = this->rdsTP;
+  // Application group type code: 4 bits group type + 1 bit version 
+  block2.commonFields.textABFlag = (groupType >> 3) & 1;  
+  block2.commonFields.additionalData = ((groupType << 1) & 0B1110) | (version & 1);
+  group->blockB = block2.raw;
+  group->blockC = message;
+  group->blockD = aid;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends an Enhanced RadioText (eRT) message
+ * @details eRT is an ODA (AID 0x6552) that allows Radio Text in other languages and character sets. 
+ * @details This function sends the text encoded in UTF-8 (up to 128 bytes) using the group 12A. The ODA announcement (3A) 
+ * @details is sent first, then the text segments (4 bytes per group). If the text is shorter than 128 bytes, it is 
+ * @details terminated by 0x0D. The text is sent this->rdsRepeatGroup times and is not copied by the library.
+ * @param ert - UTF-8 text (up to 128 bytes)
+ * @details Example
+ * @code 
+ * tx.rdsSendERTMessage("Rádio São Paulo - Привет");
+ * @endcode  
+ * @see rdsSendRTMessage, rdsSendODAAnnouncement
+ */
+void QN8066::rdsSendERTMessage(const char *ert) {
+  RDS_BLOCK1 block1;
+  RDS_BLOCK2 block2;
+  RDS_BLOCK3 block3;
+  RDS_BLOCK4 block4;
+  uint8_t len = 0, segments, c[4];
+
+  while ( len < 128 && ert[len] != '\0' ) len++;
+  segments = (len < 128) ? (len / 4 + 1) : 32; // The segment with the 0x0D terminator is also sent
+
+  // 3A message bits: UTF-8 encoding; left to right text
+  this->rdsSendODAAnnouncement(QN8066_ERT_GROUP, 0, 0x0001, QN8066_ERT_AID);
+
+  block1.pi = this->rdsPI;
+  block2.raw = 0;
+  block2.commonFields.groupType = QN8066_ERT_GROUP;
+  block2.commonFields.versionCode = 0;
+  block2.commonFields.programType = this->rdsPTY;
+  block2.commonFields.trafficProgramCode = this->rdsTP;
+
+  for ( uint8_t k  = 0; k < this->rdsRepeatGroup; k++) { 
+    for ( uint8_t i = 0; i < segments; i++ ) {
+      for ( uint8_t j = 0; j < 4; j++ ) {
+        uint8_t pos = i * 4 + j;
+        c[j] = (pos < len) ? ert[pos] : ((pos == len) ? 0x0D : 0x00);
+      }
+      block2.commonFields.textABFlag = (i >> 4) & 1;   // 5 bits segment address
+      block2.commonFields.additionalData = i & 0B1111;
+      block3.byteContent[1] = c[0];
+      block3.byteContent[0] = c[1];
+      block4.byteContent[1] = c[2];
+      block4.byteContent[0] = c[3];
+      this->rdsSendGroup(block1, block2, block3, block4);
+    }
+  }
+}
 
 /**
  * @ingroup group05 TX RDS
  * @brief Calculates the Modified Julian Date 
- * @param year  
- * @param month 
- * @param day 
- * @return int32_t 
+ * @details Integer only (no floating-point library is linked on AVR). Julian Day Number from the Fliegel and Van Flandern
+ * @details algorithm, shifted to the MJD origin (1858-11-17). Valid for the Gregorian calendar (checked from 1900 to 2100).
+ * @param year - four digits year 
+ * @param month - 1-12
+ * @param day - 1-31
+ * @return int32_t - MJD (for example, 2024-08-30 => 60552)
  * @see https://gssc.esa.int/navipedia/index.php/Julian_Date
  * @see https://quasar.as.utexas.edu/BillInfo/JulianDatesG.html
  */
 int32_t QN8066::calculateMJD(uint16_t year, uint8_t month, uint8_t day) {
-    // Adjust month and year 
-    if (month <= 2) {
-        year -= 1;
-        month += 12;
-    }
-
-    // Julian Date
-    int yearA = year / 100;
-    int yearB = 2 - yearA + (yearA/ 4);
-    long jd = (long)(365.25 * (year + 4716)) + (long)(30.6001 * (month + 1)) + day + yearB - 1524;
+  // Shifts the year start to March, so the leap day is the last day of the year
+  uint8_t a = (14 - month) / 12;
+  uint32_t y = (uint32_t) year + 4800 - a;
+  uint8_t m = month + 12 * a - 3;
 
-    // MJD (Modified Julian Date)
-    int32_t mjd = jd - 2400001;
+  // Julian Day Number
+  int32_t jdn = day + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
 
-    return mjd;
+  // MJD (Modified Julian Date)
+  return jdn - 2400001;
 }
 
 /**
@@ -1950,50 +2986,71 @@ int32_t QN8066::calculateMJD(uint16_t year, uint8_t month, uint8_t day) {
  * @brief Sends the RDS Date Time information
  * @details To use this function (service), you will need to add an integrated clock to your system that provides 
  * @details the date and time to the system. 
- * @param year 
+ * @details The hour and minute must be UTC. The receiver adds the local time offset to show the local time.
+ * @param year - four digits year
  * @param month 
  * @param day 
- * @param hour 
- * @param min 
- * @param offset 
- * @todo Under construction 
+ * @param hour - UTC hour
+ * @param min - UTC minute
+ * @param offset - Local time offset in multiples of half hour (for example: -6 = UTC-3:00; 11 = UTC+5:30)
+ * @see QN8066RdsEncoder::setTimeSource, QN8066RdsEncoder::updateClock
  */
 void QN8066::rdsSendDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, int8_t offset) {
+  qn8066_date_time dt;
+
+  dt.year = year;
+  dt.month = month;
+  dt.day = day;
+  dt.hour = hour;
+  dt.minute = min;
+  dt.second = 0;
+  dt.offset = offset;
+
+  RDS_GROUP group;
+  this->rdsBuildCTGroup(&dt, &group);
+  for ( uint8_t k  = 0; k < this->rdsRepeatGroup; k++) 
+    this->rdsSendGroup(&group);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds one group 4A (Clock Time)
+ * @param dt - UTC date and time and local offset
+ * @param group - the group built
+ */
+void QN8066::rdsBuildCTGroup(const qn8066_date_time *dt, RDS_GROUP *group) {
 
-  int32_t mjd = this->calculateMJD(year,month,day);
+  int32_t mjd = this->calculateMJD(dt->year, dt->month, dt->day);
+  uint8_t offset = (dt->offset < 0) ? -dt->offset : dt->offset;
 
-  RDS_BLOCK1 block1;
   RDS_BLOCK2 block2;
   RDS_BLOCK3 block3;
   RDS_BLOCK4 block4; 
 
-  block1.pi =  this->rdsPI;
   block2.raw = 0;
   block2.commonFields.groupType = 4; // Group type 4A
   block2.commonFields.versionCode = 0; // Version A
   block2.commonFields.programType = this->rdsPTY; 
   block2.commonFields.trafficProgramCode = this->rdsTP; 
-  block2.commonFields.additionalData = (mjd >> 15 ); // UTC Minutes
+  block2.commonFields.additionalData = (mjd >> 15 ) & 0B11; // Two most significant bits of the MJD
 
   WORD16 auxMJD; 
 
-  auxMJD.value = ((mjd & 0B00111111111111111) << 1) | (hour >> 4);
+  auxMJD.value = ((mjd & 0B00111111111111111) << 1) | (dt->hour >> 4);
 
   block3.byteContent[1] = auxMJD.raw[1];
   block3.byteContent[0] = auxMJD.raw[0];
 
-  block4.utc.hour =  (0B01111 &  hour ); 
-  block4.utc.min =  min; 
-  block4.utc.offset_sign =  (offset < 0) ? 1 : 0;  // Local Offset Sign (0 = + , 1 = -)
-  block4.utc.offset =  offset;
-
-  for ( uint8_t k  = 0; k < this->rdsRepeatGroup; k++) 
-    this->rdsSendGroup(block1, block2, block3, block4);
+  block4.utc.hour =  (0B01111 &  dt->hour ); 
+  block4.utc.min =  dt->minute; 
+  block4.utc.offset_sign =  (dt->offset < 0) ? 1 : 0;  // Local Offset Sign (0 = + , 1 = -)
+  block4.utc.offset =  (offset > 31) ? 31 : offset;    // Multiples of half hour
 
+  group->blockB = block2.raw;
+  group->blockC = block3.raw;
+  group->blockD = block4.raw;
 }
 
-
-
 /** @defgroup group10 QN8066 FSM functions **/
 
 /**
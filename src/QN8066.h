@@ -70,6 +70,48 @@
 #define QN_REGISTER_6E 0x6E //<! This register is not documented in the Data Sheet. However, according to tests and observations, it seems to affect the quality and stability of the audio.
 #define QN_REGISTER_49 0x49 //<! This register is not documented in the Data Sheet. However, according to observations, it makes the system more stable (not sure)  
 
+/**
+ * @brief RDS Open Data Applications (ODA) and RadioText Plus (RT+)
+ *
+ */
+#define QN8066_RTPLUS_AID 0x4BD7  //<! RT+ Application Identification (AID) 
+#define QN8066_RTPLUS_GROUP 11    //<! Group type used to send the RT+ tags (11A)
+#define QN8066_ERT_AID 0x6552    //<! Enhanced RadioText (eRT) Application Identification (AID)
+#define QN8066_ERT_GROUP 12       //<! Group type used to send the eRT text (12A)
+#define RTPLUS_DUMMY_CLASS 0      //<! RT+ content type: no content (unused tag)
+#define RTPLUS_ITEM_TITLE 1       //<! RT+ content type: ITEM.TITLE
+#define RTPLUS_ITEM_ALBUM 2       //<! RT+ content type: ITEM.ALBUM
+#define RTPLUS_ITEM_ARTIST 4      //<! RT+ content type: ITEM.ARTIST
+#define RTPLUS_STATIONNAME_LONG 32 //<! RT+ content type: STATIONNAME.LONG
+#define RTPLUS_PROGRAMME_NOW 33   //<! RT+ content type: PROGRAMME.NOW
+
+/**
+ * @brief Decoder Identification (DI) flags. See rdsSetDI
+ *
+ */
+#define RDS_DI_STEREO 1           //<! d0 - Stereo (0 = Mono)
+#define RDS_DI_ARTIFICIAL_HEAD 2  //<! d1 - Artificial head recording
+#define RDS_DI_COMPRESSED 4       //<! d2 - Compressed
+#define RDS_DI_DYNAMIC_PTY 8      //<! d3 - PTY changes during the programme (dynamic PTY)
+
+/**
+ * @brief RX seek and band scan (hardware CCA). See seekRxProcess and scanRxBand
+ *
+ */
+#define QN8066_SEEK_BUSY 0        //<! The QN8066 is still scanning
+#define QN8066_SEEK_FOUND 1       //<! A valid channel was found (the receiver is tuned on it)
+#define QN8066_SEEK_FAIL 2        //<! No valid channel in the range (the previous frequency is restored)
+#define QN8066_SEEK_TIMEOUT 3     //<! The scan did not finish in time (the previous frequency is restored)
+#define QN8066_SCAN_SETTLE 60     //<! Time in ms on a station found before measuring RSSI, SNR and stereo (scanRxBand)
+#define QN8066_SURVEY_MIN_SETTLE 2   //<! Minimum time in ms on each channel of the survey (surveyBand)
+#define QN8066_SURVEY_MAX_SETTLE 25  //<! Maximum time in ms waiting for the AGC on each channel of the survey
+#define QN8066_SURVEY_CHUNK 32       //<! Channels measured per block by surveyQuietest (RAM used: QN8066_SURVEY_CHUNK + 2 bytes)
+#define QN8066_TX_AUTO_NONE 0        //<! setTXAuto was not used
+#define QN8066_TX_AUTO_CCS 1         //<! Channel selected by the QN8066 (CCS)
+#define QN8066_TX_AUTO_SURVEY 2      //<! Channel selected by the software survey (CCS failed)
+
+#define RDS_EBU_UNKNOWN '?'       //<! Sent instead of the characters that are not in the RDS character set (see utf8ToEBU)
+
 /** @defgroup group00 Union, Struct and Defined Data Types
  * @section group01 Data Types
  *
@@ -828,12 +870,108 @@ typedef union
     uint8_t raw[6];
 } RDS_DATE_TIME;
 
+/**
+ * @ingroup group00 RDS
+ * @brief RDS group without block 1 (RDS_GROUP data type)
+ * @details Block 1 is always the PI code, so only the blocks 2, 3 and 4 are stored in the group cache and in the send queue.
+ * @see QN8066RdsEncoder::process, QN8066RdsEncoder::queueGroup
+ */
+typedef struct {
+  uint16_t blockB;  //!< Block 2 - group type, version, TP, PTY and group specific bits
+  uint16_t blockC;  //!< Block 3
+  uint16_t blockD;  //!< Block 4
+} RDS_GROUP;
+
 
 typedef union { 
   uint16_t value;
   uint8_t  raw[2];  
 } WORD16;
 
+/**
+ * @ingroup group00 RDS
+ * @brief RDS TX timing calibration (qn8066_rds_calibration data type)
+ * @details Result of the RDS_TXUPD timing measurement done by rdsCalibrate. All times are in microseconds.
+ * @details The structure belongs to the application and is given to the QN8066 by rdsSetCalibration.
+ * @see rdsCalibrate, rdsSetCalibration, rdsGetCalibration, rdsSetCalibrationInterval
+ */
+typedef struct {
+  uint32_t groupPeriod;     //!< Measured interval between two RDS_TXUPD toggles (time the chip takes to consume a group)
+  uint32_t writeOverhead;   //!< Host side time spent to load the 8 RDS bytes and toggle RDSRDY
+  uint32_t pollCost;        //!< Host side time spent to read the RDS_TXUPD bit once
+  uint32_t firstPeriod;     //!< Group period measured by the first calibration (reference for drift)
+  uint32_t minPeriod;       //!< Lowest group period measured since the first calibration
+  uint32_t maxPeriod;       //!< Highest group period measured since the first calibration
+  int32_t  drift;           //!< groupPeriod - firstPeriod
+  uint32_t lastCalibration; //!< millis() when the last calibration was done or failed
+  uint32_t interval;        //!< Interval in ms between runtime re-calibrations (0 = disabled). See rdsSetCalibrationInterval
+  uint16_t count;           //!< Number of calibrations done
+} qn8066_rds_calibration;
+
+/**
+ * @ingroup group00 RDS
+ * @brief RDS TX statistics (qn8066_rds_stats data type)
+ * @details Updated by rdsSendGroup (and QN8066RdsEncoder::process). Latencies are in microseconds.
+ * @details The structure belongs to the application and is given to the QN8066 by rdsSetStats.
+ * @see rdsSetStats, rdsGetStats, rdsResetStats, rdsGetTimeSinceLastPS
+ */
+typedef struct {
+  uint32_t groups[16];      //!< Number of groups sent per group type (0 to 15 - versions A and B together)
+  uint32_t total;           //!< Total of groups sent
+  uint32_t timeouts;        //!< Number of times RDS_TXUPD did not toggle in time
+  uint32_t underruns;       //!< Number of times the chip finished a group with no new data to fetch (host too late)
+  uint32_t maxLatency;      //!< Highest time from the start of the group load to the RDS_TXUPD toggle
+  uint32_t meanLatency;     //!< Mean time from the start of the group load to the RDS_TXUPD toggle (moving average, 1/16 weight)
+  uint32_t lastFetch;       //!< micros() when the last RDS_TXUPD toggle was detected
+  uint32_t lastPSCycle;     //!< millis() when the last complete PS cycle (4 segments) was sent without error
+} qn8066_rds_stats;
+
+/**
+ * @ingroup group00 RDS
+ * @brief Date and time used by the RDS Clock Time service (qn8066_date_time data type)
+ * @details hour and minute are UTC. offset is the local time offset in multiples of half hour (for example: -6 = UTC-3:00; 11 = UTC+5:30).
+ * @see rdsSendDateTime, QN8066RdsEncoder::setTimeSource
+ */
+typedef struct {
+  uint16_t year;    //!< Four digits year (1900-2100)
+  uint8_t month;    //!< 1-12
+  uint8_t day;      //!< 1-31
+  uint8_t hour;     //!< UTC hour (0-23)
+  uint8_t minute;   //!< UTC minute (0-59)
+  uint8_t second;   //!< 0-59
+  int8_t offset;    //!< Local time offset in half hours (-31 to +31)
+} qn8066_date_time;
+
+/**
+ * @ingroup group00 RDS
+ * @brief Time source used by the RDS Clock Time service
+ * @details Function that fills the qn8066_date_time with the current date and time (RTC DS1302, STM32 RTC, NTP etc).
+ * @details It must return false if the date and time are not valid (for example, RTC not set or NTP not synchronized yet).
+ * @see QN8066RdsEncoder::setTimeSource, QN8066StationMemory::setTimeSource
+ */
+typedef bool (*qn8066_time_source)(qn8066_date_time *dt);
+
+/**
+ * @ingroup group00
+ * @brief Station found by the band scan (qn8066_station data type)
+ * @see scanRxBand
+ */
+typedef struct {
+  uint16_t frequency;  //!< Frequency (MHz x 10. Example: 1069 = 106.9 MHz)
+  uint8_t rssi;        //!< RSSI (dBuV = RSSI - 49)
+  uint8_t snr;         //!< SNR in dB
+  bool stereo;         //!< true = stereo
+} qn8066_station;
+
+/**
+ * @ingroup group00 RDS
+ * @brief RDS group monitor
+ * @details Called each time a group (blocks 1 to 4) is loaded into the QN8066. It can be used to log the groups sent 
+ * @details or to check them with the reference encoder (see QN8066RDSCoder). It must return quickly.
+ * @see rdsSetGroupMonitor
+ */
+typedef void (*qn8066_rds_monitor)(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD);
+
 
 /**
  * @ingroup  CLASSDEF
@@ -862,6 +1000,9 @@ private:
   qn8066_rds rds;
   qn8066_pac pac;
   qn8066_vol_ctl vol_ctl;
+  qn8066_ch_start ch_start = {};  //!< Shadow of CH_START (the channel registers are never read before being written)
+  qn8066_ch_stop ch_stop = {};    //!< Shadow of CH_STOP
+  qn8066_ch_step ch_step = {};    //!< Shadow of CH_STEP
 
 
   uint8_t rdsSyncTime = 60;               //!< Wait time in milliseconds before sending the next group - Default is 60 ms. 
@@ -871,7 +1012,17 @@ private:
   uint16_t rdsPI = 33179;    //!< Default value for piCode (0x819B)
   uint8_t rdsPTY = 0;       //!< The default program type (PTY) is 5, which is "Education" for RDS and "Rock" for RDBS.
   uint8_t rdsTP = 0;        //!< Traffic Program (TP)
+  uint8_t rdsTA = 0;        //!< Traffic Announcement (TA)
+  uint8_t rdsDI = 0;        //!< Decoder Identification (RDS_DI_* flags)
+  uint8_t rdsMS = 0;        //!< Music/Speech switch (1 = Music; 0 = Speech)
   uint8_t rdsSendError = 0;
+  bool rdsUTF8 = true;      //!< true = the texts are UTF-8 and are converted to the RDS (EBU) character set
+
+  qn8066_rds_calibration *rdsCalibrationInfo = NULL;  //!< RDS TX timing calibration result (NULL = not kept). See rdsSetCalibration
+  qn8066_rds_stats *rdsStats = NULL;                  //!< RDS TX statistics (NULL = disabled). See rdsSetStats
+  qn8066_rds_monitor rdsMonitor = NULL;               //!< Called for each group loaded (NULL = disabled)
+  uint8_t rdsTextAB = 0;    //!< Current Text A/B flag of the Radio Text (group 2)
+  uint16_t rdsRTHash = 0;   //!< Hash of the last Radio Text sent (the Text A/B flag is toggled when it changes)
 
   char strRxCurrentFrequency[8];  // Stores formated current frequency
   uint16_t rxCurrentFrequency; 
@@ -880,6 +1031,31 @@ private:
   uint16_t minimalFrequency = 639;
   uint16_t maximalFrequency = 1081;
 
+  uint16_t rxTuneCoalesce = 0;      //!< Coalesce time in ms of setRxFrequencyUp/Down (0 = tunes at once)
+  bool rxTunePending = false;       //!< true = rxCurrentFrequency was not tuned yet (coalesce mode)
+  uint32_t rxTuneRequest = 0;       //!< millis() of the last step requested (coalesce mode)
+  uint8_t rxTuneCount = 0;          //!< Channel writes (tuning, probe and survey). See getRxTuneCount
+
+  uint8_t seekStepTimeout = 10;     //!< Maximum time in ms per channel during a hardware scan (CCA)
+  bool seekBusy = false;            //!< true = a hardware scan is running (see seekRxStart)
+  uint32_t seekDeadline = 0;        //!< millis() limit of the current hardware scan
+  qn8066_station *scanList = NULL;  //!< Station list of the band scan (NULL = no band scan running)
+  uint8_t scanSize = 0;
+  uint8_t scanCount = 0;            //!< Stations found by the band scan
+  uint16_t scanHome = 0;            //!< Frequency restored at the end of the band scan
+  uint32_t scanMeasureTime = 0;     //!< millis() when the current station was found (0 = scanning)
+
+  uint16_t txCurrentFrequency = 0;  //!< Current transmitter frequency (MHz x 10)
+  uint8_t txAutoMethod = QN8066_TX_AUTO_NONE;  //!< How the last setTXAuto selected the channel
+  uint32_t txAutoTime = 0;          //!< Time in ms spent by the last setTXAuto
+
+  void rdsSendRTText(const char *rt, uint8_t version);
+  void scanRxRange(uint16_t startFrequency, uint16_t stopFrequency, uint8_t frequencyStep);
+  void rxTune(uint16_t frequency);
+  void rxTuneChannel(uint16_t frequency);
+  void rxTuneStep();
+  static uint16_t surveyScore(const uint8_t *rssi, uint16_t count, uint16_t index);
+  char rdsNextChar(const char **text);
 
 
 protected:
@@ -888,7 +1064,9 @@ public:
   uint8_t scanI2CBus(uint8_t *device);
 
   uint8_t getRegister(uint8_t registerNumber);
+  void getRegisters(uint8_t registerNumber, uint8_t *data, uint8_t count);
   void setRegister(uint8_t registerNumber, uint8_t value);
+  void setRegisters(uint8_t registerNumber, const uint8_t *data, uint8_t count);
 
   inline qn8066_cid1 getDeviceProductID() {
     qn8066_cid1 value;
@@ -916,7 +1094,24 @@ public:
   void setRxFrequencyUp();
   void setRxFrequencyDown();
   void setRxFrequencyStep(uint8_t value);
-  inline uint16_t getRxCurrentFrequency(){ return this->rxCurrentFrequency;}; 
+  bool rxTuneProcess();
+
+  /**
+   * @ingroup group03 RX
+   * @brief Sets the coalesce mode of setRxFrequencyUp and setRxFrequencyDown
+   * @details Steps requested within this time are collapsed into a single tuning (see rxTuneProcess).
+   * @param ms - coalesce time in ms (0 = disabled; each step tunes at once)
+   */
+  inline void setRxTuneCoalesce(uint16_t ms) {this->rxTuneCoalesce = ms;};
+  inline uint16_t getRxCurrentFrequency(){ return this->rxCurrentFrequency;};
+
+  /**
+   * @ingroup group03 RX
+   * @brief Counts the writes of the receiver channel (setRX, setRxFrequency, probeRxFrequency, surveyBand etc)
+   * @details Used by QN8066RdsDecoder to know that the group in the RDS registers may be from another frequency.
+   * @return counter (wraps around)
+   */
+  inline uint8_t getRxTuneCount() {return this->rxTuneCount;};
   void rdsEnableRX(bool value);
   void setAudioMuteRX(bool value);
   uint8_t getRxSNR();
@@ -927,17 +1122,44 @@ public:
   bool isRxReceiving();
   bool isRxAgcStable(); 
   bool isRxStereo();
-  void scanRxStation(uint16_t startFrequency, uint16_t stopFrequyency, uint8_t frequencyStep ); 
+  uint16_t scanRxStation(uint16_t startFrequency, uint16_t stopFrequyency, uint8_t frequencyStep ); 
+  void seekRxStart(uint16_t startFrequency, uint16_t stopFrequency, uint8_t frequencyStep = 1);
+  uint8_t seekRxProcess();
+  uint16_t seekRxStationUp();
+  uint16_t seekRxStationDown();
+  void scanRxBandStart(qn8066_station *list, uint8_t size);
+  bool scanRxBandProcess();
+  uint8_t scanRxBand(qn8066_station *list, uint8_t size);
+  uint16_t surveyBand(uint16_t startFrequency, uint16_t stopFrequency, uint8_t step, uint8_t *rssi, uint8_t *snr = NULL);
+  uint16_t surveyQuietest(uint16_t startFrequency, uint16_t stopFrequency);
+  uint8_t surveyBestChannels(const uint8_t *rssi, uint16_t count, uint16_t startFrequency, uint8_t step, uint16_t *best, uint8_t size);
+  uint32_t probeRxFrequency(uint16_t frequency, uint8_t *rssi, uint8_t *snr, uint8_t maxSettle = QN8066_SURVEY_MAX_SETTLE);
 
-  // RX RDS
+  /**
+   * @ingroup group03 RX
+   * @brief Sets the maximum time per channel of the hardware scan
+   * @details The scan is aborted (QN8066_SEEK_TIMEOUT) if it takes longer than this time multiplied by the number of channels.
+   * @param value - time in ms (default 10)
+   */
+  inline void setSeekStepTimeout(uint8_t value) {this->seekStepTimeout = value;};
+  inline bool isSeeking() {return this->seekBusy;};           //!< true while a hardware scan is running
+  inline uint8_t getScanCount() {return this->scanCount;};    //!< Stations found by the last band scan
+
+  // RX RDS (the decoder is the QN8066RdsDecoder class)
   void rdsRxEnable(bool value);
   char *rdsRxGetPS(char *ps);
   char *rdsRxGetRT(char *rt);
   char *rdsRxGetTime(char *time);
+  static void mjdToDate(int32_t mjd, uint16_t *year, uint8_t *month, uint8_t *day);
   
   
   
   void setTX(uint16_t frequency); // RESET the system and set to TX mode at a given frequency
+  uint16_t setTXAuto(uint16_t rangeStart, uint16_t rangeStop, uint8_t snrThreshold = 16);
+  void setTxChannel(uint16_t frequency);
+  inline uint16_t getTxCurrentFrequency() {return this->txCurrentFrequency;};
+  inline uint8_t getTXAutoMethod() {return this->txAutoMethod;};   //!< QN8066_TX_AUTO_CCS or QN8066_TX_AUTO_SURVEY
+  inline uint32_t getTXAutoTime() {return this->txAutoTime;};      //!< Time in ms spent by the last setTXAuto
 
   void  setTxStereo(bool value = true);  
   void  setTxMono(uint8_t value = 0); // Default stereo
@@ -1029,16 +1251,23 @@ public:
   void rdsSetTxLineIn(bool value = 0); 
 
   void rdsSendGroup(RDS_BLOCK1 blockA, RDS_BLOCK2 blockB, RDS_BLOCK3 blockC, RDS_BLOCK4 blockD);
+  void rdsSendGroup(const RDS_GROUP *group);
+  void rdsLoadGroup(RDS_BLOCK1 block1, RDS_BLOCK2 block2, RDS_BLOCK3 block3, RDS_BLOCK4 block4, bool toggle = true);
+  void rdsLoadGroup(const RDS_GROUP *group, bool toggle = true);
+  void rdsBuildCTGroup(const qn8066_date_time *dt, RDS_GROUP *group);
+  void rdsBuildODAAnnouncement(uint8_t groupType, uint8_t version, uint16_t message, uint16_t aid, RDS_GROUP *group);
   void rdsSendPS(char* ps = NULL); 
 
-
   void rdsSetStationName(char *stationName);
   void rdsSendRTMessage(char *rt);
+  void rdsSendRTMessageB(char *rt);
+  void rdsSendERTMessage(const char *ert);
+  void rdsSendODAAnnouncement(uint8_t groupType, uint8_t version, uint16_t message, uint16_t aid);
   /**
  * @ingroup group05 TX RDS
  * @brief Sends RDS Radio Text Message (group 2A)
  * @details It is a synonym to rdsSendRTMessage. This function repeats sending a group this->rdsRepeatGroup times.
- * @param rt - Radio Text (string of 32 character)
+ * @param rt - Radio Text (string up to 64 character)
  * @details Example
  * @code 
  * #include <QN8066.h>
@@ -1057,9 +1286,16 @@ public:
  */
   inline void rdsSendRT(char *rt) {this->rdsSendRTMessage(rt); };
 
-  int32_t calculateMJD(uint16_t year, uint8_t month, uint8_t day);
+  static int32_t calculateMJD(uint16_t year, uint8_t month, uint8_t day);
   void rdsSendDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, int8_t offset = 0);
 
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets a function that receives every group loaded into the QN8066
+  * @param monitor - see qn8066_rds_monitor (NULL disables the monitor)
+  * @see QN8066RDSCoder
+  */
+  inline void rdsSetGroupMonitor(qn8066_rds_monitor monitor) {this->rdsMonitor = monitor;};
 
   
  /**
@@ -1118,7 +1354,7 @@ public:
   * @param pi - PI Code
   * @see rdsSetPI, rdsInitTx, rdsTxEnable, rdsGetPI, rdsSetPTY, rdsGetPTY, rdsSetTP, rdsGetTP rdsSetSyncTime, rdsSetRepeatSendGroup   
   */
-  uint8_t rdsGetPI() {return this->rdsPI;};
+  uint16_t rdsGetPI() {return this->rdsPI;};
 
   /**
   * @ingroup group05 TX RDS
@@ -1154,6 +1390,52 @@ public:
   */
   uint8_t rdsGetTP() {return this->rdsTP;};
 
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets the Traffic Announcement (TA) flag sent in the group 0A/0B.
+  * @details The new flag is used by the next groups built. To switch the receivers as fast as possible, use QN8066RdsEncoder::setTrafficAnnouncement.
+  * @param ta - 1 = traffic announcement on air; 0 = off
+  * @see rdsSetTP, rdsGetTA, QN8066RdsEncoder::setTrafficAnnouncement
+  */
+  void rdsSetTA(uint8_t ta) {this->rdsTA = ta;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the current Traffic Announcement (TA) flag.
+  * @see rdsSetTA
+  */
+  uint8_t rdsGetTA() {return this->rdsTA;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets the Decoder Identification (DI) flags sent in the group 0A/0B (one bit per PS segment).
+  * @param di - RDS_DI_STEREO, RDS_DI_ARTIFICIAL_HEAD, RDS_DI_COMPRESSED and RDS_DI_DYNAMIC_PTY (OR-ed). Default 0.
+  * @details Example: tx.rdsSetDI(RDS_DI_STEREO | RDS_DI_DYNAMIC_PTY);
+  * @see rdsSetMS, rdsSetTA
+  */
+  void rdsSetDI(uint8_t di) {this->rdsDI = di & 0B1111;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets the Music/Speech switch (MS) sent in the group 0A/0B.
+  * @param ms - 1 = Music; 0 = Speech (default)
+  * @see rdsSetDI
+  */
+  void rdsSetMS(uint8_t ms) {this->rdsMS = ms & 1;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the Decoder Identification (DI) flags.
+  * @see rdsSetDI
+  */
+  uint8_t rdsGetDI() {return this->rdsDI;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the Music/Speech switch (MS).
+  * @see rdsSetMS
+  */
+  uint8_t rdsGetMS() {return this->rdsMS;};
 
   /**
   * @ingroup group05 TX RDS
@@ -1161,6 +1443,19 @@ public:
   */
   char* rdsGetPS() {return this->rdsStationName;};
 
+  static uint8_t utf8ToEBU(const char **text);
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets how the texts (PS, RT, Dynamic PS and PTYN) are coded
+  * @details By default the texts are UTF-8 and they are converted to the RDS character set (EN 50067 Annex E) once, 
+  * @details when the text is set. Use false if your texts are already coded in the RDS character set (Example: UECP).
+  * @param value - true = UTF-8 (default); false = RDS character set (the bytes are sent as they are)
+  * @see utf8ToEBU
+  */
+  inline void rdsSetUTF8(bool value) {this->rdsUTF8 = value;};
+  inline bool rdsGetUTF8() {return this->rdsUTF8;};
+
 
   /**
   * @ingroup group05 TX RDS
@@ -1192,6 +1487,92 @@ public:
   * @see rdsSetPI, rdsInitTx, rdsTxEnable, rdsGetPI, rdsSetPTY, rdsGetPTY, rdsSetTP, rdsGetTP rdsSetSyncTime, rdsSetRepeatSendGroup   
   */
   inline void rdsSetRepeatSendGroup (uint8_t count) {this->rdsRepeatGroup = count;};
+  inline uint8_t rdsGetRepeatSendGroup() {return this->rdsRepeatGroup;};   //!< Number of times a group is sent at once
+
+  uint8_t rdsCalibrate(uint8_t groups = 8);
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the current wait time used before checking RDS_TXUPD
+  * @details It is the value set by rdsSetSyncTime, rdsInitTx or computed by rdsCalibrate.
+  * @return wait time in ms
+  * @see rdsCalibrate, rdsSetSyncTime
+  */
+  inline uint8_t rdsGetSyncTime() {return this->rdsSyncTime;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets where the RDS timing calibration results are kept
+  * @details The QN8066 class does not keep the results of rdsCalibrate (only the wait time). Give it a qn8066_rds_calibration 
+  * @details to read the drift statistics and to use the runtime re-calibration. The structure is cleared here.
+  * @param info - calibration results (NULL = not kept; this is the default)
+  * @see rdsCalibrate, rdsGetCalibration, rdsSetCalibrationInterval
+  */
+  inline void rdsSetCalibration(qn8066_rds_calibration *info) {this->rdsCalibrationInfo = info; if ( info != NULL ) memset(info, 0, sizeof(qn8066_rds_calibration));};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Sets the interval for the runtime RDS timing re-calibration
+  * @details When different of 0, rdsSendGroup runs a short rdsCalibrate every time the interval expires.
+  * @details It keeps rdsSyncTime close to the minimum safe value even when the clocks of the MCU or the QN8066 drift.
+  * @details The interval is stored in the qn8066_rds_calibration, so rdsSetCalibration must be called first.
+  * @param interval - time in ms (0 = disabled; this is the default)
+  * @see rdsCalibrate, rdsSetCalibration
+  */
+  inline void rdsSetCalibrationInterval(uint32_t interval) {if ( this->rdsCalibrationInfo != NULL ) this->rdsCalibrationInfo->interval = interval;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the RDS timing calibration result and drift statistics
+  * @return pointer to the qn8066_rds_calibration given to rdsSetCalibration (NULL if none)
+  * @see rdsCalibrate, rdsSetCalibration, rdsSetCalibrationInterval
+  */
+  inline const qn8066_rds_calibration *rdsGetCalibration() {return this->rdsCalibrationInfo;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Enables the RDS TX statistics
+  * @details The statistics are kept in a structure of the application, so the QN8066 class does not carry them when they are not used.
+  * @details The structure is cleared here.
+  * @details Example
+  * @code 
+  * qn8066_rds_stats stats;
+  * ...
+  * tx.rdsSetStats(&stats);
+  * ...
+  * Serial.print(stats.groups[0]);   // 0A/0B groups sent
+  * Serial.print(stats.timeouts);
+  * Serial.print(stats.underruns);
+  * Serial.print(stats.maxLatency);
+  * @endcode  
+  * @param stats - statistics (NULL = disabled; this is the default)
+  * @see rdsGetStats, rdsResetStats, rdsGetTimeSinceLastPS
+  */
+  inline void rdsSetStats(qn8066_rds_stats *stats) {this->rdsStats = stats; this->rdsResetStats();};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the RDS TX statistics
+  * @details It just returns the pointer given to rdsSetStats. No I2C access is done, so you can call it in every loop.
+  * @return pointer to a qn8066_rds_stats (NULL if the statistics are disabled)
+  * @see rdsSetStats, rdsResetStats, rdsGetTimeSinceLastPS, rdsGetError
+  */
+  inline qn8066_rds_stats *rdsGetStats() {return this->rdsStats;};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Clears the RDS TX statistics
+  * @see rdsSetStats, rdsGetStats
+  */
+  inline void rdsResetStats() {if ( this->rdsStats != NULL ) memset(this->rdsStats, 0, sizeof(qn8066_rds_stats));};
+
+  /**
+  * @ingroup group05 TX RDS
+  * @brief Gets the time elapsed since the last complete PS cycle sent without error
+  * @return time in ms or 0xFFFFFFFF if no PS cycle was sent yet (or the statistics are disabled)
+  * @see rdsSetStats, rdsGetStats
+  */
+  inline uint32_t rdsGetTimeSinceLastPS() {return (this->rdsStats != NULL && this->rdsStats->lastPSCycle) ? (millis() - this->rdsStats->lastPSCycle) : 0xFFFFFFFF;};
 
   void resetFsm();
   uint8_t getFsmStateCode();
@@ -0,0 +1,261 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX Alternative Frequency (AF) following
+ *
+ * @details Probe cost: mute time = AGC wait + 5 I2C transactions (mute, tune, last read, tune back and unmute), each one 
+ * @details followed by QN8066_DELAY_COMMAND. The AGC wait is what is left of maxMute after QN8066_AF_PROBE_OVERHEAD. 
+ * @details The real value of each probe is measured with micros().
+ * @details Smoothing of the current frequency: value = value + (sample - value) / 4. The first sample is used as it is.
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066AFFollower.h>
+
+/** @defgroup group12 AF Following RX Alternative Frequency following */
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Starts the AF following
+ * @param rx - QN8066 instance (RX mode with RDS enabled - see rdsRxEnable)
+ * @param rds - RDS decoder of rx
+ * @param margin - an AF must have this RSSI (dB) above the current frequency to be used
+ * @param probeInterval - time in ms between probes (0 = no probe)
+ * @param maxMute - maximum mute time of a probe in ms (at least QN8066_AF_PROBE_OVERHEAD + QN8066_SURVEY_MIN_SETTLE)
+ */
+void QN8066AFFollower::begin(QN8066 *rx, QN8066RdsDecoder *rds, uint8_t margin, uint16_t probeInterval, uint8_t maxMute) {
+  uint8_t overhead = QN8066_AF_PROBE_OVERHEAD + QN8066_SURVEY_MIN_SETTLE;
+
+  this->rx = rx;
+  this->rds = rds;
+  this->margin = margin;
+  this->probeInterval = probeInterval;
+  this->maxSettle = (maxMute > overhead) ? maxMute - QN8066_AF_PROBE_OVERHEAD : QN8066_SURVEY_MIN_SETTLE;
+  this->probes = this->switches = this->reverts = 0;
+  this->muteTotal = this->muteMax = 0;
+  this->verifying = false;
+  this->clear();
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Removes all AF sets
+ */
+void QN8066AFFollower::clear() {
+  for (uint8_t i = 0; i < QN8066_AF_SETS; i++) {
+    this->sets[i].pi = 0;
+    this->sets[i].count = 0;
+  }
+  this->restart(0);
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Starts over on a new frequency (PI and signal not known yet)
+ * @param frequency - frequency being listened (MHz x 10)
+ */
+void QN8066AFFollower::restart(uint16_t frequency) {
+  this->home = frequency;
+  this->current = -1;
+  this->merged = 0;
+  this->samples = 0;
+  this->lastProbe = millis();
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Finds the AF set of a PI
+ * @param pi - Program Identification
+ * @param create - true = if not found, the least recently used set is replaced
+ * @return index of the set (-1 = not found)
+ */
+int8_t QN8066AFFollower::findSet(uint16_t pi, bool create) {
+  int8_t idx = 0;
+
+  for (uint8_t i = 0; i < QN8066_AF_SETS; i++) {
+    if ( this->sets[i].pi == pi && pi != 0 ) {
+      this->sets[i].used = millis();
+      return i;
+    }
+  }
+  if ( !create || pi == 0 ) return -1;
+
+  for (uint8_t i = 0; i < QN8066_AF_SETS; i++) {   // A free set or the least recently used one
+    if ( this->sets[i].pi == 0 ) {
+      idx = i;
+      break;
+    }
+    if ( millis() - this->sets[i].used > millis() - this->sets[idx].used ) idx = i;
+  }
+
+  this->sets[idx].pi = pi;
+  this->sets[idx].count = this->sets[idx].next = 0;
+  this->sets[idx].used = millis();
+  return idx;
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Adds a frequency to the AF set of a PI
+ * @details The lists of the group 0A are added by process(). Use this function to add frequencies known from other
+ * @details sources (for example, the stations with the same PI in QN8066StationMemory).
+ * @param pi - Program Identification
+ * @param frequency - frequency (MHz x 10)
+ * @return true if the frequency was added
+ */
+bool QN8066AFFollower::addAF(uint16_t pi, uint16_t frequency) {
+  int8_t idx = this->findSet(pi, true);
+  qn8066_af_set *set;
+
+  if ( idx < 0 || frequency < 876 || frequency > 1079 ) return false;
+  set = &this->sets[idx];
+  for (uint8_t i = 0; i < set->count; i++)
+    if ( set->af[i].frequency == frequency ) return false;
+  if ( set->count == QN8066_AF_PER_PI ) return false;
+
+  set->af[set->count].frequency = frequency;
+  set->af[set->count].rssi = set->af[set->count].penalty = 0;
+  set->count++;
+  return true;
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Gets the AF set of a PI
+ * @param pi - Program Identification
+ * @param list - returns the frequencies (MHz x 10)
+ * @param size - maximum number of frequencies
+ * @return number of frequencies returned
+ */
+uint8_t QN8066AFFollower::getAF(uint16_t pi, uint16_t *list, uint8_t size) {
+  int8_t idx = this->findSet(pi, false);
+  uint8_t n = 0;
+
+  if ( idx < 0 ) return 0;
+  for ( ; n < this->sets[idx].count && n < size; n++) list[n] = this->sets[idx].af[n].frequency;
+  return n;
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Reads SNR and RSSI of the current frequency (one I2C transaction) and updates the smoothed values
+ */
+void QN8066AFFollower::measure() {
+  uint8_t data[2];   // SNR and RSSISIG
+
+  this->rx->getRegisters(QN_SNR, data, 2);
+  if ( this->samples == 0 ) {
+    this->snr = data[0];
+    this->rssi = data[1];
+  } else {
+    this->snr = ((uint16_t) this->snr * 3 + data[0] + 2) >> 2;
+    this->rssi = ((uint16_t) this->rssi * 3 + data[1] + 2) >> 2;
+  }
+  if ( this->samples < 0xFF ) this->samples++;
+  this->lastMeasure = millis();
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Gets the next AF of the current set to be probed (round robin)
+ * @details The current frequency is skipped. An AF with penalty is skipped and its penalty is decremented.
+ * @return AF to be probed (NULL = none)
+ */
+qn8066_af_entry *QN8066AFFollower::nextCandidate() {
+  qn8066_af_set *set = &this->sets[this->current];
+
+  for (uint8_t n = 0; n < set->count; n++) {
+    qn8066_af_entry *entry = &set->af[set->next];
+    set->next = (set->next + 1) % set->count;
+    if ( entry->frequency == this->home ) continue;
+    if ( entry->penalty > 0 ) {
+      entry->penalty--;
+      continue;
+    }
+    return entry;
+  }
+  return NULL;
+}
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Learns the AF lists, measures the current frequency and probes the AFs. Call it in the loop, after QN8066RdsDecoder::process.
+ * @details A frequency tuned by the application (getRxCurrentFrequency changed) starts the engine over on it.
+ * @details At most one probe is done per call, and only if the probe interval has passed and the RSSI is below the
+ * @details probe threshold (see setProbeThreshold).
+ * @return AF_EVENT_LEARNED, AF_EVENT_PROBED, AF_EVENT_SWITCHED and/or AF_EVENT_REVERTED (0 = nothing happened)
+ */
+uint8_t QN8066AFFollower::process() {
+  uint8_t events = 0;
+  uint8_t status;
+
+  if ( this->rx == NULL ) return 0;
+  // RDS data of the frequency being listened only (the decoder is cleared on its next process after a tuning)
+  status = (this->rds->getFrequency() == this->rx->getRxCurrentFrequency()) ? this->rds->getStatus() : 0;
+
+  if ( this->verifying ) {
+    bool samePI = (status & RDS_RX_PI) && this->current >= 0 && this->rds->getPI() == this->sets[this->current].pi;
+    if ( !samePI && !(status & RDS_RX_PI) && millis() - this->verifyStart < this->verifyTimeout ) return 0;
+
+    int8_t idx = this->current;
+    this->verifying = false;
+    if ( samePI ) {
+      this->switches++;
+      this->addAF(this->sets[idx].pi, this->previous);   // The previous frequency is an AF of the new one
+      this->restart(this->rx->getRxCurrentFrequency());
+      this->current = idx;
+      return AF_EVENT_SWITCHED;
+    }
+    // Wrong PI or no PI: goes back
+    this->reverts++;
+    this->candidate->penalty = QN8066_AF_PENALTY;
+    this->rx->setRxFrequency(this->previous);
+    this->rds->reset();
+    this->restart(this->previous);
+    this->current = idx;
+    return AF_EVENT_REVERTED;
+  }
+
+  if ( this->rx->getRxCurrentFrequency() != this->home ) this->restart(this->rx->getRxCurrentFrequency());
+
+  // Learns the AF list of the current PI
+  if ( status & RDS_RX_PI ) {
+    if ( this->current < 0 || this->sets[this->current].pi != this->rds->getPI() ) {
+      this->current = this->findSet(this->rds->getPI(), true);
+      this->merged = 0;
+    }
+    if ( this->rds->getAFCount() != this->merged ) {
+      uint16_t list[QN8066_RDS_RX_AF_MAX];
+      uint8_t n = this->rds->getAF(list, QN8066_RDS_RX_AF_MAX);
+      for (uint8_t i = this->merged; i < n; i++)
+        if ( this->addAF(this->sets[this->current].pi, list[i]) ) events |= AF_EVENT_LEARNED;
+      this->merged = n;
+    }
+  }
+
+  if ( this->samples == 0 || millis() - this->lastMeasure >= this->measureInterval ) this->measure();
+
+  if ( this->current < 0 || this->probeInterval == 0 || this->rssi >= this->probeBelow ) return events;
+  if ( millis() - this->lastProbe < this->probeInterval ) return events;
+  this->lastProbe = millis();
+
+  qn8066_af_entry *entry = this->nextCandidate();
+  if ( entry == NULL ) return events;
+
+  uint8_t rssi, snr;
+  uint32_t cost = this->rx->probeRxFrequency(entry->frequency, &rssi, &snr, this->maxSettle);
+  this->probes++;
+  this->muteTotal += cost;
+  if ( cost > this->muteMax ) this->muteMax = cost;
+  entry->rssi = rssi;
+  events |= AF_EVENT_PROBED;
+
+  if ( rssi >= this->rssi + this->margin && snr >= this->snr ) {
+    this->previous = this->home;
+    this->candidate = entry;
+    this->verifying = true;
+    this->verifyStart = millis();
+    this->rx->setRxFrequency(entry->frequency);
+    this->rds->reset();                           // The PI is received again
+  }
+  return events;
+}
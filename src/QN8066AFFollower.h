@@ -0,0 +1,149 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX Alternative Frequency (AF) following
+ *
+ * @details This file contains an AF following engine for the QN8066 receiver. The AF lists of the group 0A (decoded by
+ * @details QN8066RdsDecoder) are stored in one set per PI. While the receiver is listening, one AF of the current PI is
+ * @details probed from time to time in a short mute window (see QN8066::probeRxFrequency). When the AF is better than
+ * @details the current frequency by the hysteresis margin (RSSI) and its SNR is not worse, the receiver switches to it and
+ * @details waits for the PI. If the PI is not the same, the receiver goes back and the AF is skipped for a while.
+ * @details The mute time of each probe is measured (see getMuteAverage and getMuteMax) and bounded by the maxMute
+ * @details parameter of begin. The probe interval bounds the share of the time with the audio muted.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_AF_FOLLOWER_H // Prevent this file from being compiled more than once
+#define _QN8066_AF_FOLLOWER_H
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+
+#ifndef QN8066_AF_SETS
+#define QN8066_AF_SETS 3          //<! Number of PIs with an AF set (the least recently used set is replaced)
+#endif
+#ifndef QN8066_AF_PER_PI
+#define QN8066_AF_PER_PI 12       //<! Frequencies per PI
+#endif
+#define QN8066_AF_PENALTY 8       //<! Probes skipped by an AF after a switch with the wrong PI
+#define QN8066_AF_PROBE_OVERHEAD (5 * QN8066_DELAY_COMMAND / 1000)   //<! Mute time in ms of the I2C transactions of a probe
+
+#define AF_EVENT_LEARNED 1        //<! New frequencies were added to the AF set of the current PI
+#define AF_EVENT_PROBED 2         //<! An AF was measured (audio muted for a short time)
+#define AF_EVENT_SWITCHED 4       //<! The receiver switched to an AF and the PI was verified
+#define AF_EVENT_REVERTED 8       //<! The AF did not have the same PI. The receiver went back to the previous frequency
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Alternative Frequency of an AF set
+ */
+typedef struct {
+  uint16_t frequency;   //!< MHz x 10
+  uint8_t rssi;         //!< RSSI of the last probe (0 = not probed yet)
+  uint8_t penalty;      //!< Probes to be skipped (see QN8066_AF_PENALTY)
+} qn8066_af_entry;
+
+/**
+ * @ingroup group12 AF Following
+ * @brief Alternative Frequencies of a PI
+ */
+typedef struct {
+  uint16_t pi;          //!< 0 = free set
+  uint8_t count;        //!< Number of frequencies
+  uint8_t next;         //!< Next frequency to be probed
+  uint32_t used;        //!< millis() of the last use (least recently used set is replaced)
+  qn8066_af_entry af[QN8066_AF_PER_PI];
+} qn8066_af_set;
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066AFFollower Class - RX Alternative Frequency following
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsDecoder.h>
+ * #include <QN8066AFFollower.h>
+ * QN8066 rx;
+ * QN8066RdsDecoder rds;
+ * QN8066AFFollower af;
+ * void setup() {
+ *   rx.setRX(1069);
+ *   rx.rdsRxEnable(true);
+ *   rds.begin(&rx);
+ *   af.begin(&rx, &rds);            // 6 dB margin; one probe every 2 s; up to about 25 ms muted per probe
+ *   af.setProbeThreshold(30);       // Probes only when the RSSI is below 30
+ * }
+ * void loop() {
+ *   rds.process();
+ *   if ( af.process() & AF_EVENT_SWITCHED ) showFrequency(rx.getRxCurrentFrequency());
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066AFFollower {
+private:
+  QN8066 *rx = NULL;
+  QN8066RdsDecoder *rds = NULL;
+  qn8066_af_set sets[QN8066_AF_SETS];
+  int8_t current = -1;           //!< Set of the PI being received (-1 = PI not known yet)
+  uint16_t home = 0;             //!< Frequency being listened
+  uint8_t merged = 0;            //!< AF codes of the RDS decoder already added to the set
+
+  uint8_t margin = 6;            //!< RSSI hysteresis (dB) to switch to an AF
+  uint8_t probeBelow = 0xFF;     //!< Probes only when the RSSI is below this value (0xFF = always)
+  uint8_t maxSettle = 8;         //!< Maximum AGC wait of a probe in ms (maxMute - QN8066_AF_PROBE_OVERHEAD)
+  uint16_t probeInterval = 2000; //!< Time in ms between probes
+  uint16_t measureInterval = 250;//!< Time in ms between RSSI/SNR reads of the current frequency
+  uint16_t verifyTimeout = 1000; //!< Time in ms waiting for the PI after a switch
+  uint32_t lastProbe = 0;
+  uint32_t lastMeasure = 0;
+
+  uint8_t rssi = 0;              //!< Smoothed RSSI of the current frequency
+  uint8_t snr = 0;               //!< Smoothed SNR of the current frequency
+  uint8_t samples = 0;           //!< Samples of the current frequency (up to 255)
+
+  bool verifying = false;        //!< true = waiting for the PI after a switch
+  uint16_t previous = 0;         //!< Frequency restored if the PI is not verified
+  uint32_t verifyStart = 0;
+  qn8066_af_entry *candidate = NULL;
+
+  uint16_t probes = 0;
+  uint16_t switches = 0;
+  uint16_t reverts = 0;
+  uint32_t muteTotal = 0;        //!< Sum of the mute time of the probes (us)
+  uint32_t muteMax = 0;          //!< Longest mute time of a probe (us)
+
+  int8_t findSet(uint16_t pi, bool create);
+  qn8066_af_entry *nextCandidate();
+  void measure();
+  void restart(uint16_t frequency);
+
+public:
+  void begin(QN8066 *rx, QN8066RdsDecoder *rds, uint8_t margin = 6, uint16_t probeInterval = 2000, uint8_t maxMute = 25);
+  uint8_t process();
+  bool addAF(uint16_t pi, uint16_t frequency);
+  uint8_t getAF(uint16_t pi, uint16_t *list, uint8_t size);
+  void clear();
+
+  /**
+   * @ingroup group12 AF Following
+   * @brief Probes only when the RSSI of the current frequency is below the given value
+   * @details Each probe mutes the audio for a short time. Use a threshold so a good signal is never interrupted.
+   * @param rssi - RSSI threshold (0xFF = always probes; 0 = never probes)
+   */
+  inline void setProbeThreshold(uint8_t rssi) {this->probeBelow = rssi;};
+  inline void setVerifyTimeout(uint16_t ms) {this->verifyTimeout = ms;};   //!< Time waiting for the PI after a switch (default 1000 ms)
+  inline bool isVerifying() {return this->verifying;};                     //!< true while the PI of an AF is being checked
+  inline uint8_t getRSSI() {return this->rssi;};                           //!< Smoothed RSSI of the current frequency
+  inline uint8_t getSNR() {return this->snr;};                             //!< Smoothed SNR of the current frequency
+  inline uint16_t getProbes() {return this->probes;};                      //!< Number of probes since begin
+  inline uint16_t getSwitches() {return this->switches;};                  //!< Switches with the PI verified
+  inline uint16_t getReverts() {return this->reverts;};                    //!< Switches undone (wrong PI or no PI)
+  inline uint32_t getMuteMax() {return this->muteMax;};                    //!< Longest mute time of a probe (us)
+  inline uint32_t getMuteAverage() {return (this->probes) ? this->muteTotal / this->probes : 0;};   //!< Average mute time of a probe (us)
+};
+
+#endif // _QN8066_AF_FOLLOWER_H
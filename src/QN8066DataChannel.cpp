@@ -0,0 +1,326 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RDS data channel
+ *
+ * @details Transmitter (QN8066DataChannel) and reassembler (QN8066DataReceiver) of the RDS data channel.
+ * @details See QN8066DataChannel.h for the group format.
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066DataChannel.h>
+
+/** @defgroup group07 Data Channel RDS data channel */
+
+static QN8066DataChannel *dataChannels[QN8066_ODA_MAX];  // Channel of each ODA registry entry (used by the ODA callback)
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Registers the data channel as an Open Data Application
+ * @param rds - RDS encoder (QN8066RdsEncoder::begin must be called first)
+ * @param aid - Application Identification announced in the group 3A
+ * @param groupType - group type of the data groups (default 8 - 8A). Version A only (in B groups, block 3 is the PI). See QN8066RdsEncoder::registerODA.
+ * @param interval - one data group every interval groups (default 2 - about 5.7 groups/s, half of the RDS capacity)
+ * @return false if the ODA registry is full or the group type is not valid
+ * @see send, QN8066RdsEncoder::registerODA, QN8066RdsEncoder::process
+ */
+bool QN8066DataChannel::begin(QN8066RdsEncoder *rds, uint16_t aid, uint8_t groupType, uint16_t interval) {
+  int8_t idx;
+
+  this->rds = rds;
+  this->aid = aid;
+  idx = rds->registerODA(aid, groupType, 0, QN8066DataChannel::odaCallback, 0, interval);
+  if ( idx < 0 ) return false;
+  dataChannels[idx] = this;
+  return true;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief ODA callback. Finds the channel of the AID and gets its next group.
+ */
+bool QN8066DataChannel::odaCallback(uint16_t aid, RDS_GROUP *group) {
+  for ( uint8_t i = 0; i < QN8066_ODA_MAX; i++ ) {
+    if ( dataChannels[i] != NULL && dataChannels[i]->aid == aid )
+      return dataChannels[i]->nextGroup(group);
+  }
+  return false;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Starts sending a file
+ * @details The file is sent as a carousel: header, stripes of data and parity groups and the CRC group, again and again.
+ * @details The file is not copied. Each call increments the file id, so the receivers know that it is a new file.
+ * @param data - file content
+ * @param length - file size (up to QN8066_DATA_MAX_FILE for QN8066DataReceiver)
+ * @param k - number of fragments protected by each parity group (2-15; default 4 => 25% of overhead)
+ * @param depth - interleaving depth: parity groups per stripe (1-15; default 4). A burst of up to depth lost groups is corrected.
+ * @param repeat - number of carousel cycles (0 = forever)
+ * @return false if the parameters are not valid or the file is too big (the group number has 12 bits)
+ */
+bool QN8066DataChannel::send(const uint8_t *data, uint16_t length, uint8_t k, uint8_t depth, uint8_t repeat) {
+  uint16_t fragments = (length + QN8066_DATA_FRAGMENT - 1) / QN8066_DATA_FRAGMENT;
+  uint16_t stripeData = (uint16_t) k * depth;
+
+  if ( data == NULL || length == 0 || k < 2 || k > 15 || depth < 1 || depth > 15 ) return false;
+  if ( (uint32_t) ((fragments + stripeData - 1) / stripeData) * (stripeData + depth) > 4096 ) return false;
+
+  this->data = data;
+  this->length = length;
+  this->fragments = fragments;
+  this->k = k;
+  this->depth = depth;
+  this->repeat = repeat;
+  this->crc = crc16(data, length);
+  this->fileId++;
+  this->cycles = 0;
+  this->stripe = 0;
+  this->position = -1;
+  this->endOfCycle = false;
+  return true;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Stops sending the current file
+ */
+void QN8066DataChannel::stop() {
+  this->data = NULL;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Gets the 3 bytes of a fragment (completed with zeros after the end of the file)
+ */
+void QN8066DataChannel::fragment(uint16_t index, uint8_t *bytes) {
+  uint16_t pos = index * QN8066_DATA_FRAGMENT;
+
+  for ( uint8_t i = 0; i < QN8066_DATA_FRAGMENT; i++, pos++ )
+    bytes[i] = (pos < this->length) ? this->data[pos] : 0;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Builds the next group of the carousel
+ * @details Called by QN8066RdsEncoder::process (through the ODA registry). It can also be called directly, for example, to test a receiver.
+ * @param group - the 5 bits of the block 2 and the blocks 3 and 4
+ * @return false if there is no file to send
+ */
+bool QN8066DataChannel::nextGroup(RDS_GROUP *group) {
+  uint16_t stripeData = (uint16_t) this->k * this->depth;
+  uint16_t stripes = (this->fragments + stripeData - 1) / stripeData;
+  uint16_t n, first;
+  uint8_t bytes[QN8066_DATA_FRAGMENT];
+
+  if ( this->data == NULL ) return false;
+
+  if ( this->endOfCycle ) {
+    group->blockB = 0x10 | QN8066_DATA_END;
+    group->blockC = (uint16_t) this->fileId << 8;
+    group->blockD = this->crc;
+    this->endOfCycle = false;
+    this->stripe = 0;
+    this->position = -1;
+    if ( ++this->cycles == this->repeat ) this->data = NULL;  // repeat = 0 => forever
+    return true;
+  }
+
+  if ( this->position < 0 ) {
+    group->blockB = 0x10 | QN8066_DATA_HEADER;
+    group->blockC = ((uint16_t) this->fileId << 8) | (this->k << 4) | this->depth;
+    group->blockD = this->length;
+    this->position = 0;
+    return true;
+  }
+
+  first = this->stripe * stripeData;
+  // Skips the positions after the end of the file (last stripe)
+  while ( this->position < stripeData && first + this->position >= this->fragments ) this->position++;
+
+  n = this->stripe * (stripeData + this->depth) + this->position;
+  if ( this->position < stripeData ) {
+    this->fragment(first + this->position, bytes);
+  } else {
+    // Parity of the set j: fragments j, j + depth, j + 2 * depth ...
+    uint8_t j = this->position - stripeData;
+    bytes[0] = bytes[1] = bytes[2] = 0;
+    for ( uint16_t f = first + j; f < first + stripeData && f < this->fragments; f += this->depth ) {
+      uint8_t aux[QN8066_DATA_FRAGMENT];
+      this->fragment(f, aux);
+      for ( uint8_t i = 0; i < QN8066_DATA_FRAGMENT; i++ ) bytes[i] ^= aux[i];
+    }
+  }
+
+  group->blockB = (n >> 8) & 0x0F;
+  group->blockC = ((n & 0xFF) << 8) | bytes[0];
+  group->blockD = ((uint16_t) bytes[1] << 8) | bytes[2];
+
+  if ( ++this->position >= stripeData + this->depth ) {
+    this->position = -1;
+    if ( ++this->stripe >= stripes ) this->endOfCycle = true;
+  }
+  return true;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief CRC-16 CCITT (initial value 0xFFFF) of the file
+ */
+uint16_t QN8066DataChannel::crc16(const uint8_t *data, uint16_t length) {
+  uint16_t crc = 0xFFFF;
+
+  for ( uint16_t i = 0; i < length; i++ ) {
+    crc ^= (uint16_t) data[i] << 8;
+    for ( uint8_t b = 0; b < 8; b++ )
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Starts the reassembler
+ * @param groupType - group type of the data channel (default 8 - 8A)
+ */
+void QN8066DataReceiver::begin(uint8_t groupType) {
+  this->groupCode = (groupType & 0x0F) << 1;
+  this->headerReceived = false;
+  this->reset();
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Clears the fragments received
+ */
+void QN8066DataReceiver::reset() {
+  memset(this->received, 0, sizeof(this->received));
+  memset(this->parityReceived, 0, sizeof(this->parityReceived));
+  this->crcReceived = false;
+  this->complete = false;
+  this->fragmentCount = 0;
+  this->recovered = 0;
+  this->groups = 0;
+  this->groupsToComplete = 0;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Stores a fragment
+ */
+void QN8066DataReceiver::store(uint16_t index, const uint8_t *bytes) {
+  memcpy(&this->buffer[index * QN8066_DATA_FRAGMENT], bytes, QN8066_DATA_FRAGMENT);
+  this->received[index >> 3] |= (1 << (index & 7));
+  this->fragmentCount++;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Recovers the only lost fragment of a parity set (if there is just one and the parity was received)
+ * @param set - parity set (stripe * depth + j)
+ */
+void QN8066DataReceiver::recover(uint16_t set) {
+  uint16_t stripeData = (uint16_t) this->k * this->depth;
+  uint16_t first = (set / this->depth) * stripeData;
+  uint16_t missing = 0xFFFF;
+  uint8_t bytes[QN8066_DATA_FRAGMENT];
+
+  if ( !(this->parityReceived[set >> 3] & (1 << (set & 7))) ) return;
+
+  memcpy(bytes, this->parity[set], QN8066_DATA_FRAGMENT);
+  for ( uint16_t f = first + set % this->depth; f < first + stripeData && f < this->fragments; f += this->depth ) {
+    if ( this->received[f >> 3] & (1 << (f & 7)) ) {
+      for ( uint8_t i = 0; i < QN8066_DATA_FRAGMENT; i++ ) bytes[i] ^= this->buffer[f * QN8066_DATA_FRAGMENT + i];
+    } else {
+      if ( missing != 0xFFFF ) return;  // Two or more lost fragments
+      missing = f;
+    }
+  }
+  if ( missing == 0xFFFF ) return;
+  this->store(missing, bytes);
+  this->recovered++;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Processes a group received
+ * @details Groups of other types are ignored, so all groups received by the RDS decoder can be passed here.
+ * @param blockB - block 2
+ * @param blockC - block 3
+ * @param blockD - block 4
+ * @return true when the file is complete (all fragments received and right CRC)
+ */
+bool QN8066DataReceiver::feed(uint16_t blockB, uint16_t blockC, uint16_t blockD) {
+  uint8_t bytes[QN8066_DATA_FRAGMENT];
+
+  if ( (blockB >> 11) != this->groupCode ) return this->complete;
+  this->groups++;
+
+  if ( blockB & 0x10 ) {
+    uint8_t id = blockC >> 8;
+    if ( (blockB & 0x0F) == QN8066_DATA_HEADER ) {
+      uint8_t k = (blockC >> 4) & 0x0F, depth = blockC & 0x0F;
+      if ( k < 2 || depth < 1 || blockD == 0 || blockD > QN8066_DATA_MAX_FILE ) return this->complete;
+      if ( !this->headerReceived || id != this->fileId || k != this->k || depth != this->depth || blockD != this->length ) {
+        // New file
+        this->fileId = id;
+        this->k = k;
+        this->depth = depth;
+        this->length = blockD;
+        this->fragments = (blockD + QN8066_DATA_FRAGMENT - 1) / QN8066_DATA_FRAGMENT;
+        this->headerReceived = true;
+        this->reset();
+        this->groups = 1;
+      }
+    } else if ( (blockB & 0x0F) == QN8066_DATA_END && this->headerReceived && id == this->fileId ) {
+      this->crc = blockD;
+      this->crcReceived = true;
+    }
+  } else if ( this->headerReceived && !this->complete ) {
+    uint16_t stripeData = (uint16_t) this->k * this->depth;
+    uint16_t n = ((blockB & 0x0F) << 8) | (blockC >> 8);
+    uint16_t stripe = n / (stripeData + this->depth);
+    uint16_t pos = n % (stripeData + this->depth);
+    uint16_t set;
+
+    bytes[0] = blockC & 0xFF;
+    bytes[1] = blockD >> 8;
+    bytes[2] = blockD & 0xFF;
+
+    if ( pos < stripeData ) {
+      uint16_t f = stripe * stripeData + pos;
+      if ( f >= this->fragments ) return false;
+      if ( !(this->received[f >> 3] & (1 << (f & 7))) ) this->store(f, bytes);
+      set = stripe * this->depth + pos % this->depth;
+    } else {
+      set = stripe * this->depth + (pos - stripeData);
+      if ( set >= QN8066_DATA_MAX_SETS ) return false;
+      memcpy(this->parity[set], bytes, QN8066_DATA_FRAGMENT);
+      this->parityReceived[set >> 3] |= (1 << (set & 7));
+    }
+    this->recover(set);
+  }
+
+  if ( !this->complete && this->headerReceived && this->crcReceived && this->fragmentCount >= this->fragments ) {
+    if ( QN8066DataChannel::crc16(this->buffer, this->length) == this->crc ) {
+      this->complete = true;
+      this->groupsToComplete = this->groups;
+    } else {
+      this->reset();  // Wrong data (Example: undetected RDS errors). Starts again with the next cycle.
+    }
+  }
+  return this->complete;
+}
+
+/**
+ * @ingroup group07 Data Channel
+ * @brief Effective goodput of the last file received
+ * @details Goodput = file size / (data channel groups received / groups per second). It includes the headers, parity groups, 
+ * @details repeated cycles needed to fill the gaps etc. The RDS capacity is about 11.4 groups/s; if the data channel uses one 
+ * @details group in two (interval 2), use 57.
+ * @param groupsPerSecond10 - data channel groups per second x 10 (default 114 => 11.4 groups/s)
+ * @return goodput in bits per second (0 if the file is not complete)
+ */
+uint32_t QN8066DataReceiver::getGoodput(uint16_t groupsPerSecond10) {
+  if ( !this->complete || this->groupsToComplete == 0 ) return 0;
+  return ((uint32_t) this->length * 8 * groupsPerSecond10) / (this->groupsToComplete * 10);
+}
@@ -0,0 +1,166 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RDS data channel
+ *
+ * @details This file contains a small file transfer protocol over an RDS Open Data Application (ODA) group.
+ * @details It is used to send schedules, configuration blobs and other small files to receivers in the field.
+ * @details The transmitter side (QN8066DataChannel) uses the ODA registry of the RDS encoder (QN8066RdsEncoder::registerODA),
+ * @details so the data groups are interleaved with the PS and RT groups by QN8066RdsEncoder::process. The receiver side (QN8066DataReceiver) rebuilds
+ * @details the file from the groups received by any RDS decoder.
+ * @details
+ * @details Group format (37 bits: 5 bits of the block 2 + blocks 3 and 4):
+ * | Block 2 (5 bits) | Block 3                  | Block 4             | Description                          |
+ * | ---------------- | ------------------------ | ------------------- | ------------------------------------ |
+ * | 0 n[11:8]        | n[7:0] byte0             | byte1 byte2         | Data or parity group number n         |
+ * | 1 0000           | file id, K (4), D (4)    | file length         | Header (sent before each stripe)      |
+ * | 1 0001           | file id, 0               | CRC-16 of the file  | End of a carousel cycle               |
+ * @details The file is split in fragments of 3 bytes. The fragments are organized in stripes of K x D fragments followed
+ * @details by D parity groups. The parity j (0 to D-1) is the XOR of the fragments j, j + D, j + 2D... of the stripe.
+ * @details So, a burst of up to D lost groups is always corrected, and the carousel fills the other gaps in the next cycles.
+ * @details
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_DATA_CHANNEL_H // Prevent this file from being compiled more than once
+#define _QN8066_DATA_CHANNEL_H
+
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+
+#define QN8066_DATA_FRAGMENT 3        //<! Bytes per data group
+#define QN8066_DATA_MAX_FILE 1024     //<! Maximum file size handled by QN8066DataReceiver
+#define QN8066_DATA_MAX_FRAGMENTS ((QN8066_DATA_MAX_FILE + QN8066_DATA_FRAGMENT - 1) / QN8066_DATA_FRAGMENT)
+#define QN8066_DATA_MAX_SETS (QN8066_DATA_MAX_FRAGMENTS / 2 + 16)  //<! Parity sets (K >= 2)
+#define QN8066_DATA_HEADER 0          //<! Control group: header
+#define QN8066_DATA_END 1             //<! Control group: end of cycle (CRC)
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066DataChannel Class - RDS data channel transmitter
+ * @details Sends a file as a carousel of ODA data groups (version A). The file is not copied, so it must not change while it is sent.
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsEncoder.h>
+ * #include <QN8066DataChannel.h>
+ * QN8066 tx;
+ * QN8066RdsEncoder rds;
+ * QN8066DataChannel channel;
+ * const char schedule[] = "06:00 MORNING SHOW;10:00 NEWS;12:00 TOP 40";
+ * void setup() {
+ *   tx.setup();
+ *   tx.setTX(1069); // Set the transmitter to 106.9 MHz
+ *   tx.rdsTxEnable(true);
+ *   tx.rdsInitTx(0x8,0x1,0x9B);
+ *   rds.begin(&tx);
+ *   channel.begin(&rds, 0xCD46, 8);  // Your AID; data in the group 8A
+ *   channel.send((const uint8_t *) schedule, sizeof(schedule));
+ * }
+ * void loop() {
+ *   rds.process();
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066DataChannel {
+private:
+  QN8066RdsEncoder *rds = NULL;
+  uint16_t aid = 0;
+  const uint8_t *data = NULL;
+  uint16_t length = 0;
+  uint16_t fragments = 0;        //!< Number of 3 bytes fragments of the file
+  uint8_t k = 4;                 //!< Fragments per parity set
+  uint8_t depth = 4;             //!< Parity sets per stripe (interleaving depth)
+  uint8_t fileId = 0;
+  uint16_t crc = 0;
+  uint8_t repeat = 0;            //!< Number of carousel cycles (0 = forever)
+  uint16_t cycles = 0;           //!< Carousel cycles sent
+  uint16_t stripe = 0;           //!< Current stripe
+  int16_t position = -1;         //!< Position in the stripe (-1 = header)
+  bool endOfCycle = false;       //!< true = the next group is the end of cycle (CRC)
+
+  void fragment(uint16_t index, uint8_t *bytes);
+  static bool odaCallback(uint16_t aid, RDS_GROUP *group);
+
+public:
+  bool begin(QN8066RdsEncoder *rds, uint16_t aid, uint8_t groupType = 8, uint16_t interval = 2);
+  bool send(const uint8_t *data, uint16_t length, uint8_t k = 4, uint8_t depth = 4, uint8_t repeat = 0);
+  bool nextGroup(RDS_GROUP *group);
+  void stop();
+
+  static uint16_t crc16(const uint8_t *data, uint16_t length);
+
+  /**
+   * @ingroup group07 Data Channel
+   * @brief Number of carousel cycles sent since the last send()
+   */
+  inline uint16_t getCycles() {return this->cycles;};
+
+  /**
+   * @ingroup group07 Data Channel
+   * @brief Returns true while the file is being sent
+   */
+  inline bool isSending() {return this->data != NULL;};
+};
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066DataReceiver Class - RDS data channel reassembler
+ * @details Rebuilds the file from the groups received (any order, with losses). It uses the parity groups to recover
+ * @details lost fragments and checks the CRC-16 sent at the end of each carousel cycle. It has fixed size buffers
+ * @details (about 1.6 KB for QN8066_DATA_MAX_FILE = 1024), so it is meant for a PC or a 32 bits board.
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066DataReceiver {
+private:
+  uint8_t groupCode = 0;                                  //!< Group type and version A (5 bits) of the data channel
+  uint8_t buffer[QN8066_DATA_MAX_FILE + QN8066_DATA_FRAGMENT];
+  uint8_t received[(QN8066_DATA_MAX_FRAGMENTS + 7) / 8];  //!< Fragments received (bitmap)
+  uint8_t parity[QN8066_DATA_MAX_SETS][QN8066_DATA_FRAGMENT];
+  uint8_t parityReceived[(QN8066_DATA_MAX_SETS + 7) / 8];
+  bool headerReceived = false;
+  bool crcReceived = false;
+  bool complete = false;
+  uint8_t fileId = 0;
+  uint8_t k = 0;
+  uint8_t depth = 0;
+  uint16_t length = 0;
+  uint16_t fragments = 0;
+  uint16_t crc = 0;
+  uint16_t fragmentCount = 0;    //!< Fragments received or recovered
+  uint16_t recovered = 0;        //!< Fragments recovered by the parity groups
+  uint32_t groups = 0;           //!< Data channel groups seen since the current file started
+  uint32_t groupsToComplete = 0;
+
+  void reset();
+  void store(uint16_t index, const uint8_t *bytes);
+  void recover(uint16_t set);
+
+public:
+  void begin(uint8_t groupType = 8);
+  bool feed(uint16_t blockB, uint16_t blockC, uint16_t blockD);
+  uint32_t getGoodput(uint16_t groupsPerSecond10 = 114);
+
+  /**
+   * @ingroup group07 Data Channel
+   * @brief Returns true when the whole file was received and the CRC is right
+   */
+  inline bool isComplete() {return this->complete;};
+  inline const uint8_t *getData() {return this->buffer;};
+  inline uint16_t getLength() {return this->length;};
+  inline uint8_t getFileId() {return this->fileId;};
+  inline uint16_t getRecovered() {return this->recovered;};
+  inline uint32_t getGroups() {return this->groupsToComplete ? this->groupsToComplete : this->groups;};
+  /**
+   * @ingroup group07 Data Channel
+   * @brief Percentage of the file already received (0-100)
+   */
+  inline uint8_t getProgress() {return (this->fragments) ? (uint32_t) this->fragmentCount * 100 / this->fragments : 0;};
+};
+
+#endif // _QN8066_DATA_CHANNEL_H
@@ -0,0 +1,159 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RDS bit level reference coder
+ *
+ * @details Checkword, offset words, group packing (104 bits), group checking and subcarrier modulation.
+ * @see EN 50067 / IEC 62106 - Specification of the radio data system (RDS) - Annex B
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066RDSCoder.h>
+
+/** @defgroup group08 RDS bit level reference coder */
+
+/**
+ * @brief CRC-10 table: x^10 * i mod g(x) for each byte value i (g(x) = x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1)
+ */
+static const uint16_t crcTable[256] PROGMEM = {
+  0x000, 0x1B9, 0x372, 0x2CB, 0x35D, 0x2E4, 0x02F, 0x196,
+  0x303, 0x2BA, 0x071, 0x1C8, 0x05E, 0x1E7, 0x32C, 0x295,
+  0x3BF, 0x206, 0x0CD, 0x174, 0x0E2, 0x15B, 0x390, 0x229,
+  0x0BC, 0x105, 0x3CE, 0x277, 0x3E1, 0x258, 0x093, 0x12A,
+  0x2C7, 0x37E, 0x1B5, 0x00C, 0x19A, 0x023, 0x2E8, 0x351,
+  0x1C4, 0x07D, 0x2B6, 0x30F, 0x299, 0x320, 0x1EB, 0x052,
+  0x178, 0x0C1, 0x20A, 0x3B3, 0x225, 0x39C, 0x157, 0x0EE,
+  0x27B, 0x3C2, 0x109, 0x0B0, 0x126, 0x09F, 0x254, 0x3ED,
+  0x037, 0x18E, 0x345, 0x2FC, 0x36A, 0x2D3, 0x018, 0x1A1,
+  0x334, 0x28D, 0x046, 0x1FF, 0x069, 0x1D0, 0x31B, 0x2A2,
+  0x388, 0x231, 0x0FA, 0x143, 0x0D5, 0x16C, 0x3A7, 0x21E,
+  0x08B, 0x132, 0x3F9, 0x240, 0x3D6, 0x26F, 0x0A4, 0x11D,
+  0x2F0, 0x349, 0x182, 0x03B, 0x1AD, 0x014, 0x2DF, 0x366,
+  0x1F3, 0x04A, 0x281, 0x338, 0x2AE, 0x317, 0x1DC, 0x065,
+  0x14F, 0x0F6, 0x23D, 0x384, 0x212, 0x3AB, 0x160, 0x0D9,
+  0x24C, 0x3F5, 0x13E, 0x087, 0x111, 0x0A8, 0x263, 0x3DA,
+  0x06E, 0x1D7, 0x31C, 0x2A5, 0x333, 0x28A, 0x041, 0x1F8,
+  0x36D, 0x2D4, 0x01F, 0x1A6, 0x030, 0x189, 0x342, 0x2FB,
+  0x3D1, 0x268, 0x0A3, 0x11A, 0x08C, 0x135, 0x3FE, 0x247,
+  0x0D2, 0x16B, 0x3A0, 0x219, 0x38F, 0x236, 0x0FD, 0x144,
+  0x2A9, 0x310, 0x1DB, 0x062, 0x1F4, 0x04D, 0x286, 0x33F,
+  0x1AA, 0x013, 0x2D8, 0x361, 0x2F7, 0x34E, 0x185, 0x03C,
+  0x116, 0x0AF, 0x264, 0x3DD, 0x24B, 0x3F2, 0x139, 0x080,
+  0x215, 0x3AC, 0x167, 0x0DE, 0x148, 0x0F1, 0x23A, 0x383,
+  0x059, 0x1E0, 0x32B, 0x292, 0x304, 0x2BD, 0x076, 0x1CF,
+  0x35A, 0x2E3, 0x028, 0x191, 0x007, 0x1BE, 0x375, 0x2CC,
+  0x3E6, 0x25F, 0x094, 0x12D, 0x0BB, 0x102, 0x3C9, 0x270,
+  0x0E5, 0x15C, 0x397, 0x22E, 0x3B8, 0x201, 0x0CA, 0x173,
+  0x29E, 0x327, 0x1EC, 0x055, 0x1C3, 0x07A, 0x2B1, 0x308,
+  0x19D, 0x024, 0x2EF, 0x356, 0x2C0, 0x379, 0x1B2, 0x00B,
+  0x121, 0x098, 0x253, 0x3EA, 0x27C, 0x3C5, 0x10E, 0x0B7,
+  0x222, 0x39B, 0x150, 0x0E9, 0x17F, 0x0C6, 0x20D, 0x3B4
+};
+
+/**
+ * @brief Offset words in the order of the blocks (A, B, C, D) followed by C'
+ */
+static const uint16_t offsetWords[5] = {RDS_OFFSET_A, RDS_OFFSET_B, RDS_OFFSET_C, RDS_OFFSET_D, RDS_OFFSET_CP};
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Computes the CRC-10 of an information word (16 bits)
+ * @details Table driven: one table lookup per byte.
+ * @param data - information word
+ * @return CRC (10 bits)
+ */
+uint16_t QN8066RDSCoder::crc(uint16_t data) {
+  uint16_t r;
+  r = pgm_read_word(&crcTable[data >> 8]);
+  r = ((r << 8) & 0x3FF) ^ pgm_read_word(&crcTable[((r >> 2) ^ data) & 0xFF]);
+  return r;
+}
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Computes the checkword of a block
+ * @param data - information word
+ * @param offset - offset word of the block (RDS_OFFSET_A, RDS_OFFSET_B, RDS_OFFSET_C, RDS_OFFSET_CP or RDS_OFFSET_D)
+ * @return checkword (10 bits)
+ */
+uint16_t QN8066RDSCoder::checkword(uint16_t data, uint16_t offset) {
+  return crc(data) ^ offset;
+}
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Finds the offset word of a received block
+ * @details The syndrome of a block without errors is its offset word. No error correction is done here.
+ * @param block - 26 bits (information word in the bits 25-10 and checkword in the bits 9-0)
+ * @return offset word (RDS_OFFSET_*) or -1 if the block is not valid
+ */
+int16_t QN8066RDSCoder::offsetOf(uint32_t block) {
+  uint16_t syndrome = crc(block >> 10) ^ (block & 0x3FF);
+  for (uint8_t i = 0; i < 5; i++) {
+    if ( syndrome == offsetWords[i] ) return syndrome;
+  }
+  return -1;
+}
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Builds the 104 bits of a group
+ * @details The block 3 uses the offset word C' in the version B groups (bit 11 of the block 2).
+ * @param blockA, blockB, blockC, blockD - information words
+ * @param bits - RDS_GROUP_BYTES bytes; the first bit sent is the most significant bit of bits[0]
+ */
+void QN8066RDSCoder::encodeGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD, uint8_t *bits) {
+  uint16_t data[4] = {blockA, blockB, blockC, blockD};
+  uint8_t index = 0;
+
+  memset(bits, 0, RDS_GROUP_BYTES);
+  for (uint8_t i = 0; i < 4; i++) {
+    uint16_t offset = (i == 2 && (blockB & 0x0800)) ? RDS_OFFSET_CP : offsetWords[i];
+    uint32_t block = ((uint32_t) data[i] << 10) | checkword(data[i], offset);
+    for (int8_t k = 25; k >= 0; k--, index++) {
+      if ( (block >> k) & 1 ) bits[index >> 3] |= 0x80 >> (index & 7);
+    }
+  }
+}
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Checks a group built by encodeGroup (or received)
+ * @param bits - RDS_GROUP_BYTES bytes
+ * @param blocks - returns the four information words
+ * @return one bit per valid block (bit 0 = block 1). 0B1111 means that the whole group is valid.
+ */
+uint8_t QN8066RDSCoder::decodeGroup(const uint8_t *bits, uint16_t *blocks) {
+  uint8_t valid = 0, index = 0;
+
+  for (uint8_t i = 0; i < 4; i++) {
+    uint32_t block = 0;
+    for (uint8_t k = 0; k < 26; k++, index++) block = (block << 1) | getBit(bits, index);
+    blocks[i] = block >> 10;
+    uint16_t expected = (i == 2 && (blocks[1] & 0x0800)) ? RDS_OFFSET_CP : offsetWords[i];
+    if ( offsetOf(block) == (int16_t) expected ) valid |= 1 << i;
+  }
+  return valid;
+}
+
+/**
+ * @ingroup group08 RDS Coder
+ * @brief Modulates one bit on the 57 kHz subcarrier at 171 kHz (RDS_MPX_RATE)
+ * @details The bit is differentially coded and sent as a biphase symbol (rectangular, without the cosine shaping 
+ * @details filter). The samples can be saved as 16 bits mono PCM to be read by RDS decoders that accept MPX input.
+ * @param bit - next bit of the bitstream (see encodeGroup and getBit)
+ * @param samples - returns RDS_SAMPLES_PER_BIT samples
+ * @param amplitude - peak value of the subcarrier
+ * @return number of samples (RDS_SAMPLES_PER_BIT)
+ */
+uint16_t QN8066RDSCoder::modulate(uint8_t bit, int16_t *samples, int16_t amplitude) {
+  // Three samples per subcarrier period: sin(0), sin(120) and sin(240)
+  int16_t peak = (int16_t) (((int32_t) amplitude * 887) >> 10);  // amplitude x sin(120)
+  int16_t carrier[3] = {0, peak, (int16_t) -peak};
+
+  this->lastBit ^= bit & 1;
+  for (uint16_t n = 0; n < RDS_SAMPLES_PER_BIT; n++) {
+    int16_t value = carrier[n % 3];
+    samples[n] = ( (n < RDS_SAMPLES_PER_BIT / 2) == (this->lastBit == 1) ) ? value : -value;
+  }
+  return RDS_SAMPLES_PER_BIT;
+}
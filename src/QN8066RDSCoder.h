@@ -0,0 +1,94 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RDS bit level reference coder
+ *
+ * @details The QN8066 receives only the 8 data bytes of a group and adds the checkwords itself. This file contains a
+ * @details software reference of what the chip puts on air: the 104 bits group (4 blocks of 16 data bits + 10 bits
+ * @details checkword + offset word), a decoder that checks it and a modulator that produces the RDS subcarrier at the
+ * @details MPX sample rate (171 kHz). With the group monitor of the QN8066 class (rdsSetGroupMonitor) you can check,
+ * @details on the host or on the MCU, that every group sent is valid RDS, and feed standard RDS decoders with the result.
+ * @details
+ * @details Block format (26 bits): | information word (16 bits) | checkword (10 bits) |
+ * @details The checkword is the CRC-10 of the information word (g(x) = x^10 + x^8 + x^7 + x^5 + x^4 + x^3 + 1) XOR
+ * @details the offset word of the block (A, B, C or C' and D).
+ * @see EN 50067 / IEC 62106 - Specification of the radio data system (RDS) - Annex B
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_RDS_CODER_H // Prevent this file from being compiled more than once
+#define _QN8066_RDS_CODER_H
+
+#include <QN8066.h>
+
+#define RDS_OFFSET_A 0x0FC          //<! Offset word of the block 1
+#define RDS_OFFSET_B 0x198          //<! Offset word of the block 2
+#define RDS_OFFSET_C 0x168          //<! Offset word of the block 3 (version A)
+#define RDS_OFFSET_CP 0x350         //<! Offset word of the block 3 (version B - C')
+#define RDS_OFFSET_D 0x1B4          //<! Offset word of the block 4
+
+#define RDS_GROUP_BITS 104          //<! Bits per group (4 x 26)
+#define RDS_GROUP_BYTES 13          //<! Bytes used by a packed group (see encodeGroup)
+#define RDS_MPX_RATE 171000UL       //<! Sample rate of the modulated subcarrier (3 x 57 kHz)
+#define RDS_SAMPLES_PER_BIT 144     //<! 171000 / 1187.5
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066RDSCoder Class - RDS bit level reference coder
+ * @details The static functions (checkword, encodeGroup, decodeGroup) have no state. An instance is only needed to
+ * @details modulate a bitstream, because of the differential coding.
+ * @details Example (checks every group sent by the QN8066)
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RDSCoder.h>
+ * QN8066 tx;
+ * uint32_t badGroups = 0;
+ * void monitor(uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+ *   uint8_t bits[RDS_GROUP_BYTES];
+ *   uint16_t blocks[4];
+ *   QN8066RDSCoder::encodeGroup(a, b, c, d, bits);
+ *   if ( QN8066RDSCoder::decodeGroup(bits, blocks) != 0B1111 ) badGroups++;
+ * }
+ * void setup() {
+ *   tx.setup();
+ *   tx.setTX(1069); // Set the transmitter to 106.9 MHz
+ *   tx.rdsTxEnable(true);
+ *   tx.rdsInitTx(0x8,0x1,0x9B);
+ *   tx.rdsSetGroupMonitor(monitor);
+ * }
+ * void loop() {
+ *   tx.rdsSendPS("STATIONX");
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066RDSCoder {
+private:
+  uint8_t lastBit = 0;           //!< Last differentially coded bit
+
+public:
+  static uint16_t crc(uint16_t data);
+  static uint16_t checkword(uint16_t data, uint16_t offset);
+  static int16_t offsetOf(uint32_t block);
+  static void encodeGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD, uint8_t *bits);
+  static uint8_t decodeGroup(const uint8_t *bits, uint16_t *blocks);
+
+  uint16_t modulate(uint8_t bit, int16_t *samples, int16_t amplitude = 8000);
+
+  /**
+   * @ingroup group08 RDS Coder
+   * @brief Gets one bit of a packed group (see encodeGroup)
+   * @param bits - packed group
+   * @param index - bit position (0 = first bit sent)
+   */
+  static inline uint8_t getBit(const uint8_t *bits, uint8_t index) {return (bits[index >> 3] >> (7 - (index & 7))) & 1;};
+
+  /**
+   * @ingroup group08 RDS Coder
+   * @brief Restarts the differential coding (the next bit is coded against 0)
+   */
+  inline void reset() {this->lastBit = 0;};
+};
+
+#endif // _QN8066_RDS_CODER_H
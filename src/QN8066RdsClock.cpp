@@ -0,0 +1,177 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX RDS clock (Clock Time synchronization)
+ *
+ * @details The time is counted in UTC minutes since MJD 0 (MJD x 1440 + hour x 60 + minute) plus the time in ms since
+ * @details the last Clock Time accepted. The elapsed time is corrected by the drift: elapsed - elapsed x drift / 10^6.
+ * @details Validation: a Clock Time is accepted when it agrees with the clock (synchronized) or with the previous
+ * @details Clock Time received (the minutes between them match the millis() between them). The tolerance is
+ * @details QN8066_CLOCK_TOLERANCE plus QN8066_CLOCK_MAX_DRIFT (or 500 ppm when the drift is known) of the elapsed time.
+ * @details Drift: measured from a reference Clock Time (anchor) at least QN8066_CLOCK_DRIFT_SPAN minutes old. The
+ * @details anchor is moved after QN8066_CLOCK_ANCHOR_SPAN minutes.
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066RdsClock.h>
+
+/** @defgroup group13 RDS Clock RX RDS clock synchronization */
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Starts the clock
+ * @param rds - RDS decoder of the receiver. NULL = only feed() is used.
+ */
+void QN8066RdsClock::begin(QN8066RdsDecoder *rds) {
+  this->rds = rds;
+  if ( rds != NULL ) this->seen = rds->getCTCount();
+  this->reset();
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Clears the clock (RDS_CLOCK_INVALID) and the drift
+ */
+void QN8066RdsClock::reset() {
+  this->synced = this->pending = this->driftValid = false;
+  this->drift = 0;
+  this->accepted = this->rejected = 0;
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Converts a date and time (UTC) to minutes since MJD 0
+ */
+int32_t QN8066RdsClock::toMinutes(const qn8066_date_time *dt) {
+  return QN8066::calculateMJD(dt->year, dt->month, dt->day) * 1440L + dt->hour * 60 + dt->minute;
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Time in ms since the last Clock Time accepted, corrected by the drift
+ * @param ms - millis()
+ */
+int32_t QN8066RdsClock::elapsed(uint32_t ms) {
+  int32_t value = ms - this->refMillis;
+  return value - (int32_t) ((int64_t) value * this->drift / 1000000L);
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Uses a new Clock Time decoded by the RDS decoder. Call it in the loop, after QN8066RdsDecoder::process.
+ * @return true if a Clock Time was accepted
+ */
+bool QN8066RdsClock::process() {
+  qn8066_date_time ct;
+
+  if ( this->rds == NULL || this->rds->getCTCount() == this->seen ) return false;
+  this->seen = this->rds->getCTCount();
+  if ( !this->rds->getDateTime(&ct) ) return false;
+  return this->feed(&ct, this->rds->getCTMillis());
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Checks a Clock Time and, if it is valid, synchronizes the clock and updates the drift
+ * @details Use it directly to feed the clock from another source of Clock Time groups (for example, a group decoder).
+ * @param ct - Clock Time received (UTC date and time and local offset; second = 0)
+ * @param ms - millis() when the Clock Time group was received (not when it was decoded)
+ * @return true if the Clock Time was accepted
+ */
+bool QN8066RdsClock::feed(const qn8066_date_time *ct, uint32_t ms) {
+  int32_t minutes = toMinutes(ct);
+  bool confirmed = false;
+  bool agrees = false;
+
+  // Agrees with the previous Clock Time received?
+  if ( this->pending ) {
+    int32_t span = minutes - this->pendingMinutes;
+    int32_t error = (int32_t) (ms - this->pendingMillis) - span * 60000L;
+    uint32_t time = ms - this->pendingMillis;
+    confirmed = span > 0 && span <= 1440 && (uint32_t) (error < 0 ? -error : error) <= QN8066_CLOCK_TOLERANCE + time / (1000000L / QN8066_CLOCK_MAX_DRIFT);
+  }
+  // Agrees with the clock?
+  if ( this->synced ) {
+    int32_t time = this->elapsed(ms);
+    int32_t error = (minutes - this->refMinutes) * 60000L - time;
+    agrees = (uint32_t) (error < 0 ? -error : error) <= QN8066_CLOCK_TOLERANCE + (uint32_t) time / ((this->driftValid) ? 2000 : (1000000L / QN8066_CLOCK_MAX_DRIFT));
+  }
+
+  this->pending = true;
+  this->pendingMinutes = minutes;
+  this->pendingMillis = ms;
+
+  if ( !agrees && !confirmed ) {
+    this->rejected++;
+    return false;
+  }
+
+  if ( !agrees ) {   // Sets the clock (first time or a new time confirmed by two Clock Time groups)
+    this->synced = true;
+    this->anchorMinutes = minutes;
+    this->anchorMillis = ms;
+  } else if ( minutes - this->anchorMinutes >= QN8066_CLOCK_DRIFT_SPAN ) {
+    int32_t expected = (minutes - this->anchorMinutes) * 60000L;
+    int32_t value = (int32_t) (((int64_t) ((int32_t) (ms - this->anchorMillis) - expected)) * 1000000L / expected);
+    if ( value >= -QN8066_CLOCK_MAX_DRIFT && value <= QN8066_CLOCK_MAX_DRIFT ) {
+      this->drift = value;
+      this->driftValid = true;
+    }
+    if ( minutes - this->anchorMinutes >= QN8066_CLOCK_ANCHOR_SPAN ) {
+      this->anchorMinutes = minutes;
+      this->anchorMillis = ms;
+    }
+  }
+
+  this->refMinutes = minutes;
+  this->refMillis = ms;
+  this->offset = ct->offset;
+  this->accepted++;
+  return true;
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Gets the current date and time
+ * @details The local time is the UTC time plus the offset sent by the station (the date changes when needed).
+ * @param dt - returns the date and time (with seconds). offset is the local time offset of the station.
+ * @param local - true = local time; false = UTC
+ * @return quality (RDS_CLOCK_INVALID, RDS_CLOCK_HOLDOVER, RDS_CLOCK_SYNCED or RDS_CLOCK_DISCIPLINED).
+ * @return dt is not changed if RDS_CLOCK_INVALID.
+ */
+uint8_t QN8066RdsClock::getRdsTime(qn8066_date_time *dt, bool local) {
+  uint8_t quality = this->getQuality();
+  int32_t time, minutes;
+
+  if ( quality == RDS_CLOCK_INVALID ) return quality;
+
+  time = this->elapsed(millis());
+  minutes = this->refMinutes + time / 60000L + ((local) ? this->offset * 30 : 0);
+
+  QN8066::mjdToDate(minutes / 1440, &dt->year, &dt->month, &dt->day);
+  dt->hour = (minutes % 1440) / 60;
+  dt->minute = minutes % 60;
+  dt->second = (time % 60000L) / 1000;
+  dt->offset = this->offset;
+  return quality;
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Gets the quality of the time
+ * @return RDS_CLOCK_INVALID, RDS_CLOCK_HOLDOVER, RDS_CLOCK_SYNCED or RDS_CLOCK_DISCIPLINED
+ */
+uint8_t QN8066RdsClock::getQuality() {
+  if ( !this->synced ) return RDS_CLOCK_INVALID;
+  if ( this->getAge() > this->holdover * 60UL ) return RDS_CLOCK_HOLDOVER;
+  return (this->driftValid) ? RDS_CLOCK_DISCIPLINED : RDS_CLOCK_SYNCED;
+}
+
+/**
+ * @ingroup group13 RDS Clock
+ * @brief Gets the time since the last Clock Time accepted
+ * @return age in seconds (0xFFFFFFFF = the clock was not set)
+ */
+uint32_t QN8066RdsClock::getAge() {
+  if ( !this->synced ) return 0xFFFFFFFF;
+  return (millis() - this->refMillis) / 1000;
+}
@@ -0,0 +1,107 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX RDS clock (Clock Time synchronization)
+ *
+ * @details This file contains a software clock for the host MCU set by the RDS Clock Time (group 4A) received by the
+ * @details QN8066. The 4A group is sent at the start of each minute, so its reception time marks the minute edge.
+ * @details A Clock Time is used only when it agrees with the previous one (or with the clock already set), so a wrong
+ * @details group or a station with a wrong clock does not change the time. Between the Clock Time groups, the time is
+ * @details kept by millis() corrected by the drift (ppm) measured against the RDS clock. The time can be read in UTC or
+ * @details local time (offset sent by the station), with a quality indicator and the age of the last synchronization.
+ * @details Only integer math is used.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_RDS_CLOCK_H // Prevent this file from being compiled more than once
+#define _QN8066_RDS_CLOCK_H
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+
+#define RDS_CLOCK_INVALID 0        //<! The clock was not set yet
+#define RDS_CLOCK_HOLDOVER 1       //<! No Clock Time for longer than the holdover time. The time is kept by millis()
+#define RDS_CLOCK_SYNCED 2         //<! Synchronized by the RDS. Drift not measured yet
+#define RDS_CLOCK_DISCIPLINED 3    //<! Synchronized by the RDS and millis() corrected by the drift measured
+
+#define QN8066_CLOCK_TOLERANCE 1500   //<! Time in ms between the Clock Time and the clock accepted (reception latency)
+#define QN8066_CLOCK_DRIFT_SPAN 10    //<! Minimum time in minutes to measure the drift
+#define QN8066_CLOCK_ANCHOR_SPAN 720  //<! Time in minutes after which the drift is measured from a new reference
+#define QN8066_CLOCK_MAX_DRIFT 10000  //<! Maximum drift in ppm of the millis() clock (ceramic resonator: up to 0.5%)
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066RdsClock Class - Host clock set by the RDS Clock Time
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsDecoder.h>
+ * #include <QN8066RdsClock.h>
+ * QN8066 rx;
+ * QN8066RdsDecoder rds;
+ * QN8066RdsClock clock;
+ * void setup() {
+ *   rx.setRX(1069);
+ *   rx.rdsRxEnable(true);
+ *   rds.begin(&rx);
+ *   clock.begin(&rds);
+ * }
+ * void loop() {
+ *   qn8066_date_time now;
+ *   rds.process();
+ *   clock.process();
+ *   if ( clock.getRdsTime(&now) != RDS_CLOCK_INVALID ) showTime(now.hour, now.minute, now.second);
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066RdsClock {
+private:
+  QN8066RdsDecoder *rds = NULL;
+  uint8_t seen = 0;              //!< getCTCount of the decoder at the last process()
+
+  bool synced = false;
+  int32_t refMinutes = 0;        //!< UTC minutes since MJD 0 of the last Clock Time accepted
+  uint32_t refMillis = 0;        //!< millis() of the last Clock Time accepted
+  int8_t offset = 0;             //!< Local time offset (half hours) of the last Clock Time accepted
+
+  int32_t anchorMinutes = 0;     //!< Reference of the drift measurement (UTC minutes)
+  uint32_t anchorMillis = 0;     //!< Reference of the drift measurement (millis)
+  int32_t drift = 0;             //!< Drift of millis() in ppm (positive = millis() runs fast)
+  bool driftValid = false;
+
+  bool pending = false;          //!< true = there is a Clock Time not confirmed yet
+  int32_t pendingMinutes = 0;
+  uint32_t pendingMillis = 0;
+
+  uint16_t holdover = 60;        //!< Time in minutes without Clock Time before RDS_CLOCK_HOLDOVER
+  uint16_t accepted = 0;
+  uint16_t rejected = 0;
+
+  int32_t elapsed(uint32_t ms);
+  static int32_t toMinutes(const qn8066_date_time *dt);
+
+public:
+  void begin(QN8066RdsDecoder *rds);
+  bool process();
+  bool feed(const qn8066_date_time *ct, uint32_t ms);
+  uint8_t getRdsTime(qn8066_date_time *dt, bool local = true);
+  uint8_t getQuality();
+  uint32_t getAge();
+  void reset();
+
+  /**
+   * @ingroup group13 RDS Clock
+   * @brief Sets the time without Clock Time after which the quality is RDS_CLOCK_HOLDOVER
+   * @param minutes - holdover time (default 60)
+   */
+  inline void setHoldover(uint16_t minutes) {this->holdover = minutes;};
+  inline int32_t getDrift() {return this->drift;};           //!< Drift of millis() in ppm (positive = millis() runs fast)
+  inline uint16_t getAccepted() {return this->accepted;};    //!< Clock Time groups used
+  inline uint16_t getRejected() {return this->rejected;};    //!< Clock Time groups not used (not confirmed yet or not agreeing with the clock)
+};
+
+#endif // _QN8066_RDS_CLOCK_H
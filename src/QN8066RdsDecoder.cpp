@@ -0,0 +1,502 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX RDS decoder
+ *
+ * @details Tuning: the QN8066 counts the writes of the receiver channel (getRxTuneCount). When the counter changes, the
+ * @details group in RDSD0 to RDSD7 may be from another frequency (tuning, probeRxFrequency or surveyBand), so the next
+ * @details group is read only after RDS_RXUPD toggles again. When getRxCurrentFrequency changes, the decoder state is
+ * @details cleared (reset) by the consumer (process or decodeQueue).
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066RdsDecoder.h>
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Starts the RDS decoder
+ * @param rx - QN8066 instance (RX mode with RDS enabled - see rdsRxEnable)
+ */
+void QN8066RdsDecoder::begin(QN8066 *rx) {
+  this->rx = rx;
+  this->tuneCount = rx->getRxTuneCount();
+  this->reset();
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Clears the RDS decoder state (PI, PS, RT, CT etc)
+ * @details It is called when the receiver is tuned to another frequency. The groups captured and not decoded yet are
+ * @details dropped, so call it from the consumer context (the same one of decodeQueue).
+ */
+void QN8066RdsDecoder::reset() {
+  this->frequency = this->rx->getRxCurrentFrequency();
+  this->updState = 0xFF;
+  this->ready = 0;
+  this->pi = 0;
+  this->pty = this->tp = this->ta = 0;
+  this->psMask = 0;
+  this->rtMask = 0;
+  this->rtEnd = 16;
+  this->rtFlags = 0xFF;
+  this->blocks = this->blockErrors = 0;
+  this->afCount = this->afSize = this->afSeen = 0;
+  this->afLFMF = false;
+  this->tail = this->head;   // Groups captured on the previous frequency are dropped
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Drops the group in the RDS registers when the receiver channel was written
+ * @details The group can be from another frequency, so the next group is read only after RDS_RXUPD toggles again and
+ * @details the interrupts received meanwhile are not counted as groups lost.
+ */
+void QN8066RdsDecoder::followTuning() {
+  uint8_t count = this->rx->getRxTuneCount();
+
+  if ( count == this->tuneCount ) return;
+  this->tuneCount = count;
+  this->updState = 0xFF;
+  this->irqSeen = this->irqCount;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Clears the decoder state if the receiver was tuned to another frequency
+ */
+void QN8066RdsDecoder::checkFrequency() {
+  if ( this->rx->getRxCurrentFrequency() != this->frequency ) this->reset();
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Reads a new RDS group from the QN8066
+ * @details Reads STATUS2 and, only when RDS_RXUPD toggled (new group received), reads RDSD0 to RDSD7 and STATUS2 in
+ * @details one I2C transaction. The block errors are counted for the BLER (see getBLER).
+ * @param group - returns the group (the time is not set)
+ * @param newGroup - true if it is known that there is a new group (RDS interrupt)
+ * @return false if there is no new group
+ */
+bool QN8066RdsDecoder::readGroup(qn8066_rds_rx_group *group, bool newGroup) {
+  qn8066_status2 status;
+  uint8_t data[9];
+
+  status.raw = this->rx->getRegister(QN_STATUS2);
+  if ( this->updState == 0xFF ) {   // The group in the registers may be from the previous frequency
+    this->updState = status.arg.RDS_RXUPD;
+    return false;
+  }
+  // In interrupt mode there is a new group even if RDS_RXUPD toggled twice (one group lost)
+  if ( !newGroup && status.arg.RDS_RXUPD == this->updState ) return false;
+  this->updState = status.arg.RDS_RXUPD;
+
+  this->rx->getRegisters(QN_RX_RDSD0, data, 9);  // RDSD0 to RDSD7 and STATUS2
+  status.raw = data[8];
+  if ( status.arg.RDS_RXUPD != this->updState ) return false;  // A new group arrived during the reading. It will be read next time.
+
+  if ( status.arg.RDSSYNC )
+    group->errors = status.arg.RDS0ERR | (status.arg.RDS1ERR << 1) | (status.arg.RDS2ERR << 2) | (status.arg.RDS3ERR << 3);
+  else
+    group->errors = 0B1111;
+  for (uint8_t i = 0; i < 4; i++) group->block[i] = ((uint16_t) data[i * 2] << 8) | data[i * 2 + 1];
+
+  // Block error rate: the counters are halved from time to time, so the BLER follows the current reception
+  if ( this->blocks >= 4096 ) {
+    this->blocks >>= 1;
+    this->blockErrors >>= 1;
+  }
+  this->blocks += 4;
+  for (uint8_t e = group->errors; e; e >>= 1) this->blockErrors += e & 1;
+
+  return true;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief RDS receiver: reads and decodes a new group
+ * @details A group arrives every 87.6 ms, so call it at least every 80 ms. The blocks with the error flag set
+ * @details (RDS0ERR to RDS3ERR) are not used. Nothing is allocated here. If the loop can be busy for longer than that
+ * @details (LCD updates, for example), use the capture mode (capture and decodeQueue).
+ * @return true if a new group was decoded
+ * @details Example
+ * @code
+ * char ps[9];
+ * void loop() {
+ *   rds.process();
+ *   if ( rds.getPS(ps) != NULL ) lcd.print(ps);
+ * }
+ * @endcode
+ * @see getPS, getRT, getTime, getStatus, capture
+ */
+bool QN8066RdsDecoder::process() {
+  qn8066_rds_rx_group group;
+
+  this->checkFrequency();
+  this->followTuning();
+  if ( !this->readGroup(&group) ) return false;
+  this->decodeGroup(group.block[0], group.block[1], group.block[2], group.block[3], group.errors, millis());
+  return true;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Enables the RDS interrupt of the QN8066
+ * @details When a new group is received, the QN8066 outputs a 4.5 ms low pulse on the DIN pad (RX mode). Connect it to
+ * @details an interrupt pin of the MCU and call onInterrupt from the interrupt service routine. Then capture only
+ * @details accesses the I2C bus when there is a new group, and it can count the groups that were lost (see getMissed).
+ * @param value - true = enabled; false = disabled
+ * @details Example
+ * @code
+ * #define RDS_INT_PIN 2
+ * qn8066_rds_rx_group ring[QN8066_RDS_RX_RING];
+ * void rdsInterrupt() { rds.onInterrupt(); }
+ * void setup() {
+ *   ...
+ *   rx.rdsRxEnable(true);
+ *   rds.begin(&rx);
+ *   rds.setCaptureBuffer(ring, QN8066_RDS_RX_RING);
+ *   rds.setInterrupt(true);
+ *   pinMode(RDS_INT_PIN, INPUT_PULLUP);
+ *   attachInterrupt(digitalPinToInterrupt(RDS_INT_PIN), rdsInterrupt, FALLING);
+ * }
+ * void loop() {
+ *   rds.capture();       // Producer: call it as often as possible (or from a timer task)
+ *   updateLCD();         // Can take more than 87 ms: the groups wait in the ring
+ *   rds.capture();
+ *   rds.decodeQueue();   // Consumer: decodes the groups captured
+ * }
+ * @endcode
+ * @see onInterrupt, setCaptureBuffer, capture, decodeQueue
+ */
+void QN8066RdsDecoder::setInterrupt(bool value) {
+  this->rx->rdsSetInterrupt(value);
+  this->irqEnabled = value;
+  this->irqSeen = this->irqCount;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Sets the ring buffer of the capture mode
+ * @details The buffer is supplied by the application, so the RAM is used only when the capture mode is used. 
+ * @details Each group uses sizeof(qn8066_rds_rx_group) bytes. A group arrives every 87.6 ms, so the ring must hold the 
+ * @details groups received while the loop is busy (8 groups = 700 ms). Call it before the first capture.
+ * @param ring - buffer (NULL = no capture)
+ * @param size - number of groups (power of 2: 2, 4, 8 ... 128). Another value is rounded down to a power of 2.
+ * @see capture, QN8066_RDS_RX_RING
+ */
+void QN8066RdsDecoder::setCaptureBuffer(qn8066_rds_rx_group *ring, uint8_t size) {
+  uint8_t n = 1;
+
+  while ( (uint8_t) (n << 1) != 0 && (n << 1) <= size ) n <<= 1;
+  this->ring = (size < 2) ? NULL : ring;
+  this->ringMask = (this->ring == NULL) ? 0 : n - 1;
+  this->head = this->tail = 0;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Captures a new RDS group into the ring buffer (producer)
+ * @details In interrupt mode (setInterrupt), the QN8066 is read only if an interrupt happened since the last
+ * @details capture, and the time of the group is the time of the interrupt. Otherwise STATUS2 is polled.
+ * @details The ring is a single producer / single consumer queue: capture only writes the head and popGroup
+ * @details (decodeQueue) only writes the tail, so they can run in different contexts (a timer task and the loop, for example).
+ * @return true if a group was added to the ring (false if there is no ring - see setCaptureBuffer)
+ * @see decodeQueue, popGroup, getOverflows, getMissed
+ */
+bool QN8066RdsDecoder::capture() {
+  qn8066_rds_rx_group *group;
+  uint8_t head = this->head;
+  uint8_t next = (head + 1) & this->ringMask;
+  uint32_t time = micros();
+
+  if ( this->ring == NULL ) return false;
+  this->followTuning();
+  if ( this->irqEnabled ) {
+    uint8_t count = this->irqCount;
+    if ( count == this->irqSeen ) return false;   // No new group: no I2C access
+    this->missed += (uint8_t) (count - this->irqSeen - 1);  // Groups received since the last capture, but one
+    this->irqSeen = count;
+    noInterrupts();
+    time = this->irqTime;
+    interrupts();
+  }
+
+  if ( next == this->tail ) {
+    // The ring is full. The group is read anyway, so the RDS_RXUPD state follows the QN8066.
+    qn8066_rds_rx_group lost;
+    if ( this->readGroup(&lost, this->irqEnabled) ) this->overflows++;
+    return false;
+  }
+
+  group = &this->ring[head];
+  if ( !this->readGroup(group, this->irqEnabled) ) return false;
+  group->time = time;
+  this->head = next;   // Publishes the group (after it was written)
+  return true;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the oldest group captured (consumer)
+ * @param group - returns the raw group (blocks, error flags and time)
+ * @return false if the ring is empty
+ * @see capture, decodeQueue
+ */
+bool QN8066RdsDecoder::popGroup(qn8066_rds_rx_group *group) {
+  uint8_t tail = this->tail;
+
+  if ( tail == this->head ) return false;
+  *group = this->ring[tail];
+  this->tail = (tail + 1) & this->ringMask;
+  return true;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Decodes all groups captured (consumer)
+ * @details The groups can wait in the ring for several periods of 87.6 ms, so the time of each group is the time of 
+ * @details its capture (interrupt), not the time of the decoding. It is the reference of the Clock Time (see getCTMillis).
+ * @return number of groups decoded
+ * @see capture, getPS, getRT
+ */
+uint8_t QN8066RdsDecoder::decodeQueue() {
+  qn8066_rds_rx_group group;
+  uint8_t count = 0;
+
+  this->checkFrequency();
+  while ( this->popGroup(&group) ) {
+    uint32_t time = millis() - (micros() - group.time) / 1000;   // millis() when the group was captured
+    this->decodeGroup(group.block[0], group.block[1], group.block[2], group.block[3], group.errors, time);
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the Block Error Rate (BLER) of the RDS reception
+ * @details Percentage of blocks received with error (RDS0ERR to RDS3ERR, or no RDS synchronization). It follows the
+ * @details last minute or so of reception. Groups lost by the host (see getMissed) are not counted.
+ * @return BLER in % (0 = perfect reception; 100 = no RDS)
+ */
+uint8_t QN8066RdsDecoder::getBLER() {
+  if ( this->blocks == 0 ) return 100;
+  return (uint32_t) this->blockErrors * 100 / this->blocks;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Decodes one RDS group (PI, PTY, TP, TA, PS - 0A/0B, Radio Text - 2A/2B and Clock Time - 4A)
+ * @details The PS and the Radio Text are assembled in a work buffer. When all segments are received, they are copied
+ * @details to the buffer read by getPS and getRT, so these functions never return half of a text.
+ * @details The Radio Text is cleared when the Text A/B flag changes.
+ * @param blockA, blockB, blockC, blockD - the four blocks
+ * @param errors - one bit per block with error (bit 0 = block 1). These blocks are not used.
+ * @param time - millis() when the group was received (reference of the Clock Time - see getCTMillis)
+ */
+void QN8066RdsDecoder::decodeGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD, uint8_t errors, uint32_t time) {
+  uint8_t chars[4], segment, flags;
+
+  if ( !(errors & 0B0001) ) {
+    this->pi = blockA;
+    this->ready |= RDS_RX_PI;
+  }
+  if ( errors & 0B0010 ) return;   // The group type is unknown
+
+  this->pty = (blockB >> 5) & 0B11111;
+  this->tp = (blockB >> 10) & 1;
+  chars[0] = blockC >> 8;
+  chars[1] = blockC & 0xFF;
+  chars[2] = blockD >> 8;
+  chars[3] = blockD & 0xFF;
+
+  switch ( blockB >> 11 ) {         // Group type and version
+    case 0:                         // 0A
+    case 1:                         // 0B
+      this->ta = (blockB >> 4) & 1;
+      if ( (blockB >> 11) == 0 && !(errors & 0B0100) ) {   // Block 3 of the 0A: two AF codes
+        this->decodeAF(blockC >> 8);
+        this->decodeAF(blockC & 0xFF);
+      }
+      if ( errors & 0B1000 ) break;
+      segment = blockB & 0B11;
+      this->psBuffer[segment * 2] = chars[2];
+      this->psBuffer[segment * 2 + 1] = chars[3];
+      this->psMask |= 1 << segment;
+      if ( this->psMask == 0B1111 ) {
+        memcpy(this->psText, this->psBuffer, 8);
+        this->psText[8] = '\0';
+        this->psMask = 0;
+        this->ready |= RDS_RX_PS;
+      }
+      break;
+    case 4:                         // 2A
+    case 5:                         // 2B
+      flags = ((blockB >> 4) & 1) | ((blockB >> 10) & 0B10);
+      if ( flags != this->rtFlags ) {   // New message
+        this->rtFlags = flags;
+        this->rtMask = 0;
+        this->rtEnd = 16;
+        memset(this->rtBuffer, ' ', sizeof(this->rtBuffer));
+      }
+      if ( flags & 0B10 ) {
+        if ( !(errors & 0B1000) ) this->decodeRT(blockB & 0xF, 2, &chars[2]);
+      } else {
+        if ( !(errors & 0B1100) ) this->decodeRT(blockB & 0xF, 4, chars);
+      }
+      break;
+    case 8: {                       // 4A
+      if ( errors & 0B1100 ) break;
+      int32_t mjd = ((int32_t) (blockB & 0B11) << 15) | (blockC >> 1);
+      uint8_t hour = ((blockC & 1) << 4) | (blockD >> 12);
+      uint8_t minute = (blockD >> 6) & 0B111111;
+      if ( hour > 23 || minute > 59 || mjd < 15079 ) break;   // Not valid (before 1900-03-01)
+      QN8066::mjdToDate(mjd, &this->ct.year, &this->ct.month, &this->ct.day);
+      this->ct.hour = hour;
+      this->ct.minute = minute;
+      this->ct.second = 0;
+      this->ct.offset = (blockD & 0B100000) ? -(int8_t) (blockD & 0B11111) : (int8_t) (blockD & 0B11111);
+      this->ready |= RDS_RX_CT;
+      this->ctMillis = time;
+      this->ctCount++;
+      break;
+    }
+  }
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Decodes one AF code of the group 0A (method A or B)
+ * @details Code 224 + n starts a list of n codes. The frequencies (codes 1 to 204) are stored once, so the lists of
+ * @details the method B (pairs with the tuned frequency) give the same set. Filler (205) and LF/MF codes are skipped.
+ * @details The code that follows 250 (LF/MF indicator) is an LF/MF channel, not a VHF one, so it is skipped too.
+ * @details RDS_RX_AF is set when n codes were received after the start of the list.
+ * @param code - AF code
+ */
+void QN8066RdsDecoder::decodeAF(uint8_t code) {
+  if ( code >= 224 && code <= 249 ) {
+    if ( code - 224 != this->afSize ) {   // Another list
+      this->afSize = code - 224;
+      this->afCount = 0;
+      this->ready &= ~RDS_RX_AF;
+    }
+    this->afSeen = 0;
+    this->afLFMF = false;
+    return;
+  }
+  if ( this->afSize == 0 ) return;       // The start of the list was not received yet
+
+  if ( code == 250 ) {                   // LF/MF indicator (not counted as an AF)
+    this->afLFMF = true;
+    return;
+  }
+  if ( ++this->afSeen >= this->afSize ) this->ready |= RDS_RX_AF;
+  if ( this->afLFMF ) {                  // LF/MF channel
+    this->afLFMF = false;
+    return;
+  }
+  if ( code == 0 || code > 204 ) return;
+
+  for (uint8_t i = 0; i < this->afCount; i++)
+    if ( this->af[i] == code ) return;
+  if ( this->afCount < QN8066_RDS_RX_AF_MAX ) this->af[this->afCount++] = code;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the Alternative Frequencies received (group 0A)
+ * @details The list grows while the AF codes are received. RDS_RX_AF (getStatus) shows that a whole list was received.
+ * @param list - returns the frequencies (MHz x 10)
+ * @param size - maximum number of frequencies
+ * @return number of frequencies returned
+ */
+uint8_t QN8066RdsDecoder::getAF(uint16_t *list, uint8_t size) {
+  uint8_t n = (this->afCount < size) ? this->afCount : size;
+  for (uint8_t i = 0; i < n; i++) list[i] = 875 + this->af[i];
+  return n;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Stores a Radio Text segment and checks if the message is complete
+ * @param segment - segment address (0 to 15)
+ * @param size - characters per segment (4 = 2A; 2 = 2B)
+ * @param chars - characters of the segment
+ */
+void QN8066RdsDecoder::decodeRT(uint8_t segment, uint8_t size, const uint8_t *chars) {
+  uint16_t all;
+  uint8_t len;
+
+  for (uint8_t i = 0; i < size; i++) {
+    this->rtBuffer[segment * size + i] = chars[i];
+    if ( chars[i] == '\r' ) this->rtEnd = segment + 1;
+  }
+  this->rtMask |= 1 << segment;
+
+  all = (this->rtEnd >= 16) ? 0xFFFF : (1 << this->rtEnd) - 1;
+  if ( (this->rtMask & all) != all ) return;
+
+  // Complete message: copies it up to the '\r' without the trailing spaces
+  for (len = 0; len < this->rtEnd * size && this->rtBuffer[len] != '\r'; len++);
+  while ( len > 0 && this->rtBuffer[len - 1] == ' ' ) len--;
+  memcpy(this->rtText, this->rtBuffer, len);
+  this->rtText[len] = '\0';
+  this->rtMask = 0;
+  this->ready |= RDS_RX_RT;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the current Program Station
+ * @param ps - buffer with at least 9 bytes
+ * @return ps or NULL if no complete PS was received yet
+ * @see process
+ */
+char* QN8066RdsDecoder::getPS(char *ps) {
+  if ( !(this->ready & RDS_RX_PS) ) return NULL;
+  memcpy(ps, this->psText, 9);
+  return ps;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the current Radio Text
+ * @param rt - buffer with at least 65 bytes
+ * @return rt or NULL if no complete Radio Text was received yet
+ * @see process
+ */
+char* QN8066RdsDecoder::getRT(char *rt) {
+  if ( !(this->ready & RDS_RX_RT) ) return NULL;
+  strcpy(rt, this->rtText);
+  return rt;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the local time of the last Clock Time (group 4A) received
+ * @param time - buffer with at least 6 bytes. It receives "hh:mm".
+ * @return time or NULL if no Clock Time was received yet
+ * @see getDateTime
+ */
+char* QN8066RdsDecoder::getTime(char *time) {
+  int16_t minutes;
+
+  if ( !(this->ready & RDS_RX_CT) ) return NULL;
+
+  minutes = (this->ct.hour * 60 + this->ct.minute + this->ct.offset * 30 + 1440) % 1440;
+  this->rx->convertToChar(minutes / 60, time, 2, 0, '.', false);
+  time[2] = ':';
+  this->rx->convertToChar(minutes % 60, &time[3], 2, 0, '.', false);
+  return time;
+}
+
+/**
+ * @ingroup group031 RX RDS
+ * @brief Gets the date and time (UTC and local offset) of the last Clock Time (group 4A) received
+ * @param dt - date and time
+ * @return false if no Clock Time was received yet
+ */
+bool QN8066RdsDecoder::getDateTime(qn8066_date_time *dt) {
+  if ( !(this->ready & RDS_RX_CT) ) return false;
+  *dt = this->ct;
+  return true;
+}
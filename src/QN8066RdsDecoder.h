@@ -0,0 +1,157 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX RDS decoder
+ *
+ * @details This file contains the RDS decoder of the QN8066 receiver: PI, PTY, TP, TA, PS (0A/0B), Radio Text (2A/2B),
+ * @details Clock Time (4A) and the AF lists (0A). The groups are read by polling RDS_RXUPD (process) or captured into a
+ * @details ring buffer supplied by the application, driven by the RDS interrupt (capture and decodeQueue). The decoder 
+ * @details is a separate object, so the QN8066 class does not carry its buffers when the RDS reception is not used. 
+ * @details Nothing is allocated.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_RDS_DECODER_H // Prevent this file from being compiled more than once
+#define _QN8066_RDS_DECODER_H
+
+#include <QN8066.h>
+
+/**
+ * @brief RX RDS decoder: data completely received. See getStatus
+ *
+ */
+#define RDS_RX_PI 1               //<! PI (and PTY/TP) received
+#define RDS_RX_PS 2               //<! The four PS segments received
+#define RDS_RX_RT 4               //<! All Radio Text segments received
+#define RDS_RX_CT 8               //<! Clock Time (group 4A) received
+#define RDS_RX_AF 16              //<! A whole AF list (group 0A) received
+#define QN8066_RDS_RX_AF_MAX 25   //<! Alternative Frequencies stored by the RX decoder. See getAF
+#define QN8066_RDS_RX_RING 8      //<! Suggested size of the RX capture ring (power of 2). See setCaptureBuffer
+
+/**
+ * @ingroup group00 RDS
+ * @brief RDS group received (qn8066_rds_rx_group data type)
+ * @see QN8066RdsDecoder::capture, QN8066RdsDecoder::popGroup
+ */
+typedef struct {
+  uint16_t block[4];  //!< Blocks 1 to 4
+  uint8_t errors;     //!< One bit per block with error (bit 0 = block 1)
+  uint32_t time;      //!< micros() when the group was received (interrupt) or read
+} qn8066_rds_rx_group;
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066RdsDecoder Class - RX RDS decoder
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsDecoder.h>
+ * QN8066 rx;
+ * QN8066RdsDecoder rds;
+ * char ps[9];
+ * void setup() {
+ *   rx.setRX(1069);
+ *   rx.rdsRxEnable(true);
+ *   rds.begin(&rx);
+ * }
+ * void loop() {
+ *   rds.process();
+ *   if ( rds.getPS(ps) != NULL ) lcd.print(ps);
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066RdsDecoder {
+private:
+  QN8066 *rx = NULL;
+  uint16_t frequency = 0;        //!< Frequency being decoded (the state is cleared when the receiver is tuned to another one)
+  uint8_t tuneCount = 0;         //!< QN8066::getRxTuneCount at the last read
+  uint8_t updState = 0xFF;       //!< Last RDS_RXUPD value (0xFF = not read yet)
+
+  uint16_t pi = 0;
+  uint8_t pty = 0;
+  uint8_t tp = 0;
+  uint8_t ta = 0;
+  uint8_t ready = 0;             //!< RDS_RX_* flags of the data completely received
+  char psBuffer[8];              //!< PS being received
+  char psText[9];                //!< Last complete PS
+  uint8_t psMask = 0;            //!< PS segments received (one bit per segment)
+  char rtBuffer[64];             //!< Radio Text being received
+  char rtText[65];               //!< Last complete Radio Text
+  uint16_t rtMask = 0;           //!< Radio Text segments received (one bit per segment)
+  uint8_t rtEnd = 16;            //!< Number of Radio Text segments (up to the '\r')
+  uint8_t rtFlags = 0xFF;        //!< Text A/B flag (bit 0) and version (bit 1) of the Radio Text being received
+  qn8066_date_time ct;           //!< Last Clock Time received
+  uint8_t ctCount = 0;           //!< Clock Time groups (4A) decoded (wraps around). See QN8066RdsClock
+  uint32_t ctMillis = 0;         //!< millis() when the last Clock Time group was received
+  uint8_t af[QN8066_RDS_RX_AF_MAX];  //!< AF codes received (frequency = 875 + code), without repetitions
+  uint8_t afCount = 0;           //!< Number of AF codes in af
+  uint8_t afSize = 0;            //!< Number of AFs announced by the list (code 224 + n). 0 = no list
+  uint8_t afSeen = 0;            //!< AF codes received since the start of the list
+  bool afLFMF = false;           //!< The last code was 250: the next one is an LF/MF frequency
+  uint32_t blocks = 0;           //!< Blocks received (BLER)
+  uint32_t blockErrors = 0;      //!< Blocks received with error (BLER)
+
+  qn8066_rds_rx_group *ring = NULL;  //!< Groups captured and not decoded yet (buffer of the application)
+  uint8_t ringMask = 0;          //!< Size of the ring - 1 (the size is a power of 2)
+  volatile uint8_t head = 0;     //!< Next free entry of the ring (written only by capture)
+  volatile uint8_t tail = 0;     //!< Next entry to be decoded (written only by the consumer)
+  volatile uint8_t irqCount = 0; //!< RDS interrupts (onInterrupt)
+  volatile uint32_t irqTime = 0; //!< micros() of the last RDS interrupt
+  uint8_t irqSeen = 0;           //!< irqCount at the last capture
+  bool irqEnabled = false;
+  uint16_t overflows = 0;        //!< Groups lost because the ring was full
+  uint16_t missed = 0;           //!< Groups lost because they were not read in time (interrupt mode)
+
+  void followTuning();
+  void checkFrequency();
+  bool readGroup(qn8066_rds_rx_group *group, bool newGroup = false);
+  void decodeRT(uint8_t segment, uint8_t size, const uint8_t *chars);
+  void decodeAF(uint8_t code);
+
+public:
+  void begin(QN8066 *rx);
+  void reset();
+  bool process();
+  void decodeGroup(uint16_t blockA, uint16_t blockB, uint16_t blockC, uint16_t blockD, uint8_t errors, uint32_t time);
+  char *getPS(char *ps);
+  char *getRT(char *rt);
+  char *getTime(char *time);
+  bool getDateTime(qn8066_date_time *dt);
+  void setInterrupt(bool value);
+  void setCaptureBuffer(qn8066_rds_rx_group *ring, uint8_t size);
+  bool capture();
+  bool popGroup(qn8066_rds_rx_group *group);
+  uint8_t decodeQueue();
+  uint8_t getBLER();
+  uint8_t getAF(uint16_t *list, uint8_t size);
+
+  /**
+   * @ingroup group031 RX RDS
+   * @brief Call it from the interrupt service routine of the RDS interrupt pin
+   * @details It only stores the time and counts the interrupt (no I2C access). See setInterrupt.
+   */
+  inline void onInterrupt() {this->irqTime = micros(); this->irqCount++;};
+  inline uint16_t getOverflows() {return this->overflows;};   //!< Groups lost because the capture ring was full
+  inline uint16_t getMissed() {return this->missed;};         //!< Groups not read before the next one (interrupt mode)
+  inline uint8_t getAFCount() {return this->afCount;};        //!< Alternative Frequencies received so far (see getAF)
+  inline uint8_t getCTCount() {return this->ctCount;};        //!< Clock Time groups decoded (changes on each new 4A group)
+  inline uint32_t getCTMillis() {return this->ctMillis;};     //!< millis() when the last Clock Time group was received
+  inline uint16_t getFrequency() {return this->frequency;};   //!< Frequency of the data decoded (MHz x 10)
+
+  /**
+   * @ingroup group031 RX RDS
+   * @brief Gets what was completely received since the last reset (tuning)
+   * @return RDS_RX_PI, RDS_RX_PS, RDS_RX_RT, RDS_RX_CT and RDS_RX_AF flags (OR-ed)
+   */
+  inline uint8_t getStatus() {return this->ready;};
+  inline uint16_t getPI() {return this->pi;};
+  inline uint8_t getPTY() {return this->pty;};
+  inline uint8_t getTP() {return this->tp;};
+  inline uint8_t getTA() {return this->ta;};
+};
+
+#endif // _QN8066_RDS_DECODER_H
@@ -0,0 +1,1103 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - TX RDS encoder
+ *
+ * @details process reads RDS_TXUPD once per call and loads the next group only when the QN8066 has fetched the last one.
+ * @details The groups are built from the data set here (AF, Radio Text, Dynamic PS, ODA etc) and from the PI, PTY, TP,
+ * @details TA, DI, MS and station name of the QN8066 instance. The statistics and the group period are the ones of the
+ * @details QN8066 instance too (see QN8066::rdsSetStats and QN8066::rdsSetCalibration).
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066RdsEncoder.h>
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Starts the RDS encoder
+ * @param tx - QN8066 instance (TX mode with RDS enabled - see rdsTxEnable and rdsInitTx)
+ */
+void QN8066RdsEncoder::begin(QN8066 *tx) {
+  this->tx = tx;
+  this->txUpdState = -1;
+  this->psSegment = 0;
+  this->slot = 0;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Gets the next character of a text in the RDS character set
+ * @details Converts it from UTF-8 unless QN8066::rdsSetUTF8(false) was called.
+ * @param text - pointer to the current position of the text. It is moved to the next character.
+ */
+char QN8066RdsEncoder::nextChar(const char **text) {
+  if ( this->tx->rdsGetUTF8() ) return (char) QN8066::utf8ToEBU(text);
+  return *(*text)++;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sets the Alternative Frequencies (AF) list
+ * @details The AF list tells the receivers the other frequencies (relays) where the same program can be received.
+ * @details When a list is set, the PS is sent in the group 0A instead of 0B. The AF codes are sent in pairs on
+ * @details block 3 (method A), one pair per group. The first pair is the number of AFs (224 + n) and the first AF.
+ * @details The AF codes are computed here, once, so there is no extra processing when the groups are sent.
+ * @details Like setTX, the frequencies must be multiplied by 10 (Example: 106.9 MHz => 1069).
+ * @details Only frequencies from 87.6 MHz to 107.9 MHz can be coded. Other values are ignored.
+ * @param frequencies - array of frequencies (0.1 MHz unit)
+ * @param count - number of elements in frequencies (maximum 25)
+ * @return number of valid AFs stored
+ * @details Example
+ * @code
+ * uint16_t af[] = {1069, 1003, 899};  // 106.9, 100.3 and 89.9 MHz
+ * void setup() {
+ *   ...
+ *   rds.begin(&tx);
+ *   rds.setAF(af, 3);
+ * }
+ *
+ * void loop() {
+ *   rds.process();  // Now the groups 0A carry the AF list
+ * }
+ * @endcode
+ * @see clearAF, process, sendPS
+ */
+uint8_t QN8066RdsEncoder::setAF(uint16_t *frequencies, uint8_t count) {
+  uint8_t n = 0;
+
+  if ( count > 25 ) count = 25;
+  for (uint8_t i = 0; i < count; i++) {
+    // AF code 1 = 87.6 MHz ... 204 = 107.9 MHz (100 kHz steps)
+    if ( frequencies[i] > 875 && frequencies[i] < 1080 )
+      this->afCodes[++n] = frequencies[i] - 875;
+  }
+
+  if ( n == 0 ) {
+    this->clearAF();
+    return 0;
+  }
+
+  this->afCodes[0] = 224 + n;   // Number of AFs
+  this->afSize = n + 1;
+  if ( this->afSize & 1 )       // Completes the last pair with the filler code
+    this->afCodes[this->afSize++] = 205;
+  this->afIndex = 0;
+
+  return n;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds one PS group (0A with AF list or 0B)
+ * @details If an AF list was set, block 3 carries the next AF pair. Otherwise, block 3 repeats the PI (0B).
+ * @param segment - PS segment (0-3)
+ * @param blockD - two characters of the PS segment
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::buildPSGroup(uint8_t segment, uint16_t blockD, RDS_GROUP *group) {
+  RDS_BLOCK2 b2;
+
+  b2.raw = 0; // Starts block2
+  b2.group0Field.address = segment;
+  b2.group0Field.DI = (this->tx->rdsGetDI() >> (3 - segment)) & 1;  // Segment 0 => d3 ... segment 3 => d0
+  b2.group0Field.MS = this->tx->rdsGetMS();
+  b2.group0Field.TA = this->tx->rdsGetTA();
+  b2.group0Field.programType = this->tx->rdsGetPTY();
+  b2.group0Field.trafficProgramCode = this->tx->rdsGetTP();
+  b2.group0Field.versionCode = (this->afSize == 0); // 0A - Station Name and AF;  0B - Station Name
+  b2.group0Field.groupType = 0;
+  group->blockB = b2.raw;
+
+  if ( this->afSize ) {
+    group->blockC = ((uint16_t) this->afCodes[this->afIndex] << 8) | this->afCodes[this->afIndex + 1];
+    this->afIndex += 2;
+    if ( this->afIndex >= this->afSize ) this->afIndex = 0;
+  } else {
+    group->blockC = this->tx->rdsGetPI();
+  }
+  group->blockD = blockD;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the station name with the AF list (blocking)
+ * @details Like QN8066::rdsSendPS, but each group 0A carries the next AF pair (see setAF). The PS cycle is sent
+ * @details QN8066::rdsSetRepeatSendGroup times.
+ * @see setAF, QN8066::rdsSetStationName
+ */
+void QN8066RdsEncoder::sendPS() {
+  RDS_GROUP group;
+  qn8066_rds_stats *stats = this->tx->rdsGetStats();
+  const char *ps = this->tx->rdsGetPS();
+
+  for ( uint8_t k  = 0; k < this->tx->rdsGetRepeatSendGroup(); k++) {
+    uint8_t errors = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      this->buildPSGroup(i, ((uint16_t) ps[i * 2] << 8) | (uint8_t) ps[i * 2 + 1], &group);
+      this->tx->rdsSendGroup(&group);
+      errors += this->tx->rdsGetError();
+    }
+    if ( errors == 0 && stats != NULL ) stats->lastPSCycle = millis();
+  }
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Prepares a new Radio Text (group 2A or 2B) to be sent
+ * @details The text ends at the first '\0' or '\r'. The group 2A carries up to 64 characters (4 per group) and the group 2B
+ * @details up to 32 characters (2 per group). If the text is shorter than that, it is terminated by '\r' and the last
+ * @details segment is completed with spaces. Only the segments up to the '\r' are sent.
+ * @details The Text A/B flag is handled per message:
+ * @details - same text: the flag is kept and all segments will be sent again (refresh);
+ * @details - only the tail of the text changed: the flag is kept and only the segments from the first changed one will be sent;
+ * @details - first segment changed, shorter text or different version: the flag is toggled (the receiver clears its
+ * @details   Radio Text buffer) and all segments will be sent.
+ * @details If rt is NULL, the current text is kept and sent in the given version. Changing the version toggles the flag,
+ * @details and the 2B keeps only the first 32 characters of the text.
+ * @param rt - Radio Text. If NULL, the current text is kept and all its segments will be sent again.
+ * @param version - 0 = 2A (default); 1 = 2B.
+ * @see sendRTMessage, process
+ */
+void QN8066RdsEncoder::setRTMessage(const char *rt, uint8_t version) {
+
+  uint8_t maxLen, segSize, len = 0, diff = 0xFF;
+  char c;
+
+  this->rtFirstSegment = 0;
+  maxLen = (version) ? 32 : 64;
+  segSize = (version) ? 2 : 4;
+
+  if ( rt == NULL ) {
+    // Keeps the current text (already converted)
+    if ( this->rtSegments == 0 ) return;     // There is no text yet
+    len = (this->rtLength < maxLen) ? this->rtLength : maxLen;
+  } else {
+    // Copies (converts) the new text and finds the first character that changed
+    while ( len < maxLen && *rt != '\0' && *rt != '\r' ) {
+      c = this->nextChar(&rt);
+      if ( diff == 0xFF && (len >= this->rtLength || this->rtBuffer[len] != c) ) diff = len;
+      this->rtBuffer[len++] = c;
+    }
+  }
+
+  if ( version != this->rtVersion || len < this->rtLength || this->rtSegments == 0 || diff < segSize )
+    this->textAB = !this->textAB;  // New message
+  else if ( diff != 0xFF )
+    this->rtFirstSegment = diff / segSize;  // Only the tail changed
+
+  this->rtVersion = version;
+  this->rtLength = len;
+  if ( len < maxLen ) {
+    // Terminates the text with '\r' and completes the segment with spaces
+    this->rtBuffer[len++] = '\r';
+    while ( len % segSize ) this->rtBuffer[len++] = ' ';
+  }
+  this->rtSegments = len / segSize;
+  this->rtSegment = this->rtFirstSegment;  // process starts from the first changed segment
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the segments of the Radio Text prepared by setRTMessage (blocking)
+ * @details This function repeats sending the segments QN8066::rdsSetRepeatSendGroup times.
+ * @details If RT+ is enabled, the ODA announcement (3A) is sent once and the RT+ tags (11A) after each RT cycle.
+ * @see setRTMessage, setRTPlus
+ */
+void QN8066RdsEncoder::sendRTMessage() {
+
+    RDS_GROUP group;
+
+    // RT+: The announcement is sent once per message and the tags once per RT cycle.
+    if ( this->rtPlusEnabled ) this->sendRTPlusAnnouncement();
+
+    // Sending the packet only once did not work for some types of receivers with RDS support.
+    // Therefore, the same RT message is sent three or more times (see rdsSetRepeatSendGroup).
+    for ( uint8_t k  = 0; k < this->tx->rdsGetRepeatSendGroup(); k++) {
+      for (uint8_t i = this->rtFirstSegment; i < this->rtSegments; i++) {
+          this->buildRTGroup(i, &group);
+          this->tx->rdsSendGroup(&group);
+      }
+      if ( this->rtPlusEnabled ) this->sendRTPlusTags();
+    }
+    this->rtFirstSegment = 0;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds one segment of the current Radio Text (group 2A or 2B)
+ * @param segment - Radio Text segment (0-15)
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::buildRTGroup(uint8_t segment, RDS_GROUP *group) {
+    RDS_BLOCK2 block2;
+    uint8_t *seg;
+
+    block2.raw = 0;
+    block2.group2Field.address = segment;
+    block2.group2Field.textABFlag = this->textAB;
+    block2.group2Field.programType = this->tx->rdsGetPTY();
+    block2.group2Field.trafficProgramCode = this->tx->rdsGetTP();
+    block2.group2Field.versionCode = this->rtVersion; // Version A or B
+    block2.group2Field.groupType = 2;  // Group 2
+    group->blockB = block2.raw;
+
+    if ( this->rtVersion == 0 ) {
+      seg = (uint8_t *) &this->rtBuffer[segment * 4];
+      group->blockC = ((uint16_t) seg[0] << 8) | seg[1];
+      group->blockD = ((uint16_t) seg[2] << 8) | seg[3];
+    } else {
+      seg = (uint8_t *) &this->rtBuffer[segment * 2];
+      group->blockC = this->tx->rdsGetPI();  // 2B - Block 3 repeats the PI
+      group->blockD = ((uint16_t) seg[0] << 8) | seg[1];
+    }
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sets the RadioText Plus (RT+) tags
+ * @details RT+ tells the receiver where some content (Title, Artist etc) is inside the Radio Text.
+ * @details Each tag has a content type, the position of the first character in the Radio Text (0 to 63) and the length.
+ * @details The tags refer to the Radio Text set by setRTMessage. The RT+ item toggle bit follows the Text A/B flag of
+ * @details the Radio Text, so when a new Radio Text is sent the receiver knows that the tags are new too.
+ * @details The tag groups are precomputed here, so no extra processing is done while the groups are sent.
+ * @param contentType1 - content type of the first tag. Examples: RTPLUS_ITEM_TITLE, RTPLUS_ITEM_ARTIST
+ * @param start1 - position of the first character of the first tag
+ * @param length1 - number of characters of the first tag (0 = unused tag)
+ * @param contentType2 - content type of the second tag (default RTPLUS_DUMMY_CLASS)
+ * @param start2 - position of the first character of the second tag
+ * @param length2 - number of characters of the second tag (maximum 32; 0 = unused tag)
+ * @details Example
+ * @code
+ * void setup() {
+ *   ...
+ *   rds.begin(&tx);
+ *   rds.setRTPlus(true);
+ *   rds.setRTPlusTags(RTPLUS_ITEM_TITLE, 0, 8, RTPLUS_ITEM_ARTIST, 11, 11);
+ *   rds.setRTMessage("Hey Jude - The Beatles");
+ * }
+ *
+ * void loop() {
+ *   rds.process();
+ * }
+ * @endcode
+ * @see setRTPlus, setRTPlusRunning, setRTMessage
+ */
+void QN8066RdsEncoder::setRTPlusTags(uint8_t contentType1, uint8_t start1, uint8_t length1, uint8_t contentType2, uint8_t start2, uint8_t length2) {
+
+  // The length marker is the number of additional characters (length - 1).
+  if ( length1 == 0 || start1 > 63 ) contentType1 = start1 = length1 = 0; else length1--;
+  if ( length2 == 0 || start2 > 63 ) contentType2 = start2 = length2 = 0; else length2--;
+
+  this->rtPlusType1 = contentType1 & 0B111111;
+  this->rtPlusBlock3 = ((uint16_t)(contentType1 & 0B111) << 13) | ((uint16_t)(start1 & 0B111111) << 7) | ((length1 & 0B111111) << 1) | ((contentType2 >> 5) & 1);
+  this->rtPlusBlock4 = ((uint16_t)(contentType2 & 0B11111) << 11) | ((uint16_t)(start2 & 0B111111) << 5) | (length2 & 0B11111);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the RT+ ODA announcement (group 3A)
+ * @details Block 2 carries the group type used by the RT+ tags (11A), block 3 the RT+ message bits (template 0) and
+ * @details block 4 the RT+ AID (0x4BD7). It is called by sendRTMessage when RT+ is enabled.
+ * @see setRTPlus, sendRTPlusTags
+ */
+void QN8066RdsEncoder::sendRTPlusAnnouncement() {
+  // Message bits: no CB flag, no SCB and template 0
+  this->tx->rdsSendODAAnnouncement(QN8066_RTPLUS_GROUP, 0, 0x0000, QN8066_RTPLUS_AID);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the RT+ tags (group 11A)
+ * @details The item toggle bit follows the Text A/B flag of the Radio Text. It is called by sendRTMessage when RT+ is enabled.
+ * @see setRTPlus, setRTPlusTags, sendRTPlusAnnouncement
+ */
+void QN8066RdsEncoder::sendRTPlusTags() {
+  RDS_GROUP group;
+
+  this->buildRTPlusTags(&group);
+  this->tx->rdsSendGroup(&group);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds the RT+ tags group (11A)
+ * @see sendRTPlusTags
+ */
+void QN8066RdsEncoder::buildRTPlusTags(RDS_GROUP *group) {
+  RDS_BLOCK2 block2;
+
+  block2.raw = 0;
+  block2.commonFields.groupType = QN8066_RTPLUS_GROUP;
+  block2.commonFields.versionCode = 0;
+  block2.commonFields.programType = this->tx->rdsGetPTY();
+  block2.commonFields.trafficProgramCode = this->tx->rdsGetTP();
+  block2.commonFields.textABFlag = this->textAB;   // Item toggle bit
+  block2.commonFields.additionalData = (this->rtPlusRunning << 3) | (this->rtPlusType1 >> 3);
+  group->blockB = block2.raw;
+  group->blockC = this->rtPlusBlock3;
+  group->blockD = this->rtPlusBlock4;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds the group 1A (ECC or language and Programme Item Number)
+ * @details The variants 0 (ECC) and 3 (language) are sent alternately when both are set.
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::build1AGroup(RDS_GROUP *group) {
+  RDS_BLOCK2 block2;
+  uint8_t variant = this->variant1A;
+
+  if ( variant == 0 && this->ecc == 0 && this->language ) variant = 3;
+  if ( variant == 3 && this->language == 0 ) variant = 0;
+  this->variant1A = (variant == 0) ? 3 : 0;
+
+  block2.raw = 0;
+  block2.commonFields.groupType = 1;
+  block2.commonFields.versionCode = 0;
+  block2.commonFields.programType = this->tx->rdsGetPTY();
+  block2.commonFields.trafficProgramCode = this->tx->rdsGetTP();  // Radio paging codes (5 bits) = 0
+  group->blockB = block2.raw;
+  // Block 3: LA (0) | variant code (3 bits) | data (12 bits)
+  group->blockC = ((uint16_t) variant << 12) | ((variant == 0) ? this->ecc : this->language);
+  group->blockD = this->pin;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the group 1A (ECC or language and PIN)
+ * @details process sends this group automatically. Use this function only with the blocking RDS functions.
+ * @see setECC, setLanguage, setPIN
+ */
+void QN8066RdsEncoder::sendGroup1A() {
+  RDS_GROUP group;
+
+  this->build1AGroup(&group);
+  this->tx->rdsSendGroup(&group);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sets the Programme Type Name (PTYN - group 10A)
+ * @details PTYN describes the PTY with more detail (Example: PTY Rock and PTYN "HARDROCK"). It is only shown with the PTY.
+ * @details The A/B flag is toggled when the name changes. process sends the two segments of the group 10A at low rate.
+ * @param ptyn - up to 8 characters. NULL or empty string stops sending the group 10A.
+ * @see sendPTYN, QN8066::rdsSetPTY, process
+ */
+void QN8066RdsEncoder::setPTYN(const char *ptyn) {
+  char name[8];
+  uint8_t i = 0;
+
+  if ( ptyn == NULL || *ptyn == '\0' ) {
+    this->ptynEnabled = false;
+    return;
+  }
+
+  while ( i < 8 && *ptyn != '\0' ) name[i++] = this->nextChar(&ptyn);
+  while ( i < 8 ) name[i++] = ' ';
+
+  if ( !this->ptynEnabled || memcmp(name, this->ptyn, 8) != 0 ) {
+    this->ptynAB = !this->ptynAB;
+    memcpy(this->ptyn, name, 8);
+    this->ptynSegment = 0;
+  }
+  this->ptynEnabled = true;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds one segment of the Programme Type Name (group 10A)
+ * @param segment - 0 or 1 (4 characters each)
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::buildPTYNGroup(uint8_t segment, RDS_GROUP *group) {
+  RDS_BLOCK2 block2;
+  uint8_t *c = (uint8_t *) &this->ptyn[segment * 4];
+
+  block2.raw = 0;
+  block2.commonFields.groupType = 10;
+  block2.commonFields.versionCode = 0;
+  block2.commonFields.programType = this->tx->rdsGetPTY();
+  block2.commonFields.trafficProgramCode = this->tx->rdsGetTP();
+  block2.commonFields.textABFlag = this->ptynAB;
+  block2.commonFields.additionalData = segment & 1;
+  group->blockB = block2.raw;
+  group->blockC = ((uint16_t) c[0] << 8) | c[1];
+  group->blockD = ((uint16_t) c[2] << 8) | c[3];
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sends the Programme Type Name (both segments of the group 10A)
+ * @details process sends this group automatically. Use this function only with the blocking RDS functions.
+ * @see setPTYN
+ */
+void QN8066RdsEncoder::sendPTYN() {
+  RDS_GROUP group;
+
+  if ( !this->ptynEnabled ) return;
+  for ( uint8_t i = 0; i < 2; i++ ) {
+    this->buildPTYNGroup(i, &group);
+    this->tx->rdsSendGroup(&group);
+  }
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Clock Time (CT) service
+ * @details Reads the time source set by setTimeSource and sends one group 4A when the minute changes, as required by
+ * @details the RDS standard (the CT group must start at the minute edge). Call it as often as possible (for example, in the loop)
+ * @details when the blocking RDS functions are used. process does the same thing, so do not call both.
+ * @details The time source is read only near the end of the minute, so a slow RTC (DS1302) does not delay the loop.
+ * @details No group is sent when the service starts in the middle of a minute.
+ * @return true if the group 4A was sent
+ * @code
+ * bool getUtc(qn8066_date_time *dt) {
+ *   Ds1302::DateTime now;
+ *   rtc.getDateTime(&now);
+ *   dt->year = now.year + 2000; dt->month = now.month; dt->day = now.day;
+ *   dt->hour = now.hour; dt->minute = now.minute; dt->second = now.second;
+ *   dt->offset = -6;  // UTC-3:00
+ *   return true;
+ * }
+ * void setup() {
+ *   ...
+ *   rds.begin(&tx);
+ *   rds.setTimeSource(getUtc);
+ * }
+ * void loop() {
+ *   rds.updateClock();
+ *   ...
+ * }
+ * @endcode
+ * @see setTimeSource, qn8066_time_source, QN8066::rdsSendDateTime
+ */
+bool QN8066RdsEncoder::updateClock() {
+  RDS_GROUP group;
+  qn8066_date_time dt;
+
+  if ( !this->clockDue(&dt) ) return false;
+  this->tx->rdsBuildCTGroup(&dt, &group);
+  this->tx->rdsSendGroup(&group);
+  return true;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Reads the time source and checks the minute rollover
+ * @param dt - returns the date and time read
+ * @return true if the minute changed since the last reading (the group 4A must be sent now)
+ * @see updateClock, process
+ */
+bool QN8066RdsEncoder::clockDue(qn8066_date_time *dt) {
+  uint8_t last;
+
+  if ( this->timeSource == NULL || (int32_t) (millis() - this->ctNextPoll) < 0 ) return false;
+  if ( !this->timeSource(dt) || dt->minute > 59 ) return false;
+
+  this->scheduleUpdate(dt);
+
+  // Sleeps until two seconds before the next minute edge
+  this->ctNextPoll = (dt->second < 58) ? millis() + (58 - dt->second) * 1000UL : millis();
+
+  last = this->ctLastMinute;
+  this->ctLastMinute = dt->minute;
+  return !( dt->minute == last || (last == 0xFF && dt->second != 0) );
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sets the programme schedule (PS, RT and PTY by day of the week and time of day)
+ * @details The schedule is checked against the time source of the Clock Time service (see setTimeSource) each time
+ * @details it is read by process or updateClock (at each minute edge), or by calling scheduleUpdate.
+ * @details The PS, RT and PTY are changed only when the entry on air changes, so the group cache is rebuilt once per transition.
+ * @details The entries must be sorted by start time (the days do not matter). The entry on air is found by a binary search.
+ * @param schedule - table in the flash memory (PROGMEM). If reader is not NULL, it is not used (can be NULL).
+ * @param size - number of entries (0 disables the schedule)
+ * @param reader - function that reads the entries from other memories (EEPROM etc). NULL = schedule is in PROGMEM.
+ * @details Example
+ * @code
+ * const qn8066_schedule_entry grid[] PROGMEM = {
+ *   {RDS_SCHEDULE_WEEKDAYS,  6 * 60, 1,  "MORNING",  "GOOD MORNING SHOW - 6 TO 10 AM"},
+ *   {RDS_SCHEDULE_EVERYDAY, 10 * 60, 10, "STATIONX", "THE BEST HITS ALL DAY"},
+ *   {RDS_SCHEDULE_SUN,      18 * 60, 20, "GOSPEL",   ""},
+ *   {RDS_SCHEDULE_EVERYDAY, 22 * 60, 15, "NIGHT",    "NIGHT CLASSICS"}
+ * };
+ * // Schedule in the EEPROM:
+ * // void readEntry(uint8_t index, qn8066_schedule_entry *entry) { EEPROM.get(index * sizeof(qn8066_schedule_entry), *entry); }
+ * // rds.setSchedule(NULL, 4, readEntry);
+ * void setup() {
+ *   ...
+ *   rds.begin(&tx);
+ *   rds.setTimeSource(getUtc);
+ *   rds.setSchedule(grid, 4);
+ * }
+ * void loop() {
+ *   rds.process();
+ * }
+ * @endcode
+ * @see qn8066_schedule_entry, scheduleUpdate, setTimeSource
+ */
+void QN8066RdsEncoder::setSchedule(const qn8066_schedule_entry *schedule, uint8_t size, qn8066_schedule_reader reader) {
+  this->schedule = schedule;
+  this->scheduleReader = reader;
+  this->scheduleSize = size;
+  this->scheduleIndex = -1;
+  this->ctNextPoll = millis();   // The time source is read (and the schedule checked) as soon as possible
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Reads one entry of the programme schedule
+ */
+void QN8066RdsEncoder::scheduleRead(uint8_t index, qn8066_schedule_entry *entry) {
+  if ( this->scheduleReader != NULL )
+    this->scheduleReader(index, entry);
+  else
+    memcpy_P(entry, &this->schedule[index], sizeof(qn8066_schedule_entry));
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Finds the programme schedule entry on air
+ * @details Binary search of the last entry that started until the given minute, then the first one (backwards) that
+ * @details is valid for the day. If there is none, the last entries of the previous days are checked.
+ * @param weekday - 0 = Monday ... 6 = Sunday
+ * @param minute - minutes from 00:00
+ * @return index of the entry (-1 = none)
+ */
+int16_t QN8066RdsEncoder::scheduleFind(uint8_t weekday, uint16_t minute) {
+  qn8066_schedule_entry entry;
+  uint8_t low = 0, high = this->scheduleSize, middle;
+
+  while ( low < high ) {
+    middle = (low + high) / 2;
+    this->scheduleRead(middle, &entry);
+    if ( entry.start <= minute ) low = middle + 1; else high = middle;
+  }
+
+  for (uint8_t d = 0; d < 8; d++) {
+    while ( low > 0 ) {
+      this->scheduleRead(--low, &entry);
+      if ( entry.days & (1 << weekday) ) return low;
+    }
+    weekday = (weekday + 6) % 7;    // Previous day
+    low = this->scheduleSize;
+  }
+  return -1;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Applies the programme schedule entry of the given date and time
+ * @details Called by process and updateClock each time the time source is read. Call it directly if you
+ * @details do not use the time source.
+ * @param dt - UTC date and time and local offset (the schedule is in local time)
+ * @return true if the entry on air changed (PS, RT and PTY were updated)
+ * @see setSchedule
+ */
+bool QN8066RdsEncoder::scheduleUpdate(const qn8066_date_time *dt) {
+  qn8066_schedule_entry entry;
+  int32_t mjd;
+  int16_t minute, index;
+
+  if ( this->scheduleSize == 0 ) return false;
+
+  mjd = QN8066::calculateMJD(dt->year, dt->month, dt->day);
+  minute = dt->hour * 60 + dt->minute + dt->offset * 30;   // Local time
+  if ( minute < 0 ) {
+    minute += 1440;
+    mjd--;
+  } else if ( minute >= 1440 ) {
+    minute -= 1440;
+    mjd++;
+  }
+
+  index = this->scheduleFind((mjd + 2) % 7, minute);   // MJD 0 was a Wednesday
+  if ( index < 0 || index == this->scheduleIndex ) return false;
+
+  this->scheduleIndex = index;
+  this->scheduleRead(index, &entry);
+  if ( entry.pty != 0xFF ) this->tx->rdsSetPTY(entry.pty);
+  if ( entry.ps[0] != '\0' ) this->tx->rdsSetStationName(entry.ps);
+  if ( entry.rt[0] != '\0' ) this->setRTMessage(entry.rt);
+  return true;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Sets a Dynamic PS message
+ * @details Many receivers only show the PS. The Dynamic PS splits a long message (song title, for example) into frames of
+ * @details 8 characters that are sent, one after the other, in the PS groups by process.
+ * @details - RDS_DPS_PAGING: each frame is a page of up to 8 characters. Words are not split, unless they are longer than 8 characters.
+ * @details - RDS_DPS_SCROLLING: the message moves one character per frame.
+ * @details A new frame is encoded in the group cache only at the beginning of a PS cycle (segment 0), so the receiver never
+ * @details shows half of a frame and the dwell time is always a whole number of PS cycles.
+ * @details The static PS (station name) can be shown between two message cycles. See setDynamicPSStaticTime.
+ * @param text - message (up to QN8066_DPS_MAX characters). The text is copied.
+ * @param mode - RDS_DPS_PAGING (default) or RDS_DPS_SCROLLING
+ * @param dwell - time in ms each frame stays on air (default 3000). Values shorter than a PS cycle are rounded up to one cycle.
+ * @details Example
+ * @code
+ * void setup() {
+ *   ...
+ *   tx.rdsSetStationName("STATIONX");
+ *   rds.begin(&tx);
+ *   rds.setDynamicPS("NOW PLAYING: HEY JUDE - THE BEATLES");
+ *   rds.setDynamicPSStaticTime(4000); // Shows "STATIONX" for 4s after each message cycle
+ * }
+ *
+ * void loop() {
+ *   rds.process();
+ * }
+ * @endcode
+ * @see process, setDynamicPSStaticTime, clearDynamicPS
+ */
+void QN8066RdsEncoder::setDynamicPS(const char *text, uint8_t mode, uint16_t dwell) {
+  uint8_t len = 0;
+
+  while ( *text == ' ' ) text++;  // Leading and trailing spaces would make empty pages
+  while ( len < QN8066_DPS_MAX && *text != '\0' ) this->dpsBuffer[len++] = this->nextChar(&text);
+  while ( len > 0 && this->dpsBuffer[len - 1] == ' ' ) len--;
+
+  this->dpsMode = mode;
+  this->dpsDwell = dwell;
+  this->dpsStart = 0;
+  this->dpsLength = len;
+  this->dpsSize = this->dpsFrameSize(0);
+  this->dpsStatic = false;
+  this->dpsFrameTime = millis();
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Number of characters of the Dynamic PS frame that starts at a given position
+ * @details In paging mode, the page ends at the last space before a word that does not fit in the 8 characters.
+ * @param start - first character of the frame
+ * @return number of characters (up to 8)
+ */
+uint8_t QN8066RdsEncoder::dpsFrameSize(uint8_t start) {
+  uint8_t k, size = this->dpsLength - start;
+
+  if ( size <= 8 ) return size;
+
+  if ( this->dpsMode == RDS_DPS_PAGING && this->dpsBuffer[start + 8] != ' ' ) {
+    for ( k = 7; k > 0 && this->dpsBuffer[start + k] != ' '; k-- );
+    if ( k > 0 ) return k;   // Otherwise, the word is longer than 8 characters and it is split
+  }
+  return 8;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Selects the PS frame of the next PS cycle and encodes it in the group cache
+ * @details Called by process before sending the PS segment 0.
+ */
+void QN8066RdsEncoder::nextPSFrame() {
+  const char *src = this->tx->rdsGetPS();
+  uint8_t size = 8;
+
+  if ( this->dpsLength ) {
+    if ( (millis() - this->dpsFrameTime) >= ((this->dpsStatic) ? this->dpsStaticTime : this->dpsDwell) ) {
+      uint8_t next = 0;
+      this->dpsFrameTime = millis();
+      if ( this->dpsStatic ) {
+        this->dpsStatic = false;  // Starts a new message cycle
+      } else {
+        if ( this->dpsMode == RDS_DPS_SCROLLING ) {
+          next = this->dpsStart + 1;
+          if ( next + 8 > this->dpsLength ) next = this->dpsLength;
+        } else {
+          next = this->dpsStart + this->dpsSize;
+          while ( next < this->dpsLength && this->dpsBuffer[next] == ' ' ) next++;
+        }
+        if ( next >= this->dpsLength ) {  // End of the message cycle
+          next = 0;
+          this->dpsStatic = (this->dpsStaticTime != 0);
+        }
+      }
+      this->dpsStart = next;
+      this->dpsSize = this->dpsFrameSize(next);
+    }
+    if ( !this->dpsStatic ) {
+      src = &this->dpsBuffer[this->dpsStart];
+      size = this->dpsSize;
+    }
+  }
+
+  for ( uint8_t i = 0; i < 4; i++ ) {
+    uint8_t c0 = (i * 2 < size) ? src[i * 2] : ' ';
+    uint8_t c1 = (i * 2 + 1 < size) ? src[i * 2 + 1] : ' ';
+    this->psCache[i] = ((uint16_t) c0 << 8) | c1;
+  }
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Adds a group to be sent by process before the scheduled groups
+ * @details Use it for groups that must go on air as soon as possible.
+ * @param blockB - block 2
+ * @param blockC - block 3
+ * @param blockD - block 4
+ * @return false if the queue is full (QN8066_RDS_QUEUE_SIZE groups)
+ * @see process
+ */
+bool QN8066RdsEncoder::queueGroup(uint16_t blockB, uint16_t blockC, uint16_t blockD) {
+  RDS_GROUP *group;
+
+  if ( this->queueCount >= QN8066_RDS_QUEUE_SIZE ) return false;
+
+  group = &this->queue[(this->queueHead + this->queueCount) % QN8066_RDS_QUEUE_SIZE];
+  group->blockB = blockB;
+  group->blockC = blockC;
+  group->blockD = blockD;
+  this->queueCount++;
+  return true;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Switches the Traffic Announcement (TA) on or off as fast as possible
+ * @details Unlike QN8066::rdsSetTA, that only changes the flag used by the next groups built, this function:
+ * @details - replaces the group already loaded in the QN8066 (not fetched yet) by a PS group with the new TA flag.
+ * @details   A PS group is loaded again with only the TA flag changed (same segment and AF pair); other groups are queued
+ * @details   again. The 8 bytes are written in one I2C transaction (see QN8066::rdsLoadGroup);
+ * @details - makes process send the next setTABurst groups as 0A/0B (PS cycle) before any other group.
+ * @details   The default burst (8 groups, about 0.7s) sends two complete PS cycles. Then process returns to the normal schedule.
+ * @details The time from the call to the fetch of the first group with the new TA flag is measured (see getTALatency).
+ * @details The receivers only switch to the traffic announcement if TP is 1 (see QN8066::rdsSetTP).
+ * @param on - true = traffic announcement on air; false = end of the traffic announcement
+ * @details Example
+ * @code
+ * tx.rdsSetTP(1);
+ * ...
+ * rds.setTrafficAnnouncement(true);   // Traffic bulletin starts
+ * ...
+ * rds.setTrafficAnnouncement(false);  // Traffic bulletin ends
+ * @endcode
+ * @see setTABurst, getTALatency, process, QN8066::rdsSetTP
+ */
+void QN8066RdsEncoder::setTrafficAnnouncement(bool on) {
+  RDS_GROUP group;
+
+  if ( (uint8_t) on == this->tx->rdsGetTA() ) return;
+
+  this->tx->rdsSetTA(on);
+  this->taRequest = micros();
+  this->taMeasure = 1;
+  this->taBurstLeft = this->taBurst;
+
+  // The group loaded by process and not fetched yet would still carry the old TA flag
+  if ( this->txUpdState < 0 || this->tx->rdsGetTxUpdated() != (uint8_t) this->txUpdState ) return;
+
+  if ( (this->lastGroup.blockB >> 12) == 0 ) {
+    // Same group with the new TA flag (rebuilding it would skip one AF pair)
+    RDS_BLOCK2 b2;
+    b2.raw = this->lastGroup.blockB;
+    b2.group0Field.TA = on;
+    group = this->lastGroup;
+    group.blockB = b2.raw;
+    this->taMeasure = 2;
+  } else {
+    if ( this->queueCount < QN8066_RDS_QUEUE_SIZE ) {
+      this->queueHead = (this->queueHead + QN8066_RDS_QUEUE_SIZE - 1) % QN8066_RDS_QUEUE_SIZE;
+      this->queue[this->queueHead] = this->lastGroup;
+      this->queueCount++;
+    }
+    this->nextPSGroup(&group);
+  }
+  this->tx->rdsLoadGroup(&group, false);
+  this->lastGroup = group;
+  if ( this->taBurstLeft ) this->taBurstLeft--;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Gets the next group from the low rate sources (RT+ announcement, RT+ tags, 1A and 10A)
+ * @details The sources are checked in round robin. Sources without data are skipped.
+ * @param group - the group built
+ * @return false if no source has data to send
+ */
+bool QN8066RdsEncoder::nextLowRateGroup(RDS_GROUP *group) {
+  const uint8_t sources = 4;
+
+  for ( uint8_t i = 0; i < sources; i++ ) {
+    uint8_t source = this->lowRateIndex;
+    this->lowRateIndex = (source + 1) % sources;
+    switch ( source ) {
+      case 0:   // RT+ announcement (3A)
+        if ( this->rtPlusEnabled && this->rtSegments ) {
+          this->tx->rdsBuildODAAnnouncement(QN8066_RTPLUS_GROUP, 0, 0x0000, QN8066_RTPLUS_AID, group);
+          return true;
+        }
+        break;
+      case 1:   // RT+ tags (11A)
+        if ( this->rtPlusEnabled && this->rtSegments ) {
+          this->buildRTPlusTags(group);
+          return true;
+        }
+        break;
+      case 2:   // ECC, language and PIN (1A)
+        if ( this->ecc || this->language || this->pin ) {
+          this->build1AGroup(group);
+          return true;
+        }
+        break;
+      case 3:   // Programme Type Name (10A)
+        if ( this->ptynEnabled ) {
+          this->buildPTYNGroup(this->ptynSegment, group);
+          this->ptynSegment ^= 1;
+          return true;
+        }
+        break;
+    }
+  }
+  return false;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Registers an Open Data Application (ODA)
+ * @details process sends the announcement (group 3A with the AID) and the data groups of the registered applications
+ * @details at the intervals given here. The data groups are filled by the callback, so a new ODA does not need any change
+ * @details in the library. The registry is a fixed size table (QN8066_ODA_MAX entries).
+ * @details If the AID is already registered, its entry is updated.
+ * @details Reserved group types (rejected): 0, 1, 2 and 4 (PS, PIN, Radio Text and Clock Time), 3A (ODA announcement),
+ * @details 10A (PTYN), 11A (RT+ tags, see setRTPlus), 12A (eRT - enhanced Radio Text), 14 (EON) and 15 (fast basic tuning).
+ * @param aid - Application Identification
+ * @param groupType - group type of the data groups. Valid: 3B, 5, 6, 7, 8, 9, 10B, 11B, 12B and 13 (A or B).
+ * @param version - 0 = A; 1 = B
+ * @param callback - function that fills the data groups (NULL = announcement only)
+ * @param message - block 3 of the announcement (depends on the application)
+ * @param dataInterval - one data group every dataInterval groups (default 20 groups - about 1.75s; 0 = no data groups)
+ * @param announceInterval - one announcement every announceInterval groups (default 100 groups - about 8.8s; 0 = no announcement)
+ * @return index of the entry or -1 if the table is full or the group type is used by other RDS features
+ * @details Example
+ * @code
+ * uint16_t counter = 0;
+ *
+ * bool myData(uint16_t aid, RDS_GROUP *group) {
+ *   group->blockB = 0;         // 5 bits of application data
+ *   group->blockC = 0x1234;
+ *   group->blockD = counter++;
+ *   return true;
+ * }
+ *
+ * void setup() {
+ *   ...
+ *   rds.begin(&tx);
+ *   rds.registerODA(0xC3B0, 8, 0, myData);   // Data in the group 8A
+ * }
+ *
+ * void loop() {
+ *   rds.process();
+ * }
+ * @endcode
+ * @see unregisterODA, process, qn8066_oda_callback
+ */
+int8_t QN8066RdsEncoder::registerODA(uint16_t aid, uint8_t groupType, uint8_t version, qn8066_oda_callback callback, uint16_t message, uint16_t dataInterval, uint16_t announceInterval) {
+  int8_t idx = -1;
+
+  version &= 1;
+  if ( aid == 0 || groupType > 13 || groupType == 0 || groupType == 1 || groupType == 2 || groupType == 4 ||
+       (version == 0 && (groupType == 3 || groupType == 10 || groupType == 11 || groupType == 12)) )
+    return -1;
+
+  for ( uint8_t i = 0; i < QN8066_ODA_MAX; i++ ) {
+    if ( this->oda[i].aid == aid ) { idx = i; break; }
+    if ( idx < 0 && this->oda[i].aid == 0 ) idx = i;
+  }
+  if ( idx < 0 ) return -1;
+
+  qn8066_oda *oda = &this->oda[idx];
+  oda->aid = aid;
+  oda->groupType = groupType;
+  oda->version = version;
+  oda->callback = callback;
+  oda->message = message;
+  oda->dataInterval = dataInterval;
+  oda->announceInterval = announceInterval;
+  oda->dataAge = 0;
+  oda->announceAge = announceInterval;  // The announcement goes first
+  return idx;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Removes an Open Data Application from the registry
+ * @param aid - Application Identification
+ * @return false if the AID was not registered
+ * @see registerODA
+ */
+bool QN8066RdsEncoder::unregisterODA(uint16_t aid) {
+  for ( uint8_t i = 0; i < QN8066_ODA_MAX; i++ ) {
+    if ( this->oda[i].aid == aid ) {
+      this->oda[i].aid = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Gets the next ODA group (announcement or data) that is due
+ * @details Called once per scheduled group. The entries are checked in round robin, so an application with a short
+ * @details interval does not block the others.
+ * @param group - the group built
+ * @return false if no ODA group is due
+ */
+bool QN8066RdsEncoder::nextODAGroup(RDS_GROUP *group) {
+  RDS_BLOCK2 block2;
+  bool found = false;
+
+  for ( uint8_t i = 0; i < QN8066_ODA_MAX; i++ ) {
+    qn8066_oda *oda = &this->oda[i];
+    if ( oda->aid == 0 ) continue;
+    if ( oda->dataAge < 0xFFFF ) oda->dataAge++;
+    if ( oda->announceAge < 0xFFFF ) oda->announceAge++;
+  }
+
+  for ( uint8_t i = 0; i < QN8066_ODA_MAX && !found; i++ ) {
+    qn8066_oda *oda = &this->oda[this->odaIndex];
+    this->odaIndex = (this->odaIndex + 1) % QN8066_ODA_MAX;
+    if ( oda->aid == 0 ) continue;
+
+    if ( oda->announceInterval && oda->announceAge >= oda->announceInterval ) {
+      this->tx->rdsBuildODAAnnouncement(oda->groupType, oda->version, oda->message, oda->aid, group);
+      oda->announceAge = 0;
+      found = true;
+    } else if ( oda->callback && oda->dataInterval && oda->dataAge >= oda->dataInterval ) {
+      group->blockB = 0;
+      if ( oda->callback(oda->aid, group) ) {
+        block2.raw = 0;
+        block2.commonFields.groupType = oda->groupType;
+        block2.commonFields.versionCode = oda->version;
+        block2.commonFields.programType = this->tx->rdsGetPTY();
+        block2.commonFields.trafficProgramCode = this->tx->rdsGetTP();
+        group->blockB = block2.raw | (group->blockB & 0B11111);
+        if ( oda->version ) group->blockC = this->tx->rdsGetPI();
+        found = true;
+      }
+      oda->dataAge = 0;
+    }
+  }
+  return found;
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Gets the next scheduled group
+ * @details The schedule has 10 slots. Even slots send the PS (0A/0B), odd slots send the Radio Text (2A/2B) and
+ * @details the last slot sends a low rate group (RT+ etc). Slots without data are used by the PS (or by the Radio Text).
+ * @details So, with Radio Text, a PS cycle (4 groups) takes 8 groups (about 0.7s), and each low rate source is sent about once per second.
+ * @details The groups of the registered Open Data Applications (see registerODA) are sent before the schedule when they are due.
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::nextGroup(RDS_GROUP *group) {
+  uint8_t slot;
+
+  if ( this->nextODAGroup(group) ) return;
+
+  slot = this->slot;
+  this->slot = (slot + 1) % 10;
+
+  if ( slot == 9 && this->nextLowRateGroup(group) ) return;
+
+  if ( (slot & 1) && this->rtSegments ) {
+    if ( this->rtSegment >= this->rtSegments ) this->rtSegment = 0;
+    this->buildRTGroup(this->rtSegment++, group);
+    return;
+  }
+
+  this->nextPSGroup(group);
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Builds the next segment of the PS cycle (group 0A or 0B)
+ * @details A new Dynamic PS frame is selected at the first segment of each cycle.
+ * @param group - the group built
+ */
+void QN8066RdsEncoder::nextPSGroup(RDS_GROUP *group) {
+  qn8066_rds_stats *stats;
+
+  if ( this->psSegment == 0 ) this->nextPSFrame();
+  this->buildPSGroup(this->psSegment, this->psCache[this->psSegment], group);
+  if ( ++this->psSegment > 3 ) {
+    this->psSegment = 0;
+    stats = this->tx->rdsGetStats();
+    if ( stats != NULL ) stats->lastPSCycle = millis();
+  }
+  if ( this->taMeasure == 1 ) this->taMeasure = 2;  // First group with the new TA flag
+}
+
+/**
+ * @ingroup group05 TX RDS
+ * @brief Non-blocking RDS encoder
+ * @details Instead of waiting for the QN8066 to fetch each group (rdsSendPS, rdsSendRTMessage etc), process reads
+ * @details RDS_TXUPD once and, only when the chip has fetched the last group, loads the next one. Call it in the loop
+ * @details as often as possible (at least every 50 ms) and do not call the blocking RDS functions while using it.
+ * @details The groups are sent in this order:
+ * @details 1. the burst of 0A/0B groups after a TA change (see setTrafficAnnouncement);
+ * @details 2. the group 4A at the minute edge (see setTimeSource) and the groups added by queueGroup;
+ * @details 3. the Open Data Application groups that are due (see registerODA);
+ * @details 4. the schedule: PS (static or Dynamic PS), Radio Text and low rate groups. See nextGroup.
+ * @details The statistics (QN8066::rdsSetStats) are updated here and the group period measured by QN8066::rdsCalibrate
+ * @details (QN8066::rdsSetCalibration) is used to detect the groups not fetched by the chip.
+ * @return true if a group was loaded
+ * @see setDynamicPS, queueGroup, setRTMessage, QN8066::rdsSetStationName
+ */
+bool QN8066RdsEncoder::process() {
+  RDS_GROUP group;
+  qn8066_date_time dt;
+  qn8066_rds_stats *stats = this->tx->rdsGetStats();
+  const qn8066_rds_calibration *cal = this->tx->rdsGetCalibration();
+  uint8_t upd = this->tx->rdsGetTxUpdated();
+  uint32_t now = micros();
+  uint32_t period = (cal != NULL && cal->groupPeriod) ? cal->groupPeriod : 87600UL;
+
+  if ( this->txUpdState == (int8_t) upd ) {
+    // The chip is still sending the last group. If it does not fetch it, loads a new one anyway.
+    if ( (now - this->loadTime) < (period << 1) ) return false;
+    if ( stats != NULL ) stats->timeouts++;
+  } else if ( this->txUpdState >= 0 ) {
+    // The chip fetched the last group. If it took too long to see it, the chip sent the same group again.
+    if ( stats != NULL ) {
+      if ( stats->lastFetch && (now - stats->lastFetch) > (period + (period >> 1)) )
+        stats->underruns++;
+      stats->lastFetch = now;
+    }
+    if ( this->taMeasure == 2 ) {   // The first group with the new TA flag is on air
+      this->taLatency = now - this->taRequest;
+      this->taMeasure = 0;
+    }
+  }
+
+  // The group 4A must start at the minute edge
+  if ( this->clockDue(&dt) ) {
+    this->tx->rdsBuildCTGroup(&dt, &group);
+    this->queueGroup(group.blockB, group.blockC, group.blockD);
+  }
+
+  if ( this->taBurstLeft ) {
+    this->taBurstLeft--;
+    this->nextPSGroup(&group);
+  } else if ( this->queueCount ) {
+    group = this->queue[this->queueHead];
+    this->queueHead = (this->queueHead + 1) % QN8066_RDS_QUEUE_SIZE;
+    this->queueCount--;
+  } else {
+    this->nextGroup(&group);
+  }
+
+  this->tx->rdsLoadGroup(&group);
+  this->lastGroup = group;
+  this->txUpdState = upd;
+  this->loadTime = now;
+  if ( stats != NULL ) {
+    stats->groups[group.blockB >> 12]++;
+    stats->total++;
+  }
+
+  return true;
+}
@@ -0,0 +1,346 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - TX RDS encoder (non-blocking group scheduler)
+ *
+ * @details This file contains the RDS group scheduler of the QN8066 transmitter: static and Dynamic PS with the AF list
+ * @details (0A), Radio Text (2A/2B) with RT+, Clock Time service (4A), programme schedule, traffic announcement burst,
+ * @details group 1A, PTYN (10A), a send queue and the Open Data Applications registry. The encoder is a separate object,
+ * @details so the QN8066 class does not carry its buffers when only the blocking RDS functions (rdsSendPS,
+ * @details rdsSendRTMessage etc) are used. Nothing is allocated.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_RDS_ENCODER_H // Prevent this file from being compiled more than once
+#define _QN8066_RDS_ENCODER_H
+
+#include <QN8066.h>
+
+/**
+ * @brief RDS group scheduler (process) and Dynamic PS
+ *
+ */
+#define QN8066_RDS_QUEUE_SIZE 4   //<! Number of groups that can wait to be sent before the scheduled ones (see queueGroup)
+#define QN8066_DPS_MAX 64         //<! Maximum length of the Dynamic PS message
+#define QN8066_ODA_MAX 4          //<! Maximum number of Open Data Applications registered (see registerODA)
+#define RDS_DPS_PAGING 0          //<! Dynamic PS: pages of 8 characters that do not split words
+#define RDS_DPS_SCROLLING 1       //<! Dynamic PS: the message scrolls one character per frame
+
+/**
+ * @brief Days of the week of the programme schedule entries. See setSchedule
+ *
+ */
+#define RDS_SCHEDULE_MON 1
+#define RDS_SCHEDULE_TUE 2
+#define RDS_SCHEDULE_WED 4
+#define RDS_SCHEDULE_THU 8
+#define RDS_SCHEDULE_FRI 16
+#define RDS_SCHEDULE_SAT 32
+#define RDS_SCHEDULE_SUN 64
+#define RDS_SCHEDULE_WEEKDAYS 31  //<! Monday to Friday
+#define RDS_SCHEDULE_WEEKEND 96   //<! Saturday and Sunday
+#define RDS_SCHEDULE_EVERYDAY 127
+
+/**
+ * @ingroup group00 RDS
+ * @brief Open Data Application data callback
+ * @details Called by process when a data group of the application is due. The callback fills the 5 least significant
+ * @details bits of blockB and the blocks C and D (in version B groups, block C is replaced by the PI).
+ * @details It must return false if there is nothing to send (the slot is then used by the other groups).
+ * @see QN8066RdsEncoder::registerODA
+ */
+typedef bool (*qn8066_oda_callback)(uint16_t aid, RDS_GROUP *group);
+
+/**
+ * @ingroup group00 RDS
+ * @brief Open Data Application registry entry (qn8066_oda data type)
+ * @see QN8066RdsEncoder::registerODA, QN8066RdsEncoder::unregisterODA
+ */
+typedef struct {
+  uint16_t aid;                   //!< Application Identification (0 = free entry)
+  uint16_t message;               //!< Block 3 of the announcement (3A)
+  uint8_t groupType;              //!< Group type used by the application data (Example: 11 for 11A)
+  uint8_t version;                //!< 0 = A; 1 = B
+  uint16_t dataInterval;          //!< One data group every dataInterval groups (0 = no data groups)
+  uint16_t announceInterval;      //!< One 3A announcement every announceInterval groups (0 = no announcement)
+  uint16_t dataAge;               //!< Groups sent since the last data group
+  uint16_t announceAge;           //!< Groups sent since the last announcement
+  qn8066_oda_callback callback;   //!< Fills the data groups
+} qn8066_oda;
+
+/**
+ * @ingroup group00 RDS
+ * @brief Programme schedule entry (qn8066_schedule_entry data type)
+ * @details The entry is on air from its start time (local time) until the start of the next entry of the same day
+ * @details (or of the next days). Empty ps or rt and pty = 0xFF keep the current value.
+ * @see QN8066RdsEncoder::setSchedule
+ */
+typedef struct {
+  uint8_t days;     //!< Days of the week (RDS_SCHEDULE_* flags OR-ed)
+  uint16_t start;   //!< Start time in minutes from 00:00 (hour * 60 + minute), local time
+  uint8_t pty;      //!< Programme Type (0xFF = not changed)
+  char ps[9];       //!< Station name (PS)
+  char rt[65];      //!< Radio Text
+} qn8066_schedule_entry;
+
+/**
+ * @ingroup group00 RDS
+ * @brief Reads one entry of a programme schedule that is not in the flash memory (EEPROM, SD card etc)
+ * @see QN8066RdsEncoder::setSchedule
+ */
+typedef void (*qn8066_schedule_reader)(uint8_t index, qn8066_schedule_entry *entry);
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066RdsEncoder Class - TX RDS encoder
+ * @details The PI, PTY, TP, TA, DI, MS and the station name are the ones of the QN8066 instance (rdsSetPI, rdsSetPTY,
+ * @details rdsSetStationName etc). Do not call the blocking RDS functions of the QN8066 class while using process.
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsEncoder.h>
+ * QN8066 tx;
+ * QN8066RdsEncoder rds;
+ * void setup() {
+ *   tx.setup();
+ *   tx.setTX(1069); // Set the transmitter to 106.9 MHz
+ *   tx.rdsTxEnable(true);
+ *   tx.rdsInitTx(0x8,0x1,0x9B);
+ *   tx.rdsSetStationName("STATIONX");
+ *   rds.begin(&tx);
+ *   rds.setRTMessage("PU2CLR QN8066 ARDUINO LIBRARY");
+ * }
+ * void loop() {
+ *   rds.process();
+ *   // Do other things here (no delay)
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066RdsEncoder {
+private:
+  QN8066 *tx = NULL;
+
+  uint8_t afCodes[26];           //!< Precomputed AF list (method A): number of AFs code (224 + n), AF codes and filler code (205)
+  uint8_t afSize = 0;            //!< Number of bytes used in afCodes (always even). 0 = No AF list (group 0B is used)
+  uint8_t afIndex = 0;           //!< Next AF pair to be sent in block 3 of the group 0A
+
+  uint8_t textAB = 0;            //!< Current Text A/B flag of the Radio Text (group 2)
+  char rtBuffer[64];             //!< Current Radio Text, terminated by '\r' and completed with spaces (not null terminated)
+  uint8_t rtLength = 0;          //!< Number of characters of the current Radio Text (without '\r')
+  uint8_t rtSegments = 0;        //!< Number of segments (groups) of the current Radio Text
+  uint8_t rtFirstSegment = 0;    //!< First segment to be sent by sendRTMessage (segments before it did not change)
+  uint8_t rtVersion = 0;         //!< 0 = 2A (64 characters); 1 = 2B (32 characters)
+  uint8_t rtSegment = 0;         //!< Next RT segment sent by process
+
+  bool rtPlusEnabled = false;    //!< If true, the RT+ groups (3A and 11A) are sent with the Radio Text
+  bool rtPlusRunning = true;     //!< RT+ item running bit
+  uint16_t rtPlusBlock3 = 0;     //!< Precomputed block 3 of the RT+ tag group (content type 1, start 1, length 1)
+  uint16_t rtPlusBlock4 = 0;     //!< Precomputed block 4 of the RT+ tag group (content type 2, start 2, length 2)
+  uint8_t rtPlusType1 = 0;       //!< RT+ content type 1 (it is split between block 2 and block 3)
+
+  qn8066_time_source timeSource = NULL;  //!< Clock Time service time source (NULL = service disabled)
+  uint8_t ctLastMinute = 0xFF;   //!< Last minute read from the time source (0xFF = not read yet)
+  uint32_t ctNextPoll = 0;       //!< millis() when the time source will be read again
+
+  const qn8066_schedule_entry *schedule = NULL;  //!< Programme schedule (PROGMEM) sorted by start time
+  qn8066_schedule_reader scheduleReader = NULL;  //!< Reads the schedule entries (NULL = schedule in PROGMEM)
+  uint8_t scheduleSize = 0;
+  int16_t scheduleIndex = -1;    //!< Entry on air (-1 = none)
+
+  uint16_t psCache[4];           //!< Block 4 of the four PS segments on air (static PS or current Dynamic PS frame)
+  uint8_t psSegment = 0;         //!< Next PS segment sent by process
+  char dpsBuffer[QN8066_DPS_MAX];  //!< Dynamic PS message (not null terminated)
+  uint8_t dpsLength = 0;         //!< Length of the Dynamic PS message (0 = Dynamic PS disabled)
+  uint8_t dpsMode = RDS_DPS_PAGING;
+  uint8_t dpsStart = 0;          //!< First character of the current Dynamic PS frame
+  uint8_t dpsSize = 0;           //!< Number of characters of the current Dynamic PS frame
+  bool dpsStatic = false;        //!< true = the static PS is on air between two Dynamic PS message cycles
+  uint16_t dpsDwell = 3000;      //!< Time (ms) each Dynamic PS frame stays on air
+  uint16_t dpsStaticTime = 0;    //!< Time (ms) the static PS stays on air between two message cycles (0 = never)
+  uint32_t dpsFrameTime = 0;     //!< millis() when the current frame went on air
+
+  RDS_GROUP queue[QN8066_RDS_QUEUE_SIZE];  //!< Groups sent by process before the scheduled ones
+  uint8_t queueHead = 0;
+  uint8_t queueCount = 0;
+  uint8_t slot = 0;              //!< Current slot of the schedule
+  uint8_t lowRateIndex = 0;      //!< Next low rate group source checked by process
+  int8_t txUpdState = -1;        //!< RDS_TXUPD value when the last group was loaded by process (-1 = not started)
+  uint32_t loadTime = 0;         //!< micros() when process loaded the last group
+  RDS_GROUP lastGroup = {};      //!< Last group loaded by process
+  uint8_t taBurst = 8;           //!< Number of 0A/0B groups sent before any other group after a TA change
+  uint8_t taBurstLeft = 0;       //!< 0A/0B groups of the current TA burst still to be sent
+  uint8_t taMeasure = 0;         //!< TA latency measurement: 1 = waiting for the first 0A/0B; 2 = waiting for its fetch
+  uint32_t taRequest = 0;        //!< micros() when the TA was changed by setTrafficAnnouncement
+  uint32_t taLatency = 0;        //!< Time (us) from the TA change to the fetch of the first group with the new flag
+
+  uint8_t ecc = 0;               //!< Extended Country Code sent in the group 1A (0 = not sent)
+  uint16_t language = 0;         //!< Language code sent in the group 1A, variant 3 (0 = not sent)
+  uint16_t pin = 0;              //!< Programme Item Number (block 4 of the group 1A)
+  uint8_t variant1A = 0;         //!< Next variant of the group 1A (0 = ECC; 3 = Language)
+  char ptyn[8];                  //!< Programme Type Name (not null terminated)
+  bool ptynEnabled = false;      //!< true = the group 10A is sent by process
+  uint8_t ptynAB = 0;            //!< PTYN A/B flag (toggled when the name changes)
+  uint8_t ptynSegment = 0;       //!< Next PTYN segment (0 or 1)
+
+  qn8066_oda oda[QN8066_ODA_MAX] = {};  //!< Open Data Applications registry (fixed size, no heap)
+  uint8_t odaIndex = 0;          //!< Next ODA entry checked by process (round robin)
+
+  char nextChar(const char **text);
+  bool clockDue(qn8066_date_time *dt);
+  void scheduleRead(uint8_t index, qn8066_schedule_entry *entry);
+  int16_t scheduleFind(uint8_t weekday, uint16_t minute);
+  void buildPSGroup(uint8_t segment, uint16_t blockD, RDS_GROUP *group);
+  void buildRTGroup(uint8_t segment, RDS_GROUP *group);
+  void buildRTPlusTags(RDS_GROUP *group);
+  void build1AGroup(RDS_GROUP *group);
+  void buildPTYNGroup(uint8_t segment, RDS_GROUP *group);
+  void nextPSFrame();
+  uint8_t dpsFrameSize(uint8_t start);
+  bool nextLowRateGroup(RDS_GROUP *group);
+  bool nextODAGroup(RDS_GROUP *group);
+  void nextGroup(RDS_GROUP *group);
+  void nextPSGroup(RDS_GROUP *group);
+
+public:
+  void begin(QN8066 *tx);
+  bool process();
+
+  uint8_t setAF(uint16_t *frequencies, uint8_t count);
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Removes the Alternative Frequencies list
+   * @details After calling this function, the PS is sent in the group 0B again.
+   * @see setAF
+   */
+  inline void clearAF() {this->afSize = 0; this->afIndex = 0;};
+
+  void setRTMessage(const char *rt, uint8_t version = 0);
+  void sendPS();
+  void sendRTMessage();
+
+  void setRTPlusTags(uint8_t contentType1, uint8_t start1, uint8_t length1, uint8_t contentType2 = 0, uint8_t start2 = 0, uint8_t length2 = 0);
+  void sendRTPlusAnnouncement();
+  void sendRTPlusTags();
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Enables or disables RadioText Plus (RT+)
+   * @details When enabled, the ODA announcement (3A) and the RT+ tags (11A) are sent with the Radio Text.
+   * @param value - true = enabled; false = disabled (default)
+   * @see setRTPlusTags, setRTPlusRunning
+   */
+  inline void setRTPlus(bool value) {this->rtPlusEnabled = value;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the RT+ item running bit
+   * @details Set it to false when no item (song) is being played. For example, during the news or commercials.
+   * @param value - true = item running (default); false = no item running
+   * @see setRTPlus, setRTPlusTags
+   */
+  inline void setRTPlusRunning(bool value) {this->rtPlusRunning = value;};
+  inline bool getRTPlus() {return this->rtPlusEnabled;};   //!< true if RT+ is enabled
+
+  bool queueGroup(uint16_t blockB, uint16_t blockC, uint16_t blockD);
+  void setTrafficAnnouncement(bool on);
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the number of 0A/0B groups sent back to back after a TA change
+   * @param groups - burst size (default 8 - two PS cycles, about 0.7s). 0 = no burst.
+   * @see setTrafficAnnouncement
+   */
+  inline void setTABurst(uint8_t groups) {this->taBurst = groups;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Gets the latency of the last TA change
+   * @details Time from setTrafficAnnouncement to the moment process saw the QN8066 fetch the first group with the
+   * @details new TA flag (the resolution depends on how often process is called).
+   * @return microseconds (0 = not measured yet)
+   * @see setTrafficAnnouncement
+   */
+  inline uint32_t getTALatency() {return this->taLatency;};
+
+  void setDynamicPS(const char *text, uint8_t mode = RDS_DPS_PAGING, uint16_t dwell = 3000);
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets how long the static PS (station name) stays on air between two Dynamic PS message cycles
+   * @param ms - time in milliseconds (0 = the static PS is not shown while the Dynamic PS is active)
+   * @see setDynamicPS, process
+   */
+  inline void setDynamicPSStaticTime(uint16_t ms) {this->dpsStaticTime = ms;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Stops the Dynamic PS. process sends the static PS (station name) again.
+   * @see setDynamicPS
+   */
+  inline void clearDynamicPS() {this->dpsLength = 0; this->dpsStatic = false;};
+
+  bool updateClock();
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the time source of the Clock Time (CT) service
+   * @details The time source is read by process (or updateClock), that sends the group 4A at each minute rollover.
+   * @param source - function that provides the UTC date and time (NULL disables the service)
+   * @see qn8066_time_source, updateClock
+   */
+  inline void setTimeSource(qn8066_time_source source) {this->timeSource = source; this->ctLastMinute = 0xFF; this->ctNextPoll = 0;};
+
+  void setSchedule(const qn8066_schedule_entry *schedule, uint8_t size, qn8066_schedule_reader reader = NULL);
+  bool scheduleUpdate(const qn8066_date_time *dt);
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Gets the programme schedule entry on air
+   * @return index of the entry (-1 = none)
+   * @see setSchedule
+   */
+  inline int16_t getScheduleIndex() {return this->scheduleIndex;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the Extended Country Code (ECC) sent in the group 1A (variant 0)
+   * @details The PI country code is shared by several countries. Without ECC, some receivers show the wrong country.
+   * @details When ECC, language or PIN are set, process sends the group 1A at low rate (about once per 4 seconds).
+   * @param ecc - ECC (Example: 0xE0 = Germany, 0xA2 = Brazil - with PI country code 0xB). 0 = 1A not sent.
+   * @see setLanguage, setPIN, sendGroup1A
+   */
+  inline void setECC(uint8_t ecc) {this->ecc = ecc;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the language code sent in the group 1A (variant 3)
+   * @param language - language code (12 bits. Example: 0x08 = German, 0x09 = English, 0x0A = Spanish). 0 = not sent.
+   * @see setECC, sendGroup1A
+   */
+  inline void setLanguage(uint16_t language) {this->language = language & 0x0FFF;};
+
+  /**
+   * @ingroup group05 TX RDS
+   * @brief Sets the Programme Item Number (PIN) sent in block 4 of the group 1A
+   * @details PIN is the scheduled start of the current programme. day = 0 means no PIN.
+   * @param day - day of month (1-31)
+   * @param hour - hour (0-23)
+   * @param minute - minute (0-59)
+   * @see setECC, sendGroup1A
+   */
+  inline void setPIN(uint8_t day, uint8_t hour, uint8_t minute) {this->pin = ((uint16_t) (day & 0B11111) << 11) | ((uint16_t) (hour & 0B11111) << 6) | (minute & 0B111111);};
+
+  void setPTYN(const char *ptyn);
+  void sendGroup1A();
+  void sendPTYN();
+
+  int8_t registerODA(uint16_t aid, uint8_t groupType, uint8_t version, qn8066_oda_callback callback, uint16_t message = 0, uint16_t dataInterval = 20, uint16_t announceInterval = 100);
+  bool unregisterODA(uint16_t aid);
+};
+
+#endif // _QN8066_RDS_ENCODER_H
@@ -0,0 +1,137 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX signal quality monitor
+ *
+ * @details Smoothing: value = value + (sample - value) / 2^smoothing, in fixed point (SIGNAL_FRACTION fractional bits).
+ * @details The first sample after begin or reset is used as it is.
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066SignalMonitor.h>
+
+/** @defgroup group09 Signal Monitor RX signal quality monitor */
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Starts the monitor
+ * @param rx - QN8066 instance (RX mode)
+ * @param readsPerSecond - I2C budget: maximum number of samples per second (0 = paused)
+ * @param smoothing - weight of a new sample is 1 / 2^smoothing (0 = no smoothing; 2 = default; 4 = slow)
+ */
+void QN8066SignalMonitor::begin(QN8066 *rx, uint8_t readsPerSecond, uint8_t smoothing) {
+  this->rx = rx;
+  this->smoothing = smoothing;
+  this->setBudget(readsPerSecond);
+  this->reset();
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Sets the I2C budget
+ * @details Each sample is one I2C transaction (8 registers).
+ * @param readsPerSecond - maximum number of samples per second (0 = paused)
+ */
+void QN8066SignalMonitor::setBudget(uint8_t readsPerSecond) {
+  this->interval = (readsPerSecond) ? 1000 / readsPerSecond : 0;
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Sets the callback and the thresholds
+ * @param callback - function called when a threshold is crossed (NULL = disabled)
+ * @param rssiThreshold - minimum change of the smoothed RSSI since the last event (dB)
+ * @param snrThreshold - minimum change of the smoothed SNR since the last event (dB)
+ * @param agcThreshold - AGC error rate (%). SIGNAL_EVENT_AGC is raised when the rate goes above or below it.
+ */
+void QN8066SignalMonitor::setCallback(qn8066_signal_event callback, uint8_t rssiThreshold, uint8_t snrThreshold, uint8_t agcThreshold) {
+  this->callback = callback;
+  this->rssiThreshold = rssiThreshold;
+  this->snrThreshold = snrThreshold;
+  this->agcThreshold = agcThreshold;
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Clears the smoothed values (call it after tuning a new frequency)
+ * @details The next sample is used as it is and raises all events.
+ */
+void QN8066SignalMonitor::reset() {
+  this->samples = 0;
+  this->rssi = this->snr = this->stereoRatio = this->agcErrorRate = 0;
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Takes a sample if the budget allows it
+ * @details Reads SNR, RSSISIG and STATUS1 in one I2C transaction. Call it in the loop.
+ * @return true if a sample was taken
+ */
+bool QN8066SignalMonitor::process() {
+  uint8_t data[8];   // SNR, RSSISIG, CID1, CID2, XTAL_DIV0, XTAL_DIV1, XTAL_DIV2 and STATUS1
+
+  if ( this->rx == NULL || this->interval == 0 ) return false;
+  if ( this->samples != 0 && millis() - this->lastSample < this->interval ) return false;
+  this->lastSample = millis();
+
+  this->rx->getRegisters(QN_SNR, data, 8);
+  this->feed(data[0], data[1], data[7]);
+  return true;
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Adds a sample and calls the callback if a threshold was crossed
+ * @param snr - SNR register
+ * @param rssi - RSSISIG register
+ * @param status1 - STATUS1 register (ST_MO_RX and RXAGCSET are used)
+ * @return events raised by this sample
+ */
+uint8_t QN8066SignalMonitor::feed(uint8_t snr, uint8_t rssi, uint8_t status1) {
+  qn8066_status1 s1;
+  uint8_t shift = (this->samples == 0) ? 0 : this->smoothing;
+  uint8_t events = 0;
+  uint8_t value;
+
+  s1.raw = status1;
+  this->rssi = smooth(this->rssi, rssi, shift);
+  this->snr = smooth(this->snr, snr, shift);
+  this->stereoRatio = smooth(this->stereoRatio, (s1.arg.ST_MO_RX) ? 0 : 100, shift);
+  this->agcErrorRate = smooth(this->agcErrorRate, (s1.arg.RXAGCSET) ? 0 : 100, shift);
+
+  value = this->getRSSI();
+  if ( this->samples == 0 || abs((int16_t) value - this->reportedRSSI) >= this->rssiThreshold ) {
+    this->reportedRSSI = value;
+    events |= SIGNAL_EVENT_RSSI;
+  }
+  value = this->getSNR();
+  if ( this->samples == 0 || abs((int16_t) value - this->reportedSNR) >= this->snrThreshold ) {
+    this->reportedSNR = value;
+    events |= SIGNAL_EVENT_SNR;
+  }
+  value = this->getStereoRatio();
+  if ( this->samples == 0 || (this->stereo && value < 25) || (!this->stereo && value > 75) ) {
+    this->stereo = value > 50;
+    events |= SIGNAL_EVENT_STEREO;
+  }
+  value = this->getAgcErrorRate();
+  if ( this->samples == 0 || (value > this->agcThreshold) != this->agcUnstable ) {
+    this->agcUnstable = value > this->agcThreshold;
+    events |= SIGNAL_EVENT_AGC;
+  }
+
+  this->samples++;
+  if ( events && this->callback != NULL ) this->callback(events);
+  return events;
+}
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Exponential smoothing in fixed point
+ * @param value - current smoothed value (SIGNAL_FRACTION fractional bits)
+ * @param sample - new sample (integer)
+ * @param shift - weight of the sample is 1 / 2^shift
+ * @return new smoothed value
+ */
+int16_t QN8066SignalMonitor::smooth(int16_t value, int16_t sample, uint8_t shift) {
+  return value + (((sample << SIGNAL_FRACTION) - value) >> shift);
+}
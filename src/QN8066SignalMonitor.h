@@ -0,0 +1,105 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - RX signal quality monitor
+ *
+ * @details This file contains a signal quality monitor for the QN8066 receiver. Each sample reads SNR, RSSISIG and
+ * @details STATUS1 in one I2C transaction (registers 03h to 0Ah), and the samples are taken within an I2C budget
+ * @details (maximum number of reads per second). The monitor keeps exponentially smoothed RSSI and SNR, the ratio of
+ * @details samples in stereo and the ratio of samples with the AGC not settled (AGC error rate). A callback is called
+ * @details only when a value crosses a threshold, so the display is redrawn only on meaningful changes.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_SIGNAL_MONITOR_H // Prevent this file from being compiled more than once
+#define _QN8066_SIGNAL_MONITOR_H
+
+#include <QN8066.h>
+
+#define SIGNAL_EVENT_RSSI 1       //<! The smoothed RSSI changed by the RSSI threshold or more
+#define SIGNAL_EVENT_SNR 2        //<! The smoothed SNR changed by the SNR threshold or more
+#define SIGNAL_EVENT_STEREO 4     //<! Stereo / mono changed (see isStereo)
+#define SIGNAL_EVENT_AGC 8        //<! The AGC error rate crossed the AGC threshold (see isAgcUnstable)
+
+#define SIGNAL_FRACTION 4         //<! Fractional bits of the smoothed values
+
+/**
+ * @ingroup group09 Signal Monitor
+ * @brief Called when one or more thresholds are crossed
+ * @param events - SIGNAL_EVENT_RSSI, SIGNAL_EVENT_SNR, SIGNAL_EVENT_STEREO and/or SIGNAL_EVENT_AGC
+ */
+typedef void (*qn8066_signal_event)(uint8_t events);
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066SignalMonitor Class - RX signal quality monitor
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066SignalMonitor.h>
+ * QN8066 rx;
+ * QN8066SignalMonitor monitor;
+ * void signalChanged(uint8_t events) {
+ *   if ( events & SIGNAL_EVENT_RSSI ) showRSSI(monitor.getRSSI());
+ *   if ( events & SIGNAL_EVENT_STEREO ) showStereo(monitor.isStereo());
+ * }
+ * void setup() {
+ *   rx.setRX(1069);
+ *   monitor.begin(&rx, 5);            // Up to 5 reads per second
+ *   monitor.setCallback(signalChanged);
+ * }
+ * void loop() {
+ *   monitor.process();
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066SignalMonitor {
+private:
+  QN8066 *rx = NULL;
+  qn8066_signal_event callback = NULL;
+  uint16_t interval = 200;       //!< Time in ms between samples (0 = paused)
+  uint32_t lastSample = 0;       //!< millis() of the last sample
+  uint8_t smoothing = 2;         //!< Weight of a new sample: 1 / 2^smoothing
+  uint32_t samples = 0;
+
+  int16_t rssi = 0;              //!< Smoothed RSSI (SIGNAL_FRACTION fractional bits)
+  int16_t snr = 0;               //!< Smoothed SNR (SIGNAL_FRACTION fractional bits)
+  int16_t stereoRatio = 0;       //!< Smoothed ratio of samples in stereo (0 to 100, SIGNAL_FRACTION fractional bits)
+  int16_t agcErrorRate = 0;      //!< Smoothed ratio of samples with the AGC not settled (0 to 100, SIGNAL_FRACTION fractional bits)
+
+  uint8_t rssiThreshold = 3;     //!< Minimum RSSI change (dB) for SIGNAL_EVENT_RSSI
+  uint8_t snrThreshold = 3;      //!< Minimum SNR change (dB) for SIGNAL_EVENT_SNR
+  uint8_t agcThreshold = 20;     //!< AGC error rate (%) for SIGNAL_EVENT_AGC
+  uint8_t reportedRSSI = 0;
+  uint8_t reportedSNR = 0;
+  bool stereo = false;
+  bool agcUnstable = false;
+
+  static int16_t smooth(int16_t value, int16_t sample, uint8_t shift);
+
+public:
+  void begin(QN8066 *rx, uint8_t readsPerSecond = 5, uint8_t smoothing = 2);
+  void setBudget(uint8_t readsPerSecond);
+  void setCallback(qn8066_signal_event callback, uint8_t rssiThreshold = 3, uint8_t snrThreshold = 3, uint8_t agcThreshold = 20);
+  bool process();
+  uint8_t feed(uint8_t snr, uint8_t rssi, uint8_t status1);
+  void reset();
+
+  /**
+   * @ingroup group09 Signal Monitor
+   * @brief Smoothed RSSI (dBuV = RSSI - 49)
+   */
+  inline uint8_t getRSSI() {return (this->rssi + (1 << (SIGNAL_FRACTION - 1))) >> SIGNAL_FRACTION;};
+  inline uint8_t getSNR() {return (this->snr + (1 << (SIGNAL_FRACTION - 1))) >> SIGNAL_FRACTION;};         //!< Smoothed SNR in dB
+  inline uint8_t getStereoRatio() {return (this->stereoRatio + (1 << (SIGNAL_FRACTION - 1))) >> SIGNAL_FRACTION;};   //!< % of the recent samples in stereo
+  inline uint8_t getAgcErrorRate() {return (this->agcErrorRate + (1 << (SIGNAL_FRACTION - 1))) >> SIGNAL_FRACTION;}; //!< % of the recent samples with the AGC not settled
+  inline bool isStereo() {return this->stereo;};             //!< Stereo with hysteresis (stereo above 75%; mono below 25%)
+  inline bool isAgcUnstable() {return this->agcUnstable;};   //!< true = AGC error rate above the AGC threshold
+  inline uint32_t getSamples() {return this->samples;};      //!< Number of samples since begin or reset
+};
+
+#endif // _QN8066_SIGNAL_MONITOR_H
@@ -0,0 +1,339 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - Station memory
+ *
+ * @details Station database with wear leveling. See QN8066StationMemory.h for the record format.
+ * @details Each station owns a group of copies slots. The newest valid copy of a group is the one with the greatest
+ * @details sequence number (5 bits, serial number arithmetic). A group whose newest copy has frequency 0 is free.
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066StationMemory.h>
+
+#define STATION_MJD_2024 60310        // MJD of 2024-01-01 (origin of the last time seen)
+
+/** @defgroup group11 Station Memory Station database */
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Starts the station memory and loads the stations from the storage
+ * @param readStorage - function that reads the storage
+ * @param writeStorage - function that writes the storage
+ * @param address - storage address of the first record
+ * @param capacity - maximum number of stations (up to QN8066_STATION_MAX)
+ * @param copies - slots per station (1 to 8). The storage used is capacity x copies x 16 bytes (see storageSize).
+ * @return number of stations loaded
+ */
+uint8_t QN8066StationMemory::begin(qn8066_storage_read readStorage, qn8066_storage_write writeStorage, uint16_t address, uint8_t capacity, uint8_t copies) {
+  qn8066_station_info station, newestStation;
+  uint8_t seq, newestSeq = 0;
+  int8_t newest;
+
+  this->readStorage = readStorage;
+  this->writeStorage = writeStorage;
+  this->address = address;
+  this->capacity = (capacity > QN8066_STATION_MAX) ? QN8066_STATION_MAX : capacity;
+  this->copies = (copies == 0) ? 1 : ((copies > 8) ? 8 : copies);
+  this->count = 0;
+  this->writes = 0;
+  this->groupUsed = 0;
+
+  for (uint8_t group = 0; group < this->capacity; group++) {
+    newest = -1;
+    for (uint8_t slot = 0; slot < this->copies; slot++) {
+      if ( !this->readRecord(group, slot, &station, &seq) ) continue;
+      if ( newest < 0 || (uint8_t) (((seq - newestSeq) & 31) - 1) < 15 ) {
+        newest = slot;
+        newestSeq = seq;
+        newestStation = station;
+      }
+    }
+    // The next record of the group is written after the newest one
+    this->groupSeq[group] = (newest < 0) ? 0 : newestSeq;
+    this->groupSlot[group] = (newest < 0) ? this->copies - 1 : newest;
+    if ( newest < 0 || newestStation.frequency == 0 || this->find(newestStation.frequency) >= 0 ) continue;
+
+    int8_t idx = this->insert(newestStation.frequency);
+    // insert uses the first free group. The station stays in the group where it was found.
+    this->groupUsed &= ~(1UL << this->stations[idx].group);
+    newestStation.group = group;
+    this->stations[idx] = newestStation;
+    this->groupUsed |= 1UL << group;
+  }
+
+  this->buildPIIndex();
+  return this->count;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Finds a station by frequency (binary search)
+ * @param frequency - frequency (MHz x 10)
+ * @return index of the station or -1 if not found
+ */
+int8_t QN8066StationMemory::find(uint16_t frequency) {
+  int8_t low = 0, high = (int8_t) this->count - 1;
+
+  while ( low <= high ) {
+    int8_t middle = (low + high) / 2;
+    if ( this->stations[middle].frequency == frequency ) return middle;
+    if ( this->stations[middle].frequency < frequency ) low = middle + 1; else high = middle - 1;
+  }
+  return -1;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Finds a station by PI (binary search)
+ * @details Stations of the same network (same PI on other frequencies) are found with n = 1, 2...
+ * @param pi - Programme Identification
+ * @param n - 0 = first station with this PI (lowest frequency); 1 = second station...
+ * @return index of the station (see get) or -1 if not found
+ */
+int8_t QN8066StationMemory::findPI(uint16_t pi, uint8_t n) {
+  uint8_t low = 0, high = this->count;
+
+  if ( pi == 0 ) return -1;
+  while ( low < high ) {   // First entry with PI >= pi
+    uint8_t middle = (low + high) / 2;
+    if ( this->stations[this->piIndex[middle]].pi < pi ) low = middle + 1; else high = middle;
+  }
+  low += n;
+  if ( low >= this->count || this->stations[this->piIndex[low]].pi != pi ) return -1;
+  return this->piIndex[low];
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Adds or refreshes a station found by a scan
+ * @details The record is written only if the station is new, the RSSI changed by QN8066_STATION_RSSI_DELTA or more, 
+ * @details or the last time seen is older than QN8066_STATION_REFRESH hours.
+ * @param frequency - frequency (MHz x 10)
+ * @param rssi - RSSI
+ * @return true if the record was written
+ */
+bool QN8066StationMemory::update(uint16_t frequency, uint8_t rssi) {
+  qn8066_station_info *station;
+  uint16_t time = this->now();
+  int8_t idx = this->find(frequency);
+
+  if ( idx < 0 ) {
+    if ( (idx = this->insert(frequency)) < 0 ) return false;
+    this->buildPIIndex();
+  } else {
+    station = &this->stations[idx];
+    if ( abs((int16_t) rssi - station->rssi) < QN8066_STATION_RSSI_DELTA && (uint16_t) (time - station->lastSeen) < QN8066_STATION_REFRESH ) return false;
+  }
+  station = &this->stations[idx];
+  station->rssi = rssi;
+  station->lastSeen = time;
+  this->writeRecord(station->group, station);
+  return true;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Adds or refreshes the RDS information of a station
+ * @details The record is written only if the station is new, PI or PS changed, or the last time seen is older than 
+ * @details QN8066_STATION_REFRESH hours.
+ * @param frequency - frequency (MHz x 10)
+ * @param pi - Programme Identification
+ * @param ps - Programme Service name (NULL = not received yet)
+ * @return true if the record was written
+ */
+bool QN8066StationMemory::updateRDS(uint16_t frequency, uint16_t pi, const char *ps) {
+  qn8066_station_info *station;
+  uint16_t time = this->now();
+  int8_t idx = this->find(frequency);
+  bool isNew = idx < 0;
+  bool piChanged;
+
+  if ( isNew && (idx = this->insert(frequency)) < 0 ) return false;
+  station = &this->stations[idx];
+
+  piChanged = station->pi != pi;
+  if ( !isNew && !piChanged && (ps == NULL || strncmp(ps, station->ps, 8) == 0) && 
+       (uint16_t) (time - station->lastSeen) < QN8066_STATION_REFRESH ) return false;
+
+  station->pi = pi;
+  if ( ps != NULL ) {
+    strncpy(station->ps, ps, 8);
+    station->ps[8] = '\0';
+  }
+  station->lastSeen = time;
+  if ( isNew || piChanged ) this->buildPIIndex();   // insert() may have moved or replaced other stations
+  this->writeRecord(station->group, station);
+  return true;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Adds or refreshes the stations found by a band scan
+ * @param list - stations found by QN8066::scanRxBand
+ * @param size - number of stations of the list
+ * @return number of records written
+ */
+uint8_t QN8066StationMemory::updateFromScan(const qn8066_station *list, uint8_t size) {
+  uint8_t written = 0;
+
+  for (uint8_t i = 0; i < size; i++) 
+    if ( this->update(list[i].frequency, list[i].rssi) ) written++;
+  return written;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Stores the PI and PS decoded by the receiver on the current frequency
+ * @details Call it after QN8066RdsDecoder::process (or decodeQueue). Nothing is written until the PI is received, and 
+ * @details then only when PI or PS change.
+ * @param rds - RDS decoder of the receiver
+ * @return true if the record was written
+ */
+bool QN8066StationMemory::updateFromRDS(QN8066RdsDecoder *rds) {
+  char ps[9];
+
+  if ( !(rds->getStatus() & RDS_RX_PI) ) return false;
+  return this->updateRDS(rds->getFrequency(), rds->getPI(), rds->getPS(ps));
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Removes a station
+ * @param frequency - frequency (MHz x 10)
+ * @return false if the station was not found
+ */
+bool QN8066StationMemory::remove(uint16_t frequency) {
+  qn8066_station_info empty = {};
+  int8_t idx = this->find(frequency);
+
+  if ( idx < 0 ) return false;
+  this->writeRecord(this->stations[idx].group, &empty);   // Frequency 0: the group is free
+  this->groupUsed &= ~(1UL << this->stations[idx].group);
+  this->count--;
+  for (uint8_t i = idx; i < this->count; i++) this->stations[i] = this->stations[i + 1];
+  this->buildPIIndex();
+  return true;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Inserts a new station in the table (sorted by frequency)
+ * @details If the table is full, the station not seen for the longest time is replaced (its group is reused).
+ * @param frequency - frequency (MHz x 10)
+ * @return index of the new station or -1 if the capacity is 0
+ */
+int8_t QN8066StationMemory::insert(uint16_t frequency) {
+  uint8_t group, idx;
+
+  if ( this->capacity == 0 ) return -1;
+
+  if ( this->count == this->capacity ) {
+    uint8_t oldest = 0;
+    for (uint8_t i = 1; i < this->count; i++) 
+      if ( this->stations[i].lastSeen < this->stations[oldest].lastSeen ) oldest = i;
+    this->groupUsed &= ~(1UL << this->stations[oldest].group);
+    this->count--;
+    for (uint8_t i = oldest; i < this->count; i++) this->stations[i] = this->stations[i + 1];
+  }
+
+  for (group = 0; this->groupUsed & (1UL << group); group++);
+  this->groupUsed |= 1UL << group;
+
+  for (idx = this->count; idx > 0 && this->stations[idx - 1].frequency > frequency; idx--) 
+    this->stations[idx] = this->stations[idx - 1];
+  this->count++;
+
+  memset(&this->stations[idx], 0, sizeof(qn8066_station_info));
+  this->stations[idx].frequency = frequency;
+  this->stations[idx].group = group;
+  return idx;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Rebuilds the PI index (insertion sort by PI and frequency)
+ */
+void QN8066StationMemory::buildPIIndex() {
+  for (uint8_t i = 0; i < this->count; i++) {
+    uint8_t j = i;
+    for ( ; j > 0 && this->stations[this->piIndex[j - 1]].pi > this->stations[i].pi; j--) this->piIndex[j] = this->piIndex[j - 1];
+    this->piIndex[j] = i;
+  }
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Reads and checks one record
+ * @return false if the CRC is wrong (slot never written or corrupted)
+ */
+bool QN8066StationMemory::readRecord(uint8_t group, uint8_t slot, qn8066_station_info *station, uint8_t *seq) {
+  uint8_t record[QN8066_STATION_RECORD];
+  uint16_t value;
+
+  this->readStorage(this->address + ((uint16_t) group * this->copies + slot) * QN8066_STATION_RECORD, record, QN8066_STATION_RECORD);
+  if ( crc8(record, QN8066_STATION_RECORD - 1) != record[QN8066_STATION_RECORD - 1] ) return false;
+
+  value = ((uint16_t) record[0] << 8) | record[1];
+  *seq = value >> 11;
+  station->frequency = value & 0x7FF;
+  station->pi = ((uint16_t) record[2] << 8) | record[3];
+  memcpy(station->ps, &record[4], 8);
+  station->ps[8] = '\0';
+  station->rssi = record[12];
+  station->lastSeen = ((uint16_t) record[13] << 8) | record[14];
+  station->group = group;
+  return true;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Writes a station in the next slot of its group
+ */
+void QN8066StationMemory::writeRecord(uint8_t group, const qn8066_station_info *station) {
+  uint8_t record[QN8066_STATION_RECORD];
+  uint8_t slot = (this->groupSlot[group] + 1) % this->copies;
+  uint8_t seq = (this->groupSeq[group] + 1) & 31;
+  uint16_t value = ((uint16_t) seq << 11) | (station->frequency & 0x7FF);
+
+  record[0] = value >> 8;
+  record[1] = value & 0xFF;
+  record[2] = station->pi >> 8;
+  record[3] = station->pi & 0xFF;
+  memset(&record[4], 0, 8);
+  for (uint8_t i = 0; i < 8 && station->ps[i] != '\0'; i++) record[4 + i] = station->ps[i];
+  record[12] = station->rssi;
+  record[13] = station->lastSeen >> 8;
+  record[14] = station->lastSeen & 0xFF;
+  record[15] = crc8(record, QN8066_STATION_RECORD - 1);
+
+  this->writeStorage(this->address + ((uint16_t) group * this->copies + slot) * QN8066_STATION_RECORD, record, QN8066_STATION_RECORD);
+  this->groupSlot[group] = slot;
+  this->groupSeq[group] = seq;
+  this->writes++;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Current time in hours (see setTimeSource)
+ */
+uint16_t QN8066StationMemory::now() {
+  qn8066_date_time dt;
+
+  if ( this->timeSource != NULL && this->timeSource(&dt) ) 
+    return (QN8066::calculateMJD(dt.year, dt.month, dt.day) - STATION_MJD_2024) * 24 + dt.hour;
+  return millis() / 3600000UL;
+}
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief CRC-8 (x^8 + x^2 + x + 1; initial value 0xFF). An erased (0xFF) or zeroed slot is never valid.
+ */
+uint8_t QN8066StationMemory::crc8(const uint8_t *data, uint8_t size) {
+  uint8_t crc = 0xFF;
+
+  while ( size-- ) {
+    crc ^= *data++;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
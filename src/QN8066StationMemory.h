@@ -0,0 +1,146 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - Station memory
+ *
+ * @details This file contains a small station database for the QN8066 receiver. Each station (frequency, PI, PS, RSSI
+ * @details and last time seen) is stored in a 16 bytes record with a CRC-8. The records are kept in a table sorted by
+ * @details frequency, with a second index sorted by PI, so both lookups are binary searches.
+ * @details The storage (EEPROM, flash emulated EEPROM, FRAM etc) is accessed through two callbacks. Each station owns a
+ * @details group of copies slots and every update is written in the next slot of its group (wear leveling). The
+ * @details previous copy is kept until the new one is written, so a power failure never loses the station.
+ * @details Only the station that changed is written (one record per update).
+ * @details
+ * @details Record format (16 bytes):
+ * | Bytes  | Content                                                      |
+ * | ------ | ------------------------------------------------------------ |
+ * | 0 - 1  | bits 15-11: sequence number; bits 10-0: frequency (0 = free)   |
+ * | 2 - 3  | PI (0 = unknown)                                             |
+ * | 4 - 11 | PS (8 characters; 0 after the end of a shorter name)          |
+ * | 12     | RSSI                                                         |
+ * | 13 - 14| Last time seen (hours. See setTimeSource)                    |
+ * | 15     | CRC-8 (x^8 + x^2 + x + 1; initial value 0xFF) of bytes 0 to 14 |
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_STATION_MEMORY_H // Prevent this file from being compiled more than once
+#define _QN8066_STATION_MEMORY_H
+
+#include <QN8066.h>
+#include <QN8066RdsDecoder.h>
+
+#define QN8066_STATION_MAX 20         //<! Maximum number of stations (RAM: about 20 bytes per station)
+#define QN8066_STATION_RECORD 16      //<! Bytes per record
+#define QN8066_STATION_RSSI_DELTA 6   //<! RSSI change that is written to the storage
+#define QN8066_STATION_REFRESH 24     //<! Hours after which the last time seen is written again
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Reads bytes from the storage (EEPROM, flash etc)
+ */
+typedef void (*qn8066_storage_read)(uint16_t address, uint8_t *data, uint8_t size);
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Writes bytes to the storage (EEPROM, flash etc)
+ */
+typedef void (*qn8066_storage_write)(uint16_t address, const uint8_t *data, uint8_t size);
+
+/**
+ * @ingroup group11 Station Memory
+ * @brief Station stored (qn8066_station_info data type)
+ */
+typedef struct {
+  uint16_t frequency;  //!< Frequency (MHz x 10)
+  uint16_t pi;         //!< Programme Identification (0 = unknown)
+  char ps[9];          //!< Programme Service name ("" = unknown)
+  uint8_t rssi;        //!< Last RSSI
+  uint16_t lastSeen;   //!< Last time seen (hours)
+  uint8_t group;       //!< Group of slots of the station in the storage
+} qn8066_station_info;
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066StationMemory Class - Station database with wear leveling
+ * @details Example (ATmega328 EEPROM)
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsDecoder.h>
+ * #include <QN8066StationMemory.h>
+ * #include <EEPROM.h>
+ * QN8066 rx;
+ * QN8066RdsDecoder rds;
+ * QN8066StationMemory memory;
+ * void eepromRead(uint16_t address, uint8_t *data, uint8_t size) {
+ *   for (uint8_t i = 0; i < size; i++) data[i] = EEPROM.read(address + i);
+ * }
+ * void eepromWrite(uint16_t address, const uint8_t *data, uint8_t size) {
+ *   for (uint8_t i = 0; i < size; i++) EEPROM.update(address + i, data[i]);
+ * }
+ * void setup() {
+ *   rx.setRX(1069);
+ *   rx.rdsRxEnable(true);
+ *   rds.begin(&rx);
+ *   memory.begin(eepromRead, eepromWrite, 16, 20, 2);   // 20 stations x 2 copies x 16 bytes from the address 16
+ * }
+ * void loop() {
+ *   if ( rds.process() ) memory.updateFromRDS(&rds);
+ * }
+ * @endcode
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066StationMemory {
+private:
+  qn8066_storage_read readStorage = NULL;
+  qn8066_storage_write writeStorage = NULL;
+  qn8066_time_source timeSource = NULL;
+  uint16_t address = 0;           //!< Storage address of the first record
+  uint8_t capacity = 0;           //!< Number of groups (maximum number of stations)
+  uint8_t copies = 2;             //!< Slots per group
+  uint8_t count = 0;              //!< Number of stations
+  uint16_t writes = 0;            //!< Records written since begin
+
+  qn8066_station_info stations[QN8066_STATION_MAX];  //!< Stations sorted by frequency
+  uint8_t piIndex[QN8066_STATION_MAX];               //!< Indexes of stations sorted by PI
+  uint8_t groupSeq[QN8066_STATION_MAX];              //!< Sequence number of the newest record of each group
+  uint8_t groupSlot[QN8066_STATION_MAX];             //!< Slot of the newest record of each group
+  uint32_t groupUsed = 0;                            //!< Groups with a station (bitmap)
+
+  static uint8_t crc8(const uint8_t *data, uint8_t size);
+  bool readRecord(uint8_t group, uint8_t slot, qn8066_station_info *station, uint8_t *seq);
+  void writeRecord(uint8_t group, const qn8066_station_info *station);
+  int8_t insert(uint16_t frequency);
+  void buildPIIndex();
+  uint16_t now();
+
+public:
+  uint8_t begin(qn8066_storage_read readStorage, qn8066_storage_write writeStorage, uint16_t address, uint8_t capacity, uint8_t copies = 2);
+  int8_t find(uint16_t frequency);
+  int8_t findPI(uint16_t pi, uint8_t n = 0);
+  bool update(uint16_t frequency, uint8_t rssi);
+  bool updateRDS(uint16_t frequency, uint16_t pi, const char *ps);
+  uint8_t updateFromScan(const qn8066_station *list, uint8_t size);
+  bool updateFromRDS(QN8066RdsDecoder *rds);
+  bool remove(uint16_t frequency);
+
+  /**
+   * @ingroup group11 Station Memory
+   * @brief Sets the clock used for the last time seen
+   * @details With a time source, the last time seen is the number of hours since 2024-01-01 00:00 UTC. 
+   * @details Without it, it is the number of hours since the board started.
+   */
+  inline void setTimeSource(qn8066_time_source timeSource) {this->timeSource = timeSource;};
+  inline uint8_t getCount() {return this->count;};                                   //!< Number of stations
+  inline const qn8066_station_info *get(uint8_t index) {return &this->stations[index];};  //!< Station by index (frequency order)
+  inline uint16_t getWrites() {return this->writes;};                                //!< Records written since begin
+  /**
+   * @ingroup group11 Station Memory
+   * @brief Storage size in bytes used by begin(..., capacity, copies)
+   */
+  static inline uint16_t storageSize(uint8_t capacity, uint8_t copies) {return (uint16_t) capacity * copies * QN8066_STATION_RECORD;};
+};
+
+#endif // _QN8066_STATION_MEMORY_H
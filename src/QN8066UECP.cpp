@@ -0,0 +1,311 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - UECP (EN 62106) RDS input server
+ *
+ * @details UECP frame format (after removing the byte stuffing):
+ * @details | STA | ADDR (2) | SQC | MFL | MSG (MFL bytes) | CRC (2) | STP |
+ * @details STA = 0xFE and STP = 0xFF. Inside the frame, the bytes 0xFD, 0xFE and 0xFF are sent as 0xFD 0x00, 0xFD 0x01 and 0xFD 0x02.
+ * @details The CRC (CCITT, initial value 0xFFFF, inverted) is computed from ADDR to the end of MSG.
+ * @details MSG has one or more messages. Each message starts with the Message Element Code (MEC).
+ * @see EN 62106 - Specification of the radio data system (RDS) for VHF/FM sound broadcasting - Annex UECP
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#include <QN8066UECP.h>
+
+/** @defgroup group06 UECP RDS input server */
+
+/**
+ * @ingroup group06 UECP
+ * @brief Starts the UECP server
+ * @param tx - QN8066 instance that will receive the RDS data
+ * @param rds - RDS encoder that sends the Radio Text and the AF list (QN8066RdsEncoder::begin must be called first)
+ * @param stream - Stream used to receive the frames and send the acknowledgements (Serial, WiFiClient etc).
+ * @details If stream is NULL, the frames must be passed through feed() and no acknowledgement is sent.
+ * @details Example
+ * @code
+ * #include <QN8066.h>
+ * #include <QN8066RdsEncoder.h>
+ * #include <QN8066UECP.h>
+ * QN8066 tx;
+ * QN8066RdsEncoder rds;
+ * QN8066UECP uecp;
+ * void setup() {
+ *   Serial.begin(9600);
+ *   tx.setup();
+ *   tx.setTX(1069); // Set the transmitter to 106.9 MHz
+ *   tx.rdsTxEnable(true);
+ *   tx.rdsInitTx(0x8,0x1,0x9B);
+ *   rds.begin(&tx);
+ *   uecp.begin(&tx, &rds, &Serial);
+ * }
+ *
+ * void loop() {
+ *   uecp.process();
+ *   rds.process();   // Sends the PS, the current Radio Text and the AF list
+ * }
+ * @endcode
+ */
+void QN8066UECP::begin(QN8066 *tx, QN8066RdsEncoder *rds, Stream *stream) {
+  this->tx = tx;
+  this->rds = rds;
+  this->stream = stream;
+  this->frameLen = 0;
+  this->inFrame = this->escape = this->overflow = false;
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Reads all bytes available in the stream
+ * @return number of valid frames processed
+ */
+uint8_t QN8066UECP::process() {
+  uint8_t count = 0;
+  if ( this->stream == NULL ) return 0;
+  while ( this->stream->available() > 0 ) {
+    if ( this->feed((uint8_t) this->stream->read()) ) count++;
+  }
+  return count;
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Processes one byte of the UECP stream
+ * @details The byte stuffing is removed here and the frame is processed when STP is received.
+ * @param value - byte received
+ * @return true if a valid frame (right CRC and address) was processed
+ */
+bool QN8066UECP::feed(uint8_t value) {
+
+  if ( value == UECP_STA ) {  // Starts a new frame (even if the previous one was not finished)
+    this->inFrame = true;
+    this->escape = this->overflow = false;
+    this->frameLen = 0;
+    return false;
+  }
+
+  if ( !this->inFrame ) return false;
+
+  if ( value == UECP_STP ) {
+    uint16_t frames = this->frameCount;
+    this->inFrame = false;
+    if ( !this->overflow && !this->escape ) this->processFrame();
+    return this->frameCount != frames;
+  }
+
+  if ( value == UECP_ESC ) {
+    this->escape = true;
+    return false;
+  }
+
+  if ( this->escape ) {
+    this->escape = false;
+    if ( value > 2 ) {       // Invalid stuffing sequence. Drops the frame.
+      this->inFrame = false;
+      return false;
+    }
+    value += UECP_ESC;
+  }
+
+  if ( this->frameLen < UECP_MAX_FRAME )
+    this->frame[this->frameLen++] = value;
+  else
+    this->overflow = true;
+
+  return false;
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Computes the UECP CRC (CCITT - x^16 + x^12 + x^5 + 1; initial value 0xFFFF; inverted result)
+ * @param data - bytes from ADDR to the end of MSG (without byte stuffing)
+ * @param len - number of bytes
+ * @return CRC
+ */
+uint16_t QN8066UECP::crc(const uint8_t *data, uint16_t len) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < len; i++) {
+    crc = (uint8_t)(crc >> 8) | (crc << 8);
+    crc ^= data[i];
+    crc ^= (uint8_t)(crc & 0xFF) >> 4;
+    crc ^= (crc << 8) << 4;
+    crc ^= ((crc & 0xFF) << 4) << 1;
+  }
+  return ~crc;
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Checks the frame and processes all its messages
+ */
+void QN8066UECP::processFrame() {
+  uint16_t address, site;
+  uint8_t encoder, sqc, mfl, used, code = UECP_ACK_OK;
+
+  if ( this->frameLen < 6 ) return;
+
+  sqc = this->frame[2];
+  mfl = this->frame[3];
+
+  if ( crc(this->frame, this->frameLen - 2) != (((uint16_t) this->frame[this->frameLen - 2] << 8) | this->frame[this->frameLen - 1]) ) {
+    this->crcErrors++;
+    this->sendAck(sqc, UECP_ACK_CRC_ERROR);
+    return;
+  }
+
+  address = ((uint16_t) this->frame[0] << 8) | this->frame[1];
+  site = address >> 6;
+  encoder = address & 0x3F;
+  if ( (site != 0 && this->siteAddress != 0 && site != this->siteAddress) ||
+       (encoder != 0 && this->encoderAddress != 0 && encoder != this->encoderAddress) )
+    return;  // Not for this encoder
+
+  this->frameCount++;
+
+  if ( mfl != this->frameLen - 6 ) {
+    this->sendAck(sqc, UECP_ACK_MFL_ERROR);
+    return;
+  }
+
+  uint8_t *msg = &this->frame[4];
+  while ( mfl > 0 && code == UECP_ACK_OK ) {
+    code = this->processMessage(msg, mfl, &used);
+    msg += used;
+    mfl -= used;
+  }
+
+  this->sendAck(sqc, code);
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Processes one message and maps it onto the QN8066 RDS functions
+ * @param msg - message (starts with the MEC)
+ * @param len - number of bytes left in the message field
+ * @param used - returns the number of bytes used by this message
+ * @return acknowledgement code (UECP_ACK_OK if the message was processed)
+ */
+uint8_t QN8066UECP::processMessage(uint8_t *msg, uint8_t len, uint8_t *used) {
+  char text[65];
+  uint8_t mel;
+  bool utf8 = this->tx->rdsGetUTF8();
+
+  *used = len;  // If something is wrong, the rest of the message field is discarded
+
+  switch ( msg[0] ) {
+    case UECP_MEC_PI:       // MEC DSN PSN PI(2)
+      if ( len < 5 ) return UECP_ACK_MEL_ERROR;
+      this->tx->rdsSetPI(((uint16_t) msg[3] << 8) | msg[4]);
+      this->changes |= UECP_CHANGED_PI;
+      *used = 5;
+      break;
+    case UECP_MEC_PS:       // MEC DSN PSN PS(8)
+      if ( len < 11 ) return UECP_ACK_MEL_ERROR;
+      memcpy(text, &msg[3], 8);
+      text[8] = '\0';
+      this->tx->rdsSetUTF8(false);       // UECP texts are already coded in the RDS character set
+      this->tx->rdsSetStationName(text);
+      this->tx->rdsSetUTF8(utf8);
+      this->changes |= UECP_CHANGED_PS;
+      *used = 11;
+      break;
+    case UECP_MEC_TA_TP:    // MEC DSN PSN (b0 = TA; b1 = TP)
+      if ( len < 4 ) return UECP_ACK_MEL_ERROR;
+      this->tx->rdsSetTP((msg[3] >> 1) & 1);
+      this->rds->setTrafficAnnouncement(msg[3] & 1);
+      this->changes |= UECP_CHANGED_TA_TP;
+      *used = 4;
+      break;
+    case UECP_MEC_PTY:      // MEC DSN PSN PTY
+      if ( len < 4 ) return UECP_ACK_MEL_ERROR;
+      if ( msg[3] > 31 ) return UECP_ACK_OUT_OF_RANGE;
+      this->tx->rdsSetPTY(msg[3]);
+      this->changes |= UECP_CHANGED_PTY;
+      *used = 4;
+      break;
+    case UECP_MEC_RT:       // MEC DSN PSN MEL [config text(MEL - 1)]
+      if ( len < 4 ) return UECP_ACK_MEL_ERROR;
+      mel = msg[3];
+      if ( mel > 65 || len < 4 + mel ) return UECP_ACK_MEL_ERROR;
+      if ( mel > 0 ) {
+        memcpy(text, &msg[5], mel - 1);
+        text[mel - 1] = '\0';
+      } else {
+        text[0] = '\0';     // MEL = 0 clears the Radio Text
+      }
+      this->tx->rdsSetUTF8(false);
+      this->rds->setRTMessage(text);
+      this->tx->rdsSetUTF8(utf8);
+      this->changes |= UECP_CHANGED_RT;
+      *used = 4 + mel;
+      break;
+    case UECP_MEC_RTC:      // MEC YY MM DD hh mm ss cs offset (b5 = sign; b4-b0 = half hours)
+      if ( len < 9 ) return UECP_ACK_MEL_ERROR;
+      if ( msg[2] < 1 || msg[2] > 12 || msg[3] < 1 || msg[3] > 31 || msg[4] > 23 || msg[5] > 59 ) return UECP_ACK_OUT_OF_RANGE;
+      this->tx->rdsSendDateTime(2000 + msg[1], msg[2], msg[3], msg[4], msg[5], (msg[8] & 0x20) ? -(int8_t)(msg[8] & 0x1F) : (int8_t)(msg[8] & 0x1F));
+      this->changes |= UECP_CHANGED_CT;
+      *used = 9;
+      break;
+    case UECP_MEC_AF: {     // MEC MEL DSN PSN AF codes (MEL - 2)
+      uint16_t freq[25];
+      uint8_t n = 0;
+      if ( len < 2 ) return UECP_ACK_MEL_ERROR;
+      mel = msg[1];
+      if ( mel < 2 || len < 2 + mel ) return UECP_ACK_MEL_ERROR;
+      for ( uint8_t i = 4; i < 2 + mel && n < 25; i++ ) {
+        if ( msg[i] == 250 ) i++;   // LF/MF indicator: the next code is an LF/MF channel, not a VHF one
+        else if ( msg[i] > 0 && msg[i] < 205 ) freq[n++] = 875 + msg[i];  // Skips number of AFs and filler codes
+      }
+      if ( n ) this->rds->setAF(freq, n); else this->rds->clearAF();
+      this->changes |= UECP_CHANGED_AF;
+      *used = 2 + mel;
+      break;
+    }
+    default:
+      this->unknownMessages++;
+      return UECP_ACK_UNKNOWN_MEC;
+  }
+  return UECP_ACK_OK;
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Writes a byte in the stream applying the byte stuffing
+ * @param value
+ */
+void QN8066UECP::writeStuffed(uint8_t value) {
+  if ( value >= UECP_ESC ) {
+    this->stream->write(UECP_ESC);
+    this->stream->write(value - UECP_ESC);
+  } else {
+    this->stream->write(value);
+  }
+}
+
+/**
+ * @ingroup group06 UECP
+ * @brief Sends the acknowledgement message (MEC 0x18)
+ * @param sqc - sequence counter of the received frame
+ * @param code - acknowledgement code
+ */
+void QN8066UECP::sendAck(uint8_t sqc, uint8_t code) {
+  uint8_t ack[8];
+  uint16_t c;
+
+  if ( this->stream == NULL || !this->ackEnabled ) return;
+
+  ack[0] = (this->siteAddress >> 2);
+  ack[1] = ((this->siteAddress & 0B11) << 6) | this->encoderAddress;
+  ack[2] = sqc;
+  ack[3] = 3;              // MFL
+  ack[4] = UECP_MEC_ACK;
+  ack[5] = code;
+  ack[6] = sqc;
+  c = crc(ack, 7);
+
+  this->stream->write(UECP_STA);
+  for (uint8_t i = 0; i < 7; i++) this->writeStuffed(ack[i]);
+  this->writeStuffed(c >> 8);
+  this->writeStuffed(c & 0xFF);
+  this->stream->write(UECP_STP);
+}
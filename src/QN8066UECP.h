@@ -0,0 +1,132 @@
+/**
+ * @brief QN8066 ARDUINO LIBRARY - UECP (EN 62106) RDS input server
+ *
+ * @details This file contains the UECP frame parser used to feed the QN8066 RDS encoder from broadcast playout and
+ * @details RDS management software. The parser works on a byte stream (any Stream: Serial, WiFiClient, etc) and does
+ * @details not use dynamic memory.
+ * @details You can see a complete documentation on  <https://github.com/pu2clr/QN8066>
+ * @see [General Documentation](https://pu2clr.github.io/QN8066/)
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ * @date  2024
+ */
+
+#ifndef _QN8066_UECP_H // Prevent this file from being compiled more than once
+#define _QN8066_UECP_H
+
+#include <QN8066.h>
+#include <QN8066RdsEncoder.h>
+
+#define UECP_STA 0xFE             //<! Frame start
+#define UECP_STP 0xFF             //<! Frame stop
+#define UECP_ESC 0xFD             //<! Byte stuffing escape (FD 00 = FD; FD 01 = FE; FD 02 = FF)
+#define UECP_MAX_FRAME 261        //<! ADDR (2) + SQC (1) + MFL (1) + MSG (up to 255) + CRC (2)
+
+/**
+ * @brief UECP Message Element Codes (MEC) supported
+ *
+ */
+#define UECP_MEC_PI 0x01          //<! Programme Identification
+#define UECP_MEC_PS 0x02          //<! Programme Service name
+#define UECP_MEC_TA_TP 0x03       //<! Traffic Announcement and Traffic Programme
+#define UECP_MEC_PTY 0x07         //<! Programme Type
+#define UECP_MEC_RT 0x0A          //<! Radio Text
+#define UECP_MEC_RTC 0x0D         //<! Real time clock (CT)
+#define UECP_MEC_AF 0x13          //<! Alternative Frequencies list
+#define UECP_MEC_ACK 0x18         //<! Message acknowledgement
+
+/**
+ * @brief UECP acknowledgement codes
+ *
+ */
+#define UECP_ACK_OK 0             //<! Message received and processed
+#define UECP_ACK_CRC_ERROR 1      //<! CRC error
+#define UECP_ACK_UNKNOWN_MEC 3    //<! Unknown Message Element Code
+#define UECP_ACK_OUT_OF_RANGE 6   //<! Parameter out of range
+#define UECP_ACK_MEL_ERROR 7      //<! Message element length error
+#define UECP_ACK_MFL_ERROR 8      //<! Message field length error
+
+/**
+ * @brief Flags returned by QN8066UECP::getChanges
+ *
+ */
+#define UECP_CHANGED_PI 1
+#define UECP_CHANGED_PS 2
+#define UECP_CHANGED_TA_TP 4
+#define UECP_CHANGED_PTY 8
+#define UECP_CHANGED_RT 16
+#define UECP_CHANGED_CT 32
+#define UECP_CHANGED_AF 64
+
+/**
+ * @ingroup  CLASSDEF
+ * @brief QN8066UECP Class
+ * @details Streaming UECP frame parser. Byte stuffing, CRC and acknowledgement are handled here, and the
+ * @details supported messages (PI, PS, TA/TP, PTY, RT, CT and AF) are mapped onto the QN8066 and QN8066RdsEncoder RDS functions.
+ * @details The frame buffer has a fixed size (UECP_MAX_FRAME) and there is no dynamic memory allocation.
+ * @details Since feed() just receives bytes, the parser can also be checked on a PC by feeding it captured UECP streams.
+ *
+ * @author PU2CLR - Ricardo Lima Caratti
+ */
+class QN8066UECP {
+private:
+  QN8066 *tx = NULL;
+  QN8066RdsEncoder *rds = NULL;
+  Stream *stream = NULL;
+
+  uint8_t frame[UECP_MAX_FRAME];  //!< Current frame (unstuffed, without STA and STP)
+  uint16_t frameLen = 0;
+  bool inFrame = false;
+  bool escape = false;
+  bool overflow = false;
+
+  uint16_t siteAddress = 0;       //!< 0 = accepts any site address
+  uint8_t encoderAddress = 0;     //!< 0 = accepts any encoder address
+  bool ackEnabled = true;
+
+  uint8_t changes = 0;
+  uint16_t frameCount = 0;
+  uint16_t crcErrors = 0;
+  uint16_t unknownMessages = 0;
+
+  uint8_t processMessage(uint8_t *msg, uint8_t len, uint8_t *used);
+  void processFrame();
+  void sendAck(uint8_t sqc, uint8_t code);
+  void writeStuffed(uint8_t value);
+
+public:
+  void begin(QN8066 *tx, QN8066RdsEncoder *rds, Stream *stream = NULL);
+  bool feed(uint8_t value);
+  uint8_t process();
+
+  static uint16_t crc(const uint8_t *data, uint16_t len);
+
+  /**
+   * @ingroup group06 UECP
+   * @brief Sets the address of this encoder
+   * @details Frames sent to other addresses are ignored. The address 0 (site or encoder) is always accepted.
+   * @param site - site address (10 bits)
+   * @param encoder - encoder address (6 bits)
+   */
+  inline void setAddress(uint16_t site, uint8_t encoder) {this->siteAddress = site & 0x3FF; this->encoderAddress = encoder & 0x3F;};
+
+  /**
+   * @ingroup group06 UECP
+   * @brief Enables or disables the acknowledgement message (MEC 0x18)
+   * @param value - true = enabled (default); false = disabled
+   */
+  inline void setAck(bool value) {this->ackEnabled = value;};
+
+  /**
+   * @ingroup group06 UECP
+   * @brief Gets what was changed by the UECP messages since the last call
+   * @return UECP_CHANGED_* flags (OR-ed)
+   */
+  inline uint8_t getChanges() {uint8_t c = this->changes; this->changes = 0; return c;};
+
+  inline uint16_t getFrameCount() {return this->frameCount;};
+  inline uint16_t getCrcErrors() {return this->crcErrors;};
+  inline uint16_t getUnknownMessages() {return this->unknownMessages;};
+};
+
+#endif // _QN8066_UECP_H